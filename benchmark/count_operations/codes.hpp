@@ -48,6 +48,7 @@ namespace kodo
     template<class Field>
     class full_rlnc_decoder_count :
         public // Payload API
+               payload_recoder<recoding_stack,
                payload_decoder<
                // Codec Header API
                systematic_decoder<
@@ -72,12 +73,13 @@ namespace kodo
                final_coder_factory_pool<
                // Final type
                full_rlnc_decoder_count<Field>
-                   > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > >
     { };
 
     template<class Field>
     class full_delayed_rlnc_decoder_count :
         public // Payload API
+               payload_recoder<recoding_stack,
                payload_decoder<
                // Codec Header API
                systematic_decoder<
@@ -103,7 +105,7 @@ namespace kodo
                final_coder_factory_pool<
                // Final type
                full_delayed_rlnc_decoder_count<Field>
-                   > > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > > >
     { };
 
 }
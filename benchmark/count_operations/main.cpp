@@ -15,6 +15,7 @@
 #include <gauge/csv_printer.hpp>
 
 #include "codes.hpp"
+#include "../perf_counters.hpp"
 
 std::vector<uint32_t> setup_symbols()
 {
@@ -55,6 +56,7 @@ std::vector<std::string> setup_types()
     std::vector<std::string> types;
     types.push_back("encoder");
     types.push_back("decoder");
+    types.push_back("recoder");
 
     return types;
 }
@@ -174,11 +176,19 @@ public:
     {
         m_encoder->reset_operations_counter();
         m_decoder->reset_operations_counter();
+
+        m_packets = 0;
+
+        if(m_perf_counters.is_open())
+            m_perf_counters.start();
     }
 
     /// Stops a measurement and saves the counter
     void stop()
     {
+        if(m_perf_counters.is_open())
+            m_perf_counters.stop();
+
         gauge::config_set cs = get_current_configuration();
 
         std::string type = cs.get_value<std::string>("type");
@@ -187,7 +197,7 @@ public:
         {
             m_counter = m_encoder->get_operations_counter();
         }
-        else if(type == "decoder")
+        else if(type == "decoder" || type == "recoder")
         {
             m_counter = m_decoder->get_operations_counter();
         }
@@ -216,6 +226,32 @@ public:
 
         results.set_value("invert(value)",
                           m_counter.m_invert);
+
+        // The bytes processed split into coefficient vector and
+        // payload work, also broken down per phase
+        results.set_value("coefficient bytes",
+                          m_counter.m_coefficient_bytes.total());
+
+        results.set_value("payload bytes",
+                          m_counter.m_payload_bytes.total());
+
+        for(uint32_t i = 0; i < kodo::operations_phases; ++i)
+        {
+            kodo::operations_phase phase = kodo::operations_phase(i);
+            std::string name = kodo::operations_phase_name(phase);
+
+            results.set_value(name + " coefficient bytes",
+                              m_counter.coefficient_bytes(phase));
+
+            results.set_value(name + " payload bytes",
+                              m_counter.payload_bytes(phase));
+        }
+
+        if(m_perf_counters.is_open())
+        {
+            m_perf_counters.store(
+                results, m_counter.m_payload_bytes.total(), m_packets);
+        }
     }
 
 
@@ -243,6 +279,7 @@ public:
         m_decoder = m_decoder_factory->build();
 
         m_payload_buffer.resize(m_encoder->payload_size(), 0);
+        m_recode_buffer.resize(m_decoder->payload_size(), 0);
         m_encoded_data.resize(m_encoder->block_size(), 'x');
 
         m_encoder->set_symbols(sak::storage(m_encoded_data));
@@ -256,6 +293,8 @@ public:
         // results for this configuration
         gauge::config_set cs = get_current_configuration();
 
+        std::string type = cs.get_value<std::string>("type");
+
         // We switch any systematic operations off so we code
         // symbols from the beginning
         if(kodo::is_systematic_encoder(m_encoder))
@@ -267,11 +306,18 @@ public:
             {
                 // Encode a packet into the payload buffer
                 m_encoder->encode( &m_payload_buffer[0] );
+                ++m_packets;
 
                 if(rand() % 2)
                 {
                     // Pass that packet to the decoder
                     m_decoder->decode( &m_payload_buffer[0] );
+
+                    // A relay recodes a packet for every packet it
+                    // receives, the operations are counted in the
+                    // recode phase of the decoder
+                    if(type == "recoder")
+                        m_decoder->recode( &m_recode_buffer[0] );
                 }
             }
         }
@@ -287,6 +333,9 @@ public:
         assert(symbol_size.size() > 0);
         assert(types.size() > 0);
 
+        if(options["perf_counters"].as<bool>())
+            m_perf_counters.open();
+
         for(uint32_t i = 0; i < symbols.size(); ++i)
         {
             for(uint32_t j = 0; j < symbol_size.size(); ++j)
@@ -328,9 +377,18 @@ protected:
     /// The payload buffer
     std::vector<uint8_t> m_encoded_data;
 
+    /// The buffer for the recoded payloads
+    std::vector<uint8_t> m_recode_buffer;
+
     /// The counter containing the measurement results
     kodo::operations_counter m_counter;
 
+    /// The number of packets encoded in the measurement
+    uint32_t m_packets;
+
+    /// The hardware counters, only open if requested
+    perf_counters m_perf_counters;
+
 };
 
 /// Using this macro we may specify options. For specifying options
@@ -360,6 +418,7 @@ BENCHMARK_OPTION(count_operations_options)
     std::vector<std::string> types;
     types.push_back("encoder");
     types.push_back("decoder");
+    types.push_back("recoder");
 
     auto default_types =
         gauge::po::value<std::vector<std::string> >()->default_value(
@@ -372,7 +431,7 @@ BENCHMARK_OPTION(count_operations_options)
         ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
 
     options.add_options()
-        ("type", default_types, "Set type [encoder|decoder]");
+        ("type", default_types, "Set type [encoder|decoder|recoder]");
 
     gauge::runner::instance().register_options(options);
 }
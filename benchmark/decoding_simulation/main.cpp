@@ -0,0 +1,375 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+#include <thread>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/decoding_probability_simulator.hpp>
+
+#include "../decoding_probability/codes.hpp"
+
+/// @file main.cpp Estimates the decoding probability of the codes with
+///       the decoding_probability_simulator. Unlike the
+///       decoding_probability benchmark a run consists of many trials
+///       which only eliminate coefficient vectors, spread over several
+///       threads.
+
+// Helper function to convert to string
+template<class T>
+inline std::string to_string(T t)
+{
+    std::stringstream ss;
+    ss << t;
+    return ss.str();
+}
+
+/// Runs the simulator for an encoder and decoder pair
+template<class Encoder, class Decoder>
+struct decoding_simulation_benchmark : public gauge::benchmark
+{
+public:
+
+    typedef kodo::decoding_probability_simulator<Encoder, Decoder>
+        simulator_type;
+
+    typedef typename simulator_type::result result_type;
+
+    void start()
+    { }
+
+    void stop()
+    { }
+
+    void store_run(gauge::table& results)
+    {
+        assert(m_result.m_trials > 0);
+
+        double trials = (double) m_result.m_trials;
+
+        results.set_value("trials", m_result.m_trials);
+        results.set_value("used", m_result.average_used());
+        results.set_value("transmitted", m_result.m_transmitted / trials);
+
+        for(uint32_t i = 0; i < m_result.m_rank_used.size(); ++i)
+        {
+            results.set_value("rank " + to_string(i),
+                              m_result.m_rank_used[i] / trials);
+        }
+
+        // The probability of decoding with the given number of received
+        // symbols beyond the block size
+        for(uint32_t i = m_symbols; i < m_result.m_used.size(); ++i)
+        {
+            results.set_value("overhead " + to_string(i - m_symbols),
+                              m_result.decoding_probability(i));
+        }
+    }
+
+    std::string unit_text() const
+    {
+        return "symbols";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto erasure = options["erasure"].as<std::vector<double> >();
+        auto systematic = options["systematic"].as<bool>();
+
+        m_trials = options["trials"].as<uint64_t>();
+        m_threads = options["threads"].as<uint32_t>();
+
+        assert(symbols.size() > 0);
+        assert(erasure.size() > 0);
+        assert(m_trials > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& e : erasure)
+            {
+                gauge::config_set cs;
+                cs.set_value<uint32_t>("symbols", s);
+                cs.set_value<double>("erasure", e);
+                cs.set_value<bool>("systematic", systematic);
+                add_configuration(cs);
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        m_symbols = cs.get_value<uint32_t>("symbols");
+
+        m_simulator = std::make_shared<simulator_type>(m_symbols);
+        m_simulator->set_erasure(cs.get_value<double>("erasure"));
+        m_simulator->set_systematic(cs.get_value<bool>("systematic"));
+        m_simulator->set_seed((uint32_t) time(0) + current_run());
+
+        if(m_threads > 0)
+        {
+            m_simulator->set_threads(m_threads);
+        }
+    }
+
+    /// Run the benchmark
+    void run_benchmark()
+    {
+        assert(m_simulator);
+
+        // The clock is running
+        RUN{
+            m_result = m_simulator->run(m_trials);
+        }
+    }
+
+protected:
+
+    /// The number of symbols
+    uint32_t m_symbols;
+
+    /// The number of trials per run
+    uint64_t m_trials;
+
+    /// The number of threads, zero uses one per core
+    uint32_t m_threads;
+
+    /// The simulator of the current configuration
+    std::shared_ptr<simulator_type> m_simulator;
+
+    /// The result of the last run
+    result_type m_result;
+
+};
+
+template<class Encoder, class Decoder>
+struct sparse_decoding_simulation_benchmark :
+    public decoding_simulation_benchmark<Encoder,Decoder>
+{
+public:
+
+    /// The type of the base benchmark
+    typedef decoding_simulation_benchmark<Encoder,Decoder> Super;
+
+    using Super::m_simulator;
+    using Super::m_trials;
+    using Super::m_threads;
+
+public:
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto erasure = options["erasure"].as<std::vector<double> >();
+        auto density = options["density"].as<std::vector<double> >();
+        auto systematic = options["systematic"].as<bool>();
+
+        m_trials = options["trials"].as<uint64_t>();
+        m_threads = options["threads"].as<uint32_t>();
+
+        assert(symbols.size() > 0);
+        assert(erasure.size() > 0);
+        assert(density.size() > 0);
+        assert(m_trials > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& e : erasure)
+            {
+                for(const auto& d: density)
+                {
+                    gauge::config_set cs;
+                    cs.set_value<uint32_t>("symbols", s);
+                    cs.set_value<double>("erasure", e);
+                    cs.set_value<double>("density", d);
+                    cs.set_value<bool>("systematic", systematic);
+                    Super::add_configuration(cs);
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        Super::setup();
+
+        gauge::config_set cs = Super::get_current_configuration();
+
+        double density = cs.get_value<double>("density");
+
+        m_simulator->set_encoder_setup(
+            [density](typename Encoder::pointer &encoder)
+            {
+                encoder->set_density(density);
+            });
+    }
+
+};
+
+BENCHMARK_OPTION(simulation_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(32);
+    symbols.push_back(64);
+    symbols.push_back(128);
+
+    options.add_options()
+        ("symbols", gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken(), "Set the number of symbols");
+
+    std::vector<double> erasure;
+    erasure.push_back(0.5);
+
+    options.add_options()
+        ("erasure", gauge::po::value<std::vector<double> >()->default_value(
+            erasure, "")->multitoken(), "Set the symbol erasure probability");
+
+    options.add_options()
+        ("systematic", gauge::po::value<bool>()->default_value(
+            true, ""), "Set the encoder systematic");
+
+    options.add_options()
+        ("trials", gauge::po::value<uint64_t>()->default_value(
+            10000, ""), "Set the number of trials per run");
+
+    options.add_options()
+        ("threads", gauge::po::value<uint32_t>()->default_value(
+            0, ""), "Set the number of threads, 0 uses one per core");
+
+    gauge::runner::instance().register_options(options);
+}
+
+BENCHMARK_OPTION(simulation_density_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<double> density;
+    density.push_back(0.1);
+    density.push_back(0.2);
+    density.push_back(0.3);
+    density.push_back(0.4);
+    density.push_back(0.5);
+
+    auto default_density =
+        gauge::po::value<std::vector<double> >()->default_value(
+            density, "")->multitoken();
+
+    options.add_options()
+        ("density", default_density, "Set the density of the sparse codes");
+
+    gauge::runner::instance().register_options(options);
+}
+
+typedef decoding_simulation_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_simulation;
+
+BENCHMARK_F(setup_rlnc_simulation, FullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef decoding_simulation_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_simulation8;
+
+BENCHMARK_F(setup_rlnc_simulation8, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef decoding_simulation_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_simulation16;
+
+BENCHMARK_F(setup_rlnc_simulation16, FullRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+typedef decoding_simulation_benchmark<
+   kodo::full_rlnc_encoder<fifi::binary>,
+   kodo::full_delayed_rlnc_decoder<fifi::binary> >
+   setup_delayed_rlnc_simulation;
+
+BENCHMARK_F(setup_delayed_rlnc_simulation, FullDelayedRLNC, Binary, 5)
+{
+   run_benchmark();
+}
+
+typedef decoding_simulation_benchmark<
+   kodo::full_rlnc_encoder<fifi::binary8>,
+   kodo::full_delayed_rlnc_decoder<fifi::binary8> >
+   setup_delayed_rlnc_simulation8;
+
+BENCHMARK_F(setup_delayed_rlnc_simulation8, FullDelayedRLNC, Binary8, 5)
+{
+   run_benchmark();
+}
+
+typedef decoding_simulation_benchmark<
+   kodo::full_rlnc_encoder<fifi::binary16>,
+   kodo::full_delayed_rlnc_decoder<fifi::binary16> >
+   setup_delayed_rlnc_simulation16;
+
+BENCHMARK_F(setup_delayed_rlnc_simulation16, FullDelayedRLNC, Binary16, 5)
+{
+   run_benchmark();
+}
+
+/// Sparse
+
+typedef sparse_decoding_simulation_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_sparse_rlnc_simulation;
+
+BENCHMARK_F(setup_sparse_rlnc_simulation, SparseFullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef sparse_decoding_simulation_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_sparse_rlnc_simulation8;
+
+BENCHMARK_F(setup_sparse_rlnc_simulation8, SparseFullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef sparse_decoding_simulation_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_sparse_rlnc_simulation16;
+
+BENCHMARK_F(setup_sparse_rlnc_simulation16, SparseFullRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
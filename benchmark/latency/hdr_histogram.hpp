@@ -0,0 +1,178 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+/// High dynamic range histogram of non-negative integer values.
+///
+/// Values below 2^precision are counted exactly. Larger values are
+/// grouped in buckets holding the precision most significant bits of
+/// the value, so the relative error of a recorded value is below
+/// 2^-(precision - 1) regardless of its magnitude. The buckets are
+/// allocated on demand when larger values are recorded.
+class hdr_histogram
+{
+public:
+
+    /// Constructs an empty histogram
+    /// @param precision The number of significant bits kept per value
+    hdr_histogram(uint32_t precision = 8)
+        : m_precision(precision),
+          m_total(0),
+          m_max(0)
+    {
+        assert(m_precision > 1);
+        assert(m_precision < 32);
+    }
+
+    /// Records a value
+    /// @param value The value to record
+    void record(uint64_t value)
+    {
+        uint32_t index = bucket_index(value);
+
+        if(index >= m_counts.size())
+            m_counts.resize(index + 1, 0);
+
+        ++m_counts[index];
+        ++m_total;
+        m_max = std::max(m_max, value);
+    }
+
+    /// Adds the values recorded in another histogram
+    /// @param other The histogram to add, which must use the same
+    ///        precision
+    void add(const hdr_histogram& other)
+    {
+        assert(m_precision == other.m_precision);
+
+        if(other.m_counts.size() > m_counts.size())
+            m_counts.resize(other.m_counts.size(), 0);
+
+        for(uint32_t i = 0; i < other.m_counts.size(); ++i)
+            m_counts[i] += other.m_counts[i];
+
+        m_total += other.m_total;
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    /// Removes all recorded values
+    void reset()
+    {
+        m_counts.clear();
+        m_total = 0;
+        m_max = 0;
+    }
+
+    /// @return The number of recorded values
+    uint64_t count() const
+    {
+        return m_total;
+    }
+
+    /// @return The largest recorded value
+    uint64_t max() const
+    {
+        return m_max;
+    }
+
+    /// @param percentile The percentile in the range [0, 100]
+    /// @return The largest value equivalent to the value at the given
+    ///         percentile, or zero if the histogram is empty
+    uint64_t value_at_percentile(double percentile) const
+    {
+        assert(percentile >= 0.0);
+        assert(percentile <= 100.0);
+
+        if(m_total == 0)
+            return 0;
+
+        uint64_t rank =
+            static_cast<uint64_t>((percentile / 100.0) * m_total + 0.5);
+
+        rank = std::max<uint64_t>(rank, 1);
+
+        uint64_t seen = 0;
+        for(uint32_t i = 0; i < m_counts.size(); ++i)
+        {
+            seen += m_counts[i];
+
+            if(seen >= rank)
+                return std::min(highest_equivalent_value(i), m_max);
+        }
+
+        return m_max;
+    }
+
+private:
+
+    /// @param value A value
+    /// @return The index of the bucket counting the value
+    uint32_t bucket_index(uint64_t value) const
+    {
+        uint64_t exact = uint64_t(1) << m_precision;
+
+        if(value < exact)
+            return static_cast<uint32_t>(value);
+
+        uint32_t msb = most_significant_bit(value);
+        uint32_t shift = msb - m_precision + 1;
+
+        // The mantissa is in the range [2^(p-1), 2^p)
+        uint64_t mantissa = value >> shift;
+        uint64_t half = exact >> 1;
+
+        return static_cast<uint32_t>(
+            exact + (shift - 1) * half + (mantissa - half));
+    }
+
+    /// @param index The index of a bucket
+    /// @return The largest value counted by the bucket
+    uint64_t highest_equivalent_value(uint32_t index) const
+    {
+        uint64_t exact = uint64_t(1) << m_precision;
+
+        if(index < exact)
+            return index;
+
+        uint64_t half = exact >> 1;
+        uint32_t shift = static_cast<uint32_t>((index - exact) / half) + 1;
+        uint64_t mantissa = half + (index - exact) % half;
+
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    /// @param value A non-zero value
+    /// @return The index of the most significant bit set in the value
+    static uint32_t most_significant_bit(uint64_t value)
+    {
+        assert(value > 0);
+
+        uint32_t msb = 0;
+        while(value >>= 1)
+            ++msb;
+
+        return msb;
+    }
+
+private:
+
+    /// The number of significant bits kept per value
+    uint32_t m_precision;
+
+    /// The number of values per bucket
+    std::vector<uint64_t> m_counts;
+
+    /// The number of recorded values
+    uint64_t m_total;
+
+    /// The largest recorded value
+    uint64_t m_max;
+};
@@ -0,0 +1,503 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+#include <sstream>
+
+#include <boost/make_shared.hpp>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/rlnc/on_the_fly_codes.hpp>
+#include <kodo/rs/reed_solomon_codes.hpp>
+
+#include "../throughput/codes.hpp"
+#include "tsc_clock.hpp"
+#include "hdr_histogram.hpp"
+
+// Helper function to convert to string
+template<class T>
+inline std::string to_string(T t)
+{
+    std::stringstream ss;
+    ss << t;
+    return ss.str();
+}
+
+/// Measures the latency of every single encode() or decode() call. The
+/// latencies are recorded in histograms, one for all packets and, for
+/// decoders, one per rank of the decoder before the packet was
+/// decoded. The percentiles are reported in nanoseconds.
+template<class Encoder, class Decoder>
+struct latency_benchmark : public gauge::benchmark
+{
+public:
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    /// Invoked at the start of every run, the histograms only contain
+    /// the packets of the current run
+    void start()
+    {
+        m_latency.reset();
+
+        for(auto& histogram : m_rank_latency)
+        {
+            histogram.reset();
+        }
+    }
+
+    void stop()
+    { }
+
+    /// Stores the percentiles of a histogram
+    /// @param results The table of the run
+    /// @param histogram The histogram
+    /// @param suffix The suffix of the column names
+    void store_percentiles(gauge::table& results,
+                           const hdr_histogram& histogram,
+                           const std::string& suffix)
+    {
+        results.set_value("p50" + suffix, tsc_clock::to_nanoseconds(
+            histogram.value_at_percentile(50.0)));
+        results.set_value("p99" + suffix, tsc_clock::to_nanoseconds(
+            histogram.value_at_percentile(99.0)));
+        results.set_value("p99.9" + suffix, tsc_clock::to_nanoseconds(
+            histogram.value_at_percentile(99.9)));
+        results.set_value("max" + suffix, tsc_clock::to_nanoseconds(
+            histogram.max()));
+    }
+
+    void store_run(gauge::table& results)
+    {
+        assert(m_latency.count() > 0);
+
+        results.set_value("packets", m_latency.count());
+        store_percentiles(results, m_latency, "");
+
+        for(uint32_t i = 0; i < m_rank_latency.size(); ++i)
+        {
+            store_percentiles(results, m_rank_latency[i],
+                              " rank " + to_string(i));
+        }
+    }
+
+    std::string unit_text() const
+    {
+        return "ns";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto types = options["type"].as<std::vector<std::string> >();
+        auto systematic = options["systematic"].as<bool>();
+
+        m_generations = options["generations"].as<uint32_t>();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(types.size() > 0);
+        assert(m_generations > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& t : types)
+                {
+                    gauge::config_set cs;
+                    cs.set_value<uint32_t>("symbols", s);
+                    cs.set_value<uint32_t>("symbol_size", p);
+                    cs.set_value<std::string>("type", t);
+                    cs.set_value<bool>("systematic", systematic);
+
+                    add_configuration(cs);
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        std::string type = cs.get_value<std::string>("type");
+
+        // Make the factories fit perfectly otherwise there seems to
+        // be problems with memory access i.e. when using a factory
+        // with max symbols 1024 with a symbols 16
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_encoder = m_encoder_factory->build();
+        m_decoder = m_decoder_factory->build();
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_payload.resize(m_encoder->payload_size());
+
+        m_rank_latency.clear();
+
+        if(type == "decoder")
+        {
+            m_rank_latency.resize(symbols);
+        }
+
+        // Calibrate the clock before the measurements start
+        tsc_clock::ticks_per_nanosecond();
+    }
+
+    /// Prepares the encoder for a new generation
+    void initialize_encoder()
+    {
+        gauge::config_set cs = get_current_configuration();
+        bool systematic = cs.get_value<bool>("systematic");
+
+        m_encoder->initialize(*m_encoder_factory);
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        if(kodo::is_systematic_encoder(m_encoder))
+        {
+            if(systematic)
+            {
+                kodo::set_systematic_on(m_encoder);
+            }
+            else
+            {
+                kodo::set_systematic_off(m_encoder);
+            }
+        }
+    }
+
+    /// Run the encoder, one generation produces as many packets as there
+    /// are symbols
+    void run_encode()
+    {
+        RUN{
+
+            for(uint32_t i = 0; i < m_generations; ++i)
+            {
+                initialize_encoder();
+
+                for(uint32_t j = 0; j < m_encoder->symbols(); ++j)
+                {
+                    uint64_t begin = tsc_clock::now();
+                    m_encoder->encode(&m_payload[0]);
+                    uint64_t end = tsc_clock::now();
+
+                    m_latency.record(end - begin);
+                }
+            }
+        }
+    }
+
+    /// Run the decoder, only the decode() calls are timed
+    void run_decode()
+    {
+        RUN{
+
+            for(uint32_t i = 0; i < m_generations; ++i)
+            {
+                initialize_encoder();
+                m_decoder->initialize(*m_decoder_factory);
+
+                while(!m_decoder->is_complete())
+                {
+                    m_encoder->encode(&m_payload[0]);
+
+                    uint32_t rank = m_decoder->rank();
+
+                    uint64_t begin = tsc_clock::now();
+                    m_decoder->decode(&m_payload[0]);
+                    uint64_t end = tsc_clock::now();
+
+                    m_latency.record(end - begin);
+                    m_rank_latency[rank].record(end - begin);
+                }
+            }
+        }
+    }
+
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        std::string type = cs.get_value<std::string>("type");
+
+        if(type == "encoder")
+        {
+            run_encode();
+        }
+        else if(type == "decoder")
+        {
+            run_decode();
+        }
+        else
+        {
+            assert(0);
+        }
+    }
+
+protected:
+
+    /// The number of generations coded per run
+    uint32_t m_generations;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The encoder to use
+    encoder_ptr m_encoder;
+
+    /// The decoder to use
+    decoder_ptr m_decoder;
+
+    /// The data to encode
+    std::vector<uint8_t> m_encoded_data;
+
+    /// The payload buffer
+    std::vector<uint8_t> m_payload;
+
+    /// The latency of all packets in clock ticks
+    hdr_histogram m_latency;
+
+    /// The latency of the packets in clock ticks indexed by the rank of
+    /// the decoder before decoding the packet
+    std::vector<hdr_histogram> m_rank_latency;
+};
+
+/// Latency benchmark for the sparse encoders
+template<class Encoder, class Decoder>
+struct sparse_latency_benchmark :
+    public latency_benchmark<Encoder,Decoder>
+{
+public:
+
+    /// The type of the base benchmark
+    typedef latency_benchmark<Encoder,Decoder> Super;
+
+    /// We need access to the encoder built to adjust the density
+    using Super::m_encoder;
+
+public:
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        Super::get_options(options);
+
+        m_nonzero_symbols = options["nonzero_symbols"].as<uint32_t>();
+        assert(m_nonzero_symbols > 0);
+    }
+
+    void setup()
+    {
+        Super::setup();
+
+        m_encoder->set_nonzero_symbols(
+            std::min(m_nonzero_symbols, m_encoder->symbols()));
+    }
+
+protected:
+
+    /// The number of nonzero symbols in the coded packets
+    uint32_t m_nonzero_symbols;
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(latency_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(64);
+    symbols.push_back(128);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<std::string> types;
+    types.push_back("encoder");
+    types.push_back("decoder");
+
+    auto default_types =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            types, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("type", default_types, "Set type [encoder|decoder]");
+
+    options.add_options()
+        ("generations", gauge::po::value<uint32_t>()->default_value(100),
+         "Set the number of generations coded per run");
+
+    options.add_options()
+        ("systematic", gauge::po::value<bool>()->default_value(false),
+         "Set the encoder systematic");
+
+    options.add_options()
+        ("nonzero_symbols", gauge::po::value<uint32_t>()->default_value(4),
+         "Set the number of nonzero symbols of the sparse codes");
+
+    gauge::runner::instance().register_options(options);
+}
+
+//------------------------------------------------------------------
+// FullRLNC
+//------------------------------------------------------------------
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_latency;
+
+BENCHMARK_F(setup_rlnc_latency, FullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_latency8;
+
+BENCHMARK_F(setup_rlnc_latency8, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_latency16;
+
+BENCHMARK_F(setup_rlnc_latency16, FullRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullDelayedRLNC
+//------------------------------------------------------------------
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_delayed_rlnc_decoder<fifi::binary8> >
+    setup_delayed_rlnc_latency8;
+
+BENCHMARK_F(setup_delayed_rlnc_latency8, FullDelayedRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// BackwardFullRLNC
+//------------------------------------------------------------------
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::backward_full_rlnc_decoder<fifi::binary8> >
+    setup_backward_rlnc_latency8;
+
+BENCHMARK_F(setup_backward_rlnc_latency8, BackwardFullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// OnTheFly
+//------------------------------------------------------------------
+
+typedef latency_benchmark<
+    kodo::on_the_fly_encoder<fifi::binary8>,
+    kodo::on_the_fly_decoder<fifi::binary8> >
+    setup_on_the_fly_latency8;
+
+BENCHMARK_F(setup_on_the_fly_latency8, OnTheFly, Binary8, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// SparseFullRLNC
+//------------------------------------------------------------------
+
+typedef sparse_latency_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_sparse_rlnc_latency8;
+
+BENCHMARK_F(setup_sparse_rlnc_latency8, SparseFullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// ReedSolomon
+//------------------------------------------------------------------
+
+typedef latency_benchmark<
+    kodo::rs_encoder<fifi::binary8>,
+    kodo::rs_decoder<fifi::binary8> > setup_rs_latency8;
+
+BENCHMARK_F(setup_rs_latency8, ReedSolomon, Binary8, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
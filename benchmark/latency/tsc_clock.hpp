@@ -0,0 +1,78 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define KODO_TSC_CLOCK_X86
+#endif
+
+/// Cheap clock used to timestamp single coding operations. On x86 the
+/// time stamp counter is read directly, on other platforms the steady
+/// clock is used and one tick is one nanosecond.
+struct tsc_clock
+{
+    /// @return The current value of the clock in ticks
+    static uint64_t now()
+    {
+#ifdef KODO_TSC_CLOCK_X86
+        // The fence keeps the counter from being read before the
+        // preceding instructions have completed
+        _mm_lfence();
+        uint64_t ticks = __rdtsc();
+        _mm_lfence();
+        return ticks;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /// @return The number of ticks per nanosecond, measured against the
+    ///         steady clock the first time the function is called
+    static double ticks_per_nanosecond()
+    {
+        static const double ticks = calibrate();
+        return ticks;
+    }
+
+    /// @param ticks A duration in ticks
+    /// @return The duration in nanoseconds
+    static double to_nanoseconds(uint64_t ticks)
+    {
+        return ticks / ticks_per_nanosecond();
+    }
+
+private:
+
+    /// @return The number of ticks per nanosecond
+    static double calibrate()
+    {
+#ifdef KODO_TSC_CLOCK_X86
+        typedef std::chrono::steady_clock steady;
+
+        auto steady_begin = steady::now();
+        uint64_t tsc_begin = now();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        auto steady_end = steady::now();
+        uint64_t tsc_end = now();
+
+        double nanoseconds =
+            std::chrono::duration<double, std::nano>(
+                steady_end - steady_begin).count();
+
+        return (tsc_end - tsc_begin) / nanoseconds;
+#else
+        return 1.0;
+#endif
+    }
+};
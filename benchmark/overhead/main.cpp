@@ -18,6 +18,7 @@
 #include <kodo/has_deep_symbol_storage.hpp>
 
 #include "codes.hpp"
+#include "../perf_counters.hpp"
 
 /// A test block represents an encoder and decoder pair
 template<class Encoder, class Decoder>
@@ -34,10 +35,16 @@ struct overhead_benchmark : public gauge::benchmark
                   "The decoder should bring its own memory");
 
     void start()
-    { }
+    {
+        if(m_perf_counters.is_open())
+            m_perf_counters.start();
+    }
 
     void stop()
-    { }
+    {
+        if(m_perf_counters.is_open())
+            m_perf_counters.stop();
+    }
 
     void store_run(gauge::table& results)
     {
@@ -49,6 +56,9 @@ struct overhead_benchmark : public gauge::benchmark
 
         results.set_value("coded", m_encoder->block_size());
         results.set_value("used", m_bytes_used);
+
+        if(m_perf_counters.is_open())
+            m_perf_counters.store(results, m_bytes_used, m_packets);
     }
 
     std::string unit_text() const
@@ -64,6 +74,9 @@ struct overhead_benchmark : public gauge::benchmark
         assert(symbols.size() > 0);
         assert(symbol_size.size() > 0);
 
+        if(options["perf_counters"].as<bool>())
+            m_perf_counters.open();
+
         m_max_symbols = *std::max_element(symbols.begin(),
                                           symbols.end());
 
@@ -118,6 +131,7 @@ struct overhead_benchmark : public gauge::benchmark
         m_encoder->set_symbols(sak::storage(m_encoded_data));
 
         m_bytes_used = 0;
+        m_packets = 0;
     }
 
     /// Run the benchmark
@@ -136,6 +150,7 @@ struct overhead_benchmark : public gauge::benchmark
             {
                 m_bytes_used += m_encoder->encode(&payload[0]);
                 m_decoder->decode(&payload[0]);
+                ++m_packets;
             }
         }
     }
@@ -166,6 +181,12 @@ protected:
     /// The number of bytes used
     uint32_t m_bytes_used;
 
+    /// The number of packets used
+    uint32_t m_packets;
+
+    /// The hardware counters, only open if requested
+    perf_counters m_perf_counters;
+
 };
 
 /// Using this macro we may specify options. For specifying options
@@ -0,0 +1,667 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <typeinfo>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+/// Runs a number of independent encoders or decoders concurrently, one
+/// per thread, and measures the aggregate throughput. The coders are
+/// either built from one factory shared by all threads or from a
+/// factory per thread.
+///
+/// Every thread times its own coding operations, so restoring the
+/// payloads between the iterations is not included in the measurement.
+/// The aggregate throughput is the bytes coded by all threads divided
+/// by the wall time from the common start of the threads until the
+/// last thread stopped.
+template<class Encoder, class Decoder>
+struct parallel_throughput_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    /// The state owned by one thread
+    struct worker
+    {
+        /// The factory used by the encoder
+        std::shared_ptr<encoder_factory> m_encoder_factory;
+
+        /// The factory used by the decoder
+        std::shared_ptr<decoder_factory> m_decoder_factory;
+
+        /// The encoder of the thread
+        encoder_ptr m_encoder;
+
+        /// The decoder of the thread
+        decoder_ptr m_decoder;
+
+        /// The data encoded
+        std::vector<uint8_t> m_encoded_data;
+
+        /// The encoded payloads
+        std::vector< std::vector<uint8_t> > m_payloads;
+
+        /// Copies of the payloads consumed by the decoder
+        std::vector< std::vector<uint8_t> > m_decode_payloads;
+
+        /// The number of bytes {en|de}coded in the timed sections
+        uint64_t m_bytes;
+
+        /// The time spent in the timed sections in microseconds
+        double m_time;
+
+        /// The time at which the last timed section stopped
+        clock_type::time_point m_stop;
+    };
+
+    void init()
+    {
+        m_factor = 2;
+        gauge::time_benchmark::init();
+    }
+
+    void start()
+    {
+        for(auto& w : m_workers)
+        {
+            w.m_bytes = 0;
+            w.m_time = 0;
+        }
+
+        m_wall_time = 0;
+
+        gauge::time_benchmark::start();
+    }
+
+    void stop()
+    {
+        gauge::time_benchmark::stop();
+    }
+
+    /// @return The throughput of every thread in MB/s
+    std::vector<double> thread_throughput() const
+    {
+        std::vector<double> throughput;
+
+        for(const auto& w : m_workers)
+        {
+            throughput.push_back(w.m_time > 0 ? w.m_bytes / w.m_time : 0.0);
+        }
+
+        return throughput;
+    }
+
+    /// @return The bytes coded by all threads divided by the wall time
+    ///         in MB/s, i.e. the throughput of the machine. Summing the
+    ///         throughput of the threads would overstate it whenever
+    ///         the threads finish at different times.
+    double measurement()
+    {
+        uint64_t bytes = 0;
+        for(const auto& w : m_workers)
+            bytes += w.m_bytes;
+
+        return m_wall_time > 0 ? bytes / m_wall_time : 0.0;
+    }
+
+    void store_run(gauge::table& results)
+    {
+        gauge::config_set cs = get_current_configuration();
+        uint32_t threads = cs.get_value<uint32_t>("threads");
+
+        double aggregate = measurement();
+        auto throughput = thread_throughput();
+
+        double mean = 0;
+        for(double t : throughput)
+            mean += t;
+
+        mean /= throughput.size();
+
+        double variance = 0;
+
+        for(double t : throughput)
+            variance += (t - mean) * (t - mean);
+
+        variance /= throughput.size();
+
+        results.set_value("throughput", aggregate);
+        results.set_value("thread_throughput", mean);
+        results.set_value("thread_throughput_min",
+            *std::min_element(throughput.begin(), throughput.end()));
+        results.set_value("thread_throughput_max",
+            *std::max_element(throughput.begin(), throughput.end()));
+        results.set_value("thread_throughput_variance", variance);
+
+        // The efficiency compares the aggregate throughput with the
+        // throughput of a single thread running the same configuration
+        std::string key = reference_key();
+
+        if(threads == 1)
+            reference_throughput()[key] = aggregate;
+
+        double efficiency = std::numeric_limits<double>::quiet_NaN();
+
+        auto it = reference_throughput().find(key);
+        if(it != reference_throughput().end() && it->second > 0)
+            efficiency = aggregate / (threads * it->second);
+
+        results.set_value("efficiency", efficiency);
+
+        std::string type = cs.get_value<std::string>("type");
+
+        kodo::region_kernel kernel = type == "encoder" ?
+            m_workers[0].m_encoder_factory->selected_region_kernel() :
+            m_workers[0].m_decoder_factory->selected_region_kernel();
+
+        results.set_value("kernel",
+                          std::string(kodo::region_kernel_name(kernel)));
+    }
+
+    bool accept_measurement()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        std::string type = cs.get_value<std::string>("type");
+
+        if(type == "decoder")
+        {
+            // If we are benchmarking decoders we only accept the
+            // measurement if all decoders completed
+            for(const auto& w : m_workers)
+            {
+                if(!w.m_decoder->is_complete())
+                {
+                    // We did not generate enough payloads to decode
+                    // successfully, so we will generate more payloads
+                    // for next run
+                    m_factor++;
+
+                    return false;
+                }
+            }
+        }
+
+        return gauge::time_benchmark::accept_measurement();
+    }
+
+    std::string unit_text() const
+    {
+        return "MB/s";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto types = options["type"].as<std::vector<std::string> >();
+        auto factories = options["factory"].as<std::vector<std::string> >();
+        auto threads = options["threads"].as<std::vector<uint32_t> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(types.size() > 0);
+        assert(factories.size() > 0);
+        assert(threads.size() > 0);
+
+        // The single thread configuration must run first since the
+        // efficiency of the other configurations is computed from it
+        threads.push_back(1);
+        std::sort(threads.begin(), threads.end());
+        threads.erase(std::unique(threads.begin(), threads.end()),
+                      threads.end());
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& t : types)
+                {
+                    for(const auto& f : factories)
+                    {
+                        for(const auto& n : threads)
+                        {
+                            assert(n > 0);
+
+                            gauge::config_set cs;
+                            cs.set_value<uint32_t>("symbols", s);
+                            cs.set_value<uint32_t>("symbol_size", p);
+                            cs.set_value<std::string>("type", t);
+                            cs.set_value<std::string>("factory", f);
+                            cs.set_value<uint32_t>("threads", n);
+
+                            add_configuration(cs);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        uint32_t threads = cs.get_value<uint32_t>("threads");
+        std::string factory = cs.get_value<std::string>("factory");
+
+        assert(factory == "shared" || factory == "per_thread");
+
+        m_workers.clear();
+        m_workers.resize(threads);
+
+        for(uint32_t i = 0; i < threads; ++i)
+        {
+            worker& w = m_workers[i];
+
+            if(i == 0 || factory == "per_thread")
+            {
+                // Make the factories fit perfectly
+                w.m_encoder_factory = std::make_shared<encoder_factory>(
+                    symbols, symbol_size);
+
+                w.m_decoder_factory = std::make_shared<decoder_factory>(
+                    symbols, symbol_size);
+
+                w.m_encoder_factory->set_symbols(symbols);
+                w.m_encoder_factory->set_symbol_size(symbol_size);
+
+                w.m_decoder_factory->set_symbols(symbols);
+                w.m_decoder_factory->set_symbol_size(symbol_size);
+            }
+            else
+            {
+                w.m_encoder_factory = m_workers[0].m_encoder_factory;
+                w.m_decoder_factory = m_workers[0].m_decoder_factory;
+            }
+
+            w.m_encoder = w.m_encoder_factory->build();
+            w.m_decoder = w.m_decoder_factory->build();
+
+            // Prepare the data to be encoded
+            w.m_encoded_data.resize(w.m_encoder->block_size());
+
+            for(uint8_t &e : w.m_encoded_data)
+            {
+                e = rand() % 256;
+            }
+
+            w.m_encoder->set_symbols(sak::storage(w.m_encoded_data));
+
+            // Prepare storage to the encoded payloads
+            uint32_t payload_count = symbols * m_factor;
+
+            w.m_payloads.resize(payload_count);
+            w.m_decode_payloads.resize(payload_count);
+
+            for(uint32_t j = 0; j < payload_count; ++j)
+            {
+                w.m_payloads[j].resize(w.m_encoder->payload_size());
+                w.m_decode_payloads[j].resize(w.m_encoder->payload_size());
+            }
+
+            w.m_bytes = 0;
+            w.m_time = 0;
+        }
+
+        m_wall_time = 0;
+    }
+
+    /// Encodes all payloads of a worker
+    /// @return The number of symbols encoded
+    uint32_t encode_payloads(worker& w)
+    {
+        w.m_encoder->set_symbols(sak::storage(w.m_encoded_data));
+
+        // We switch any systematic operations off so we code
+        // symbols from the beginning
+        if(kodo::is_systematic_encoder(w.m_encoder))
+            kodo::set_systematic_off(w.m_encoder);
+
+        for(auto& payload : w.m_payloads)
+        {
+            w.m_encoder->encode(&payload[0]);
+        }
+
+        return w.m_payloads.size();
+    }
+
+    /// Decodes the payloads of a worker until the decoder completes
+    /// @return The number of symbols decoded
+    uint32_t decode_payloads(worker& w)
+    {
+        uint32_t decoded = 0;
+
+        for(auto& payload : w.m_decode_payloads)
+        {
+            w.m_decoder->decode(&payload[0]);
+            ++decoded;
+
+            if(w.m_decoder->is_complete())
+                break;
+        }
+
+        return decoded;
+    }
+
+    /// Runs the timed section of every worker on its own thread. The
+    /// threads wait for each other before starting the clock, such that
+    /// the timed sections overlap. The last thread to arrive starts the
+    /// wall clock and releases the others.
+    /// @param prepare Invoked with a worker before the clock is started
+    /// @param code Invoked with a worker while the clock is running,
+    ///        returns the number of symbols coded
+    template<class Prepare, class Code>
+    void run_workers(const Prepare& prepare, const Code& code)
+    {
+        gauge::config_set cs = get_current_configuration();
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        std::atomic<uint32_t> ready(0);
+        std::atomic<bool> go(false);
+        uint32_t threads = m_workers.size();
+
+        clock_type::time_point start;
+
+        auto thread_main = [&](worker& w)
+        {
+            prepare(w);
+
+            // Wait until all threads are ready
+            if(++ready == threads)
+            {
+                start = clock_type::now();
+                go.store(true);
+            }
+
+            while(!go.load())
+                std::this_thread::yield();
+
+            auto begin = clock_type::now();
+            uint32_t symbols = code(w);
+            auto end = clock_type::now();
+
+            w.m_bytes += uint64_t(symbols) * symbol_size;
+            w.m_time +=
+                std::chrono::duration<double, std::micro>(end - begin).count();
+            w.m_stop = end;
+        };
+
+        std::vector<std::thread> pool;
+        for(uint32_t i = 1; i < threads; ++i)
+        {
+            pool.push_back(std::thread(thread_main, std::ref(m_workers[i])));
+        }
+
+        // The benchmark thread runs the first worker
+        thread_main(m_workers[0]);
+
+        for(auto& t : pool)
+        {
+            t.join();
+        }
+
+        auto stop = start;
+        for(const auto& w : m_workers)
+            stop = std::max(stop, w.m_stop);
+
+        m_wall_time +=
+            std::chrono::duration<double, std::micro>(stop - start).count();
+    }
+
+    /// Run the encoders
+    void run_encode()
+    {
+        RUN{
+            run_workers(
+                [](worker&) {},
+                [this](worker& w)
+                {
+                    // We have to make sure the encoder is in a "clean"
+                    // state
+                    w.m_encoder->initialize(*w.m_encoder_factory);
+                    return encode_payloads(w);
+                });
+        }
+    }
+
+    /// Run the decoders
+    void run_decode()
+    {
+        // Encode some data
+        for(auto& w : m_workers)
+        {
+            encode_payloads(w);
+        }
+
+        RUN{
+            run_workers(
+                [](worker& w)
+                {
+                    // Restore the payloads consumed by the previous
+                    // iteration
+                    for(uint32_t i = 0; i < w.m_payloads.size(); ++i)
+                    {
+                        std::copy(w.m_payloads[i].begin(),
+                                  w.m_payloads[i].end(),
+                                  w.m_decode_payloads[i].begin());
+                    }
+                },
+                [this](worker& w)
+                {
+                    // We have to make sure the decoder is in a "clean"
+                    // state i.e. no symbols already decoded.
+                    w.m_decoder->initialize(*w.m_decoder_factory);
+                    return decode_payloads(w);
+                });
+        }
+    }
+
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        std::string type = cs.get_value<std::string>("type");
+
+        if(type == "encoder")
+        {
+            run_encode();
+        }
+        else if(type == "decoder")
+        {
+            run_decode();
+        }
+        else
+        {
+            assert(0);
+        }
+    }
+
+protected:
+
+    /// @return The key identifying the single thread reference of the
+    ///         current configuration
+    std::string reference_key() const
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        std::stringstream key;
+        key << typeid(*this).name() << " "
+            << cs.get_value<uint32_t>("symbols") << " "
+            << cs.get_value<uint32_t>("symbol_size") << " "
+            << cs.get_value<std::string>("type") << " "
+            << cs.get_value<std::string>("factory");
+
+        return key.str();
+    }
+
+    /// @return The latest single thread throughput of each configuration
+    static std::map<std::string, double>& reference_throughput()
+    {
+        static std::map<std::string, double> reference;
+        return reference;
+    }
+
+protected:
+
+    /// The workers, one per thread
+    std::vector<worker> m_workers;
+
+    /// The wall time of the timed sections in microseconds
+    double m_wall_time;
+
+    /// Multiplication factor for payload_count
+    uint32_t m_factor;
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(parallel_throughput_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(64);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<std::string> types;
+    types.push_back("encoder");
+    types.push_back("decoder");
+
+    auto default_types =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            types, "")->multitoken();
+
+    std::vector<std::string> factories;
+    factories.push_back("shared");
+    factories.push_back("per_thread");
+
+    auto default_factories =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            factories, "")->multitoken();
+
+    std::vector<uint32_t> threads;
+    threads.push_back(1);
+    threads.push_back(2);
+    threads.push_back(4);
+    threads.push_back(std::max(std::thread::hardware_concurrency(), 1U));
+
+    auto default_threads =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            threads, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("type", default_types, "Set type [encoder|decoder]");
+
+    options.add_options()
+        ("factory", default_factories,
+         "Set whether the threads use one factory [shared|per_thread]");
+
+    options.add_options()
+        ("threads", default_threads,
+         "Set the number of concurrent encoders or decoders");
+
+    gauge::runner::instance().register_options(options);
+}
+
+//------------------------------------------------------------------
+// FullRLNC
+//------------------------------------------------------------------
+
+typedef parallel_throughput_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_throughput;
+
+BENCHMARK_F(setup_rlnc_throughput, FullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef parallel_throughput_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_throughput8;
+
+BENCHMARK_F(setup_rlnc_throughput8, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef parallel_throughput_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_throughput16;
+
+BENCHMARK_F(setup_rlnc_throughput16, FullRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+typedef parallel_throughput_benchmark<
+    kodo::full_rlnc_encoder<fifi::prime2325>,
+    kodo::full_rlnc_decoder<fifi::prime2325> > setup_rlnc_throughput2325;
+
+BENCHMARK_F(setup_rlnc_throughput2325, FullRLNC, Prime2325, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <gauge/gauge.hpp>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// @file perf_counters.hpp Hardware performance counters for the
+///       benchmarks. On Linux the counters are read with
+///       perf_event_open, elsewhere or when the kernel refuses access
+///       (see /proc/sys/kernel/perf_event_paranoid) the counters are
+///       reported as unavailable and the benchmarks run unchanged.
+
+/// Reads the cycles, instructions, L1 data cache misses, last level
+/// cache misses and branch misses of the calling thread between
+/// start() and stop().
+class perf_counters : boost::noncopyable
+{
+public:
+
+    /// The counted events
+    enum event
+    {
+        cycles = 0,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses,
+        events
+    };
+
+public:
+
+    /// Constructor, the counters are opened with open()
+    perf_counters()
+        : m_fds(events, -1),
+          m_values(events, 0)
+    { }
+
+    /// Closes the counters
+    ~perf_counters()
+    {
+        close();
+    }
+
+    /// Opens the counters of the calling thread. Events which the
+    /// processor or the kernel does not support stay unavailable.
+    /// @return True if at least one counter could be opened
+    bool open()
+    {
+        close();
+
+#if defined(__linux__)
+        const uint32_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        m_fds[cycles] = open_event(PERF_TYPE_HARDWARE,
+                                   PERF_COUNT_HW_CPU_CYCLES);
+        m_fds[instructions] = open_event(PERF_TYPE_HARDWARE,
+                                         PERF_COUNT_HW_INSTRUCTIONS);
+        m_fds[l1d_misses] = open_event(PERF_TYPE_HW_CACHE, l1d_read_miss);
+        m_fds[llc_misses] = open_event(PERF_TYPE_HARDWARE,
+                                       PERF_COUNT_HW_CACHE_MISSES);
+        m_fds[branch_misses] = open_event(PERF_TYPE_HARDWARE,
+                                          PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+
+        return is_open();
+    }
+
+    /// @return True if at least one counter is open
+    bool is_open() const
+    {
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            if(m_fds[i] >= 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /// @param e The event
+    /// @return True if the event is counted
+    bool is_available(event e) const
+    {
+        return m_fds[e] >= 0;
+    }
+
+    /// Resets and starts the counters
+    void start()
+    {
+#if defined(__linux__)
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            if(m_fds[i] < 0)
+                continue;
+
+            ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// Stops the counters and reads their values. If the kernel
+    /// multiplexed the counters the values are scaled to the time the
+    /// counters were enabled.
+    void stop()
+    {
+#if defined(__linux__)
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            m_values[i] = 0;
+
+            if(m_fds[i] < 0)
+                continue;
+
+            ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            // The value followed by the time enabled and running
+            uint64_t data[3] = { 0, 0, 0 };
+
+            if(read(m_fds[i], data, sizeof(data)) != sizeof(data))
+                continue;
+
+            if(data[2] > 0 && data[2] < data[1])
+            {
+                data[0] = (uint64_t) (data[0] * ((double) data[1] / data[2]));
+            }
+
+            m_values[i] = data[0];
+        }
+#endif
+    }
+
+    /// @param e The event
+    /// @return The count of the last measurement
+    uint64_t value(event e) const
+    {
+        return m_values[e];
+    }
+
+    /// Stores the counters and the derived metrics of the last
+    /// measurement in the results of a run. Unavailable counters are
+    /// left out.
+    /// @param results The results of the run
+    /// @param bytes The number of bytes processed in the measurement
+    /// @param packets The number of packets processed in the measurement
+    void store(gauge::table &results, uint64_t bytes, uint64_t packets) const
+    {
+        static const char* names[events] =
+            {
+                "cycles", "instructions", "l1d_misses",
+                "llc_misses", "branch_misses"
+            };
+
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            if(m_fds[i] >= 0)
+                results.set_value(names[i], m_values[i]);
+        }
+
+        if(is_available(cycles) && is_available(instructions) &&
+           m_values[cycles] > 0)
+        {
+            results.set_value("ipc",
+                (double) m_values[instructions] / m_values[cycles]);
+        }
+
+        if(is_available(cycles) && bytes > 0)
+        {
+            results.set_value("cycles_per_byte",
+                (double) m_values[cycles] / bytes);
+        }
+
+        if(packets == 0)
+            return;
+
+        for(uint32_t i = l1d_misses; i <= branch_misses; ++i)
+        {
+            if(m_fds[i] >= 0)
+            {
+                results.set_value(std::string(names[i]) + "_per_packet",
+                    (double) m_values[i] / packets);
+            }
+        }
+    }
+
+private:
+
+    /// Closes the open counters
+    void close()
+    {
+#if defined(__linux__)
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            if(m_fds[i] >= 0)
+                ::close(m_fds[i]);
+
+            m_fds[i] = -1;
+        }
+#endif
+    }
+
+#if defined(__linux__)
+    /// Opens a disabled counter of the calling thread in user space
+    /// @param type The perf event type
+    /// @param config The event within the type
+    /// @return The file descriptor or -1 if the event is unavailable
+    int open_event(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+            PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+
+private:
+
+    /// The file descriptors of the counters, -1 if unavailable
+    std::vector<int> m_fds;
+
+    /// The values of the last measurement
+    std::vector<uint64_t> m_values;
+
+};
+
+/// Registers the option enabling the counters, the benchmarks read it
+/// in get_options()
+BENCHMARK_OPTION(perf_counters_options)
+{
+    gauge::po::options_description options;
+
+    options.add_options()
+        ("perf_counters", gauge::po::value<bool>()->default_value(
+            false, ""), "Report hardware performance counters per run");
+
+    gauge::runner::instance().register_options(options);
+}
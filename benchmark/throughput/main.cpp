@@ -17,6 +17,7 @@
 #include <kodo/rs/reed_solomon_codes.hpp>
 
 #include "codes.hpp"
+#include "../perf_counters.hpp"
 
 /// A test block represents an encoder and decoder pair
 template<class Encoder, class Decoder>
@@ -40,10 +41,16 @@ struct throughput_benchmark : public gauge::time_benchmark
         m_encoded_symbols = 0;
         m_decoded_symbols = 0;
         gauge::time_benchmark::start();
+
+        if(m_perf_counters.is_open())
+            m_perf_counters.start();
     }
 
     void stop()
     {
+        if(m_perf_counters.is_open())
+            m_perf_counters.stop();
+
         gauge::time_benchmark::stop();
     }
 
@@ -82,6 +89,27 @@ struct throughput_benchmark : public gauge::time_benchmark
     void store_run(gauge::table& results)
     {
         results.set_value("throughput", measurement());
+
+        // Report the region kernel selected by the finite field layer
+        gauge::config_set cs = get_current_configuration();
+        std::string type = cs.get_value<std::string>("type");
+
+        kodo::region_kernel kernel = type == "encoder" ?
+            m_encoder_factory->selected_region_kernel() :
+            m_decoder_factory->selected_region_kernel();
+
+        results.set_value("kernel",
+                          std::string(kodo::region_kernel_name(kernel)));
+
+        if(m_perf_counters.is_open())
+        {
+            uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+            uint64_t packets = type == "encoder" ?
+                m_encoded_symbols : m_decoded_symbols;
+
+            m_perf_counters.store(results, packets * symbol_size, packets);
+        }
     }
 
     bool accept_measurement()
@@ -122,6 +150,9 @@ struct throughput_benchmark : public gauge::time_benchmark
         assert(symbol_size.size() > 0);
         assert(types.size() > 0);
 
+        if(options["perf_counters"].as<bool>())
+            m_perf_counters.open();
+
         for(uint32_t i = 0; i < symbols.size(); ++i)
         {
             for(uint32_t j = 0; j < symbol_size.size(); ++j)
@@ -317,6 +348,9 @@ protected:
     /// The data encoded
     std::vector<uint8_t> m_encoded_data;
 
+    /// The hardware counters, only open if requested
+    perf_counters m_perf_counters;
+
     /// Temporary payload to not destroy the already encoded payloads
     /// when decoding
     std::vector<uint8_t> m_temp_payload;
@@ -343,6 +377,7 @@ public:
     /// We need access to the encoder built to adjust the number of
     /// nonzero symbols
     using Super::m_encoder;
+    using Super::m_perf_counters;
 
 public:
 
@@ -359,6 +394,9 @@ public:
         assert(types.size() > 0);
         assert(nonzero_symbols.size() > 0);
 
+        if(options["perf_counters"].as<bool>())
+            m_perf_counters.open();
+
         for(const auto& s : symbols)
         {
             for(const auto& p : symbol_size)
@@ -619,6 +657,30 @@ BENCHMARK_F(setup_sparse_rlnc_throughput16, SparseFullRLNC, Binary16, 5)
     run_benchmark();
 }
 
+/// Sparse with inactivation decoding
+
+typedef sparse_throughput_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary>,
+    kodo::inactivation_full_rlnc_decoder<fifi::binary> >
+    setup_sparse_inactivation_throughput;
+
+BENCHMARK_F(setup_sparse_inactivation_throughput,
+            SparseInactivationRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef sparse_throughput_benchmark<
+    kodo::sparse_full_rlnc_encoder<fifi::binary8>,
+    kodo::inactivation_full_rlnc_decoder<fifi::binary8> >
+    setup_sparse_inactivation_throughput8;
+
+BENCHMARK_F(setup_sparse_inactivation_throughput8,
+            SparseInactivationRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
 
 
 
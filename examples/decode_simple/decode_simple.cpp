@@ -41,9 +41,9 @@ namespace kodo
                  debug_cached_symbol_decoder<
                  cached_symbol_decoder<
                  debug_linear_block_decoder<
+                 debug_coefficient_storage<
                  forward_linear_block_decoder<
                  // Coefficient Storage API
-                 debug_coefficient_storage<
                  coefficient_storage<
                  coefficient_info<
                  // Storage API
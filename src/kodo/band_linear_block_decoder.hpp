@@ -0,0 +1,543 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Linear block decoder for band structured coding vectors.
+    ///
+    /// Each stored coded symbol is kept together with its band. The band
+    /// of a symbol with pivot p consists of a head [p, band_end) and,
+    /// for cyclic windows wrapping around the end of the block, a tail
+    /// [band_tail, k). The coefficients are zero outside the band.
+    /// Incoming symbols are only reduced by the symbols inside their
+    /// band, and all coefficient operations are limited to the band. As
+    /// with the linear_block_decoder_delayed the backward substitution is
+    /// postponed until full rank, where it is performed once starting
+    /// from the last pivot. With a band width w decoding costs roughly
+    /// O(k w) symbol operations for k symbols instead of O(k^2).
+    ///
+    /// The layer must be placed on top of a forward_linear_block_decoder
+    /// whose state it reuses.
+    template<class SuperCoder>
+    class band_linear_block_decoder : public SuperCoder
+    {
+    public:
+
+        /// The field we use
+        typedef typename SuperCoder::field_type field_type;
+
+        /// The value_type used to store the field elements
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_band_end.resize(the_factory.max_symbols(), 0);
+            m_band_tail.resize(the_factory.max_symbols(), 0);
+            m_unit_coefficients.resize(
+                the_factory.max_coefficients_size());
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            value_type *s =
+                reinterpret_cast<value_type*>(symbol_data);
+
+            value_type *c =
+                reinterpret_cast<value_type*>(coefficients);
+
+            decode_coefficients(s, c);
+        }
+
+        /// Uncoded symbols are decoded as coded symbols with a unit
+        /// coding vector, such that a coded symbol already stored at the
+        /// same pivot needs no special treatment.
+        /// @copydoc layer::decode_symbol(uint8_t*,uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+            assert(symbol_data != 0);
+
+            if(m_uncoded[symbol_index])
+                return;
+
+            std::fill(m_unit_coefficients.begin(),
+                      m_unit_coefficients.end(), 0);
+
+            value_type *c =
+                reinterpret_cast<value_type*>(&m_unit_coefficients[0]);
+
+            fifi::set_value<field_type>(c, symbol_index, 1U);
+
+            decode_coefficients(
+                reinterpret_cast<value_type*>(symbol_data), c);
+        }
+
+    protected:
+
+        // Fetch the variables needed
+        using SuperCoder::m_rank;
+        using SuperCoder::m_maximum_pivot;
+        using SuperCoder::m_last_pivot;
+        using SuperCoder::m_coded;
+        using SuperCoder::m_uncoded;
+        using SuperCoder::m_substitutions;
+
+    protected:
+
+        /// Reduces the symbol by the stored symbols in its band, and
+        /// stores it if a pivot is found. Once full rank is achieved the
+        /// final backward substitution is performed.
+        /// @param symbol_data The buffer of the encoded symbol
+        /// @param coefficients The coding coefficients used to encode the
+        ///        symbol
+        void decode_coefficients(value_type *symbol_data,
+                                 value_type *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            uint32_t band_end = 0;
+            uint32_t band_tail = 0;
+            auto pivot_index =
+                reduce_band(coefficients, &band_end, &band_tail);
+
+            SuperCoder::pop_operations_phase();
+
+            if(!pivot_index)
+                return;
+
+            // Only innovative symbols touch the symbol data, which is
+            // decoded in the storage of its pivot
+            value_type *symbol =
+                SuperCoder::move_into_pivot(symbol_data, *pivot_index);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            replay_substitutions(symbol);
+
+            SuperCoder::pop_operations_phase();
+
+            if(!fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::push_operations_phase(
+                    operations_phase::normalize);
+
+                normalize_band(symbol, coefficients,
+                               *pivot_index, band_end, band_tail);
+
+                SuperCoder::pop_operations_phase();
+            }
+
+            SuperCoder::store_coded_symbol(
+                symbol, coefficients, *pivot_index);
+
+            ++m_rank;
+
+            m_coded[*pivot_index] = true;
+            m_band_end[*pivot_index] = band_end;
+            m_band_tail[*pivot_index] = band_tail;
+
+            m_maximum_pivot = std::max(*pivot_index, m_maximum_pivot);
+
+            m_last_pivot = *pivot_index;
+
+            if(SuperCoder::is_complete())
+            {
+                final_backward_substitute();
+            }
+        }
+
+        /// Reduces the coefficients by the stored symbols until a pivot
+        /// is found. The subtracted symbols are recorded in
+        /// m_substitutions.
+        /// @param coefficients The coding coefficients
+        /// @param band_end Will contain the end of the head of the band
+        ///        of the reduced coefficients
+        /// @param band_tail Will contain the start of the tail of the
+        ///        band of the reduced coefficients
+        /// @return The pivot index if found.
+        boost::optional<uint32_t> reduce_band(value_type *coefficients,
+                                              uint32_t *band_end,
+                                              uint32_t *band_tail)
+        {
+            assert(coefficients != 0);
+            assert(band_end != 0);
+            assert(band_tail != 0);
+
+            m_substitutions.clear();
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            uint32_t begin = 0;
+            while(begin < symbols &&
+                  !fifi::get_value<field_type>(coefficients, begin))
+            {
+                ++begin;
+            }
+
+            if(begin == symbols)
+                return boost::none;
+
+            uint32_t end = symbols;
+            while(!fifi::get_value<field_type>(coefficients, end - 1))
+            {
+                --end;
+            }
+
+            uint32_t tail = symbols;
+
+            if(end == symbols)
+            {
+                split_band(coefficients, begin, &end, &tail);
+            }
+
+            for(uint32_t i = begin; i < symbols; ++i)
+            {
+                if(i == end)
+                {
+                    if(tail == symbols)
+                        break;
+
+                    // Skip the zero coefficients between the head and
+                    // the tail of the band
+                    i = tail;
+                }
+
+                value_type value =
+                    fifi::get_value<field_type>(coefficients, i);
+
+                if(!value)
+                    continue;
+
+                if(!SuperCoder::symbol_pivot(i))
+                {
+                    if(i < end)
+                    {
+                        *band_end = end;
+                        *band_tail = tail;
+                    }
+                    else
+                    {
+                        // The head is eliminated, the tail remains
+                        *band_end = symbols;
+                        *band_tail = symbols;
+                    }
+
+                    return boost::optional<uint32_t>(i);
+                }
+
+                const value_type *vector_i =
+                    SuperCoder::coefficients_value(i);
+
+                subtract_band(coefficients, vector_i, value,
+                              i, m_band_end[i]);
+
+                if(m_band_tail[i] < symbols)
+                {
+                    subtract_band(coefficients, vector_i, value,
+                                  m_band_tail[i], symbols);
+                }
+
+                m_substitutions.push_back(std::make_pair(i, value));
+
+                // A subtracted symbol within the tail stays within the
+                // tail, whereas one within the head may extend both
+                if(i < end)
+                {
+                    end = std::max(end, m_band_end[i]);
+                    tail = std::min(tail, m_band_tail[i]);
+                    merge_band(&end, &tail);
+                }
+            }
+
+            return boost::none;
+        }
+
+        /// Splits a band reaching the end of the block at the longest run
+        /// of zero coefficients, such that a window wrapping around the
+        /// end of the block is kept as a head and a tail.
+        /// @param coefficients The coding coefficients
+        /// @param begin The first nonzero coefficient
+        /// @param band_end The end of the head of the band
+        /// @param band_tail The start of the tail of the band
+        void split_band(const value_type *coefficients, uint32_t begin,
+                        uint32_t *band_end, uint32_t *band_tail) const
+        {
+            assert(band_end != 0);
+            assert(band_tail != 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            uint32_t gap_begin = symbols;
+            uint32_t gap_length = 0;
+            uint32_t run_begin = begin;
+
+            for(uint32_t i = begin; i < symbols; ++i)
+            {
+                if(fifi::get_value<field_type>(coefficients, i))
+                {
+                    if(i - run_begin > gap_length)
+                    {
+                        gap_begin = run_begin;
+                        gap_length = i - run_begin;
+                    }
+
+                    run_begin = i + 1;
+                }
+            }
+
+            if(gap_length == 0)
+                return;
+
+            *band_end = gap_begin;
+            *band_tail = gap_begin + gap_length;
+
+            merge_band(band_end, band_tail);
+        }
+
+        /// Merges the head and the tail of a band if they share a
+        /// value_type, such that the band operations never touch the
+        /// same value_type twice.
+        /// @param band_end The end of the head of the band
+        /// @param band_tail The start of the tail of the band
+        void merge_band(uint32_t *band_end, uint32_t *band_tail) const
+        {
+            assert(band_end != 0);
+            assert(band_tail != 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            if(*band_tail == symbols)
+                return;
+
+            if(fifi::elements_to_length<field_type>(*band_end) >
+               band_offset(*band_tail))
+            {
+                *band_end = symbols;
+                *band_tail = symbols;
+            }
+        }
+
+        /// Applies the substitutions recorded by reduce_band() to the
+        /// symbol data
+        /// @param symbol_data The buffer of the encoded symbol
+        void replay_substitutions(value_type *symbol_data)
+        {
+            assert(symbol_data != 0);
+
+            for(const auto& substitution : m_substitutions)
+            {
+                const value_type *symbol_i =
+                    SuperCoder::symbol_value(substitution.first);
+
+                if(fifi::is_binary<field_type>::value)
+                {
+                    SuperCoder::subtract(
+                        symbol_data, symbol_i,
+                        SuperCoder::symbol_length());
+                }
+                else
+                {
+                    SuperCoder::multiply_subtract(
+                        symbol_data, symbol_i, substitution.second,
+                        SuperCoder::symbol_length());
+                }
+            }
+        }
+
+        /// Normalizes the symbol such that the pivot coefficient is one
+        /// @param symbol_data The buffer of the encoded symbol
+        /// @param coefficients The coding coefficients
+        /// @param pivot_index The pivot of the symbol
+        /// @param band_end The end of the head of the band
+        /// @param band_tail The start of the tail of the band
+        void normalize_band(value_type *symbol_data,
+                            value_type *coefficients,
+                            uint32_t pivot_index, uint32_t band_end,
+                            uint32_t band_tail)
+        {
+            value_type coefficient =
+                fifi::get_value<field_type>(coefficients, pivot_index);
+
+            assert(coefficient > 0);
+
+            value_type inverted_coefficient =
+                SuperCoder::invert(coefficient);
+
+            uint32_t offset = band_offset(pivot_index);
+
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            SuperCoder::multiply(coefficients + offset,
+                                 inverted_coefficient,
+                                 band_length(offset, band_end));
+
+            if(band_tail < SuperCoder::symbols())
+            {
+                uint32_t tail_offset = band_offset(band_tail);
+
+                SuperCoder::multiply(
+                    coefficients + tail_offset, inverted_coefficient,
+                    band_length(tail_offset, SuperCoder::symbols()));
+            }
+
+            SuperCoder::pop_operations_region();
+
+            SuperCoder::multiply(symbol_data, inverted_coefficient,
+                                 SuperCoder::symbol_length());
+        }
+
+        /// Subtracts a multiple of the source coefficients from the
+        /// destination coefficients within the band [from, to)
+        /// @param dest The coefficients to update
+        /// @param src The coefficients to subtract
+        /// @param value The multiplier of the source coefficients
+        /// @param from The first element of the band
+        /// @param to The end of the band
+        void subtract_band(value_type *dest, const value_type *src,
+                           value_type value, uint32_t from, uint32_t to)
+        {
+            uint32_t offset = band_offset(from);
+            uint32_t length = band_length(offset, to);
+
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::subtract(dest + offset, src + offset, length);
+            }
+            else
+            {
+                SuperCoder::multiply_subtract(
+                    dest + offset, src + offset, value, length);
+            }
+
+            SuperCoder::pop_operations_region();
+        }
+
+        /// @param element The index of a field element
+        /// @return The index of the value_type containing the element
+        uint32_t band_offset(uint32_t element) const
+        {
+            return fifi::elements_to_length<field_type>(element + 1) - 1;
+        }
+
+        /// @param offset The index of the first value_type of the band
+        /// @param band_end The end of the band in field elements
+        /// @return The number of value_type elements in the band
+        uint32_t band_length(uint32_t offset, uint32_t band_end) const
+        {
+            return fifi::elements_to_length<field_type>(band_end) - offset;
+        }
+
+        /// Performs the backward substitution starting from the last
+        /// pivot. When symbol i is processed all symbols after it are
+        /// already decoded, so only the symbol data within the head and
+        /// the tail of its band has to be updated.
+        void final_backward_substitute()
+        {
+            assert(SuperCoder::is_complete());
+
+            SuperCoder::push_operations_phase(
+                operations_phase::backward_substitute);
+
+            for(uint32_t i = SuperCoder::symbols(); i-- > 0;)
+            {
+                if(m_uncoded[i])
+                    continue;
+
+                assert(m_coded[i]);
+
+                value_type *symbol_i = SuperCoder::symbol_value(i);
+                value_type *vector_i = SuperCoder::coefficients_value(i);
+
+                for(uint32_t j = i + 1; j < SuperCoder::symbols(); ++j)
+                {
+                    if(j == m_band_end[i])
+                    {
+                        if(m_band_tail[i] == SuperCoder::symbols())
+                            break;
+
+                        j = m_band_tail[i];
+                    }
+
+                    value_type value =
+                        fifi::get_value<field_type>(vector_i, j);
+
+                    if(!value)
+                        continue;
+
+                    const value_type *symbol_j =
+                        SuperCoder::symbol_value(j);
+
+                    if(fifi::is_binary<field_type>::value)
+                    {
+                        SuperCoder::subtract(
+                            symbol_i, symbol_j,
+                            SuperCoder::symbol_length());
+                    }
+                    else
+                    {
+                        SuperCoder::multiply_subtract(
+                            symbol_i, symbol_j, value,
+                            SuperCoder::symbol_length());
+                    }
+
+                    // Symbol j is decoded so only its pivot remains
+                    fifi::set_value<field_type>(vector_i, j, 0U);
+                }
+
+                m_coded[i] = false;
+                m_uncoded[i] = true;
+            }
+
+            SuperCoder::pop_operations_phase();
+        }
+
+    protected:
+
+        /// The end of the head of the band of every stored symbol
+        std::vector<uint32_t> m_band_end;
+
+        /// The start of the tail of the band of every stored symbol, or
+        /// the number of symbols if the band has no tail
+        std::vector<uint32_t> m_band_tail;
+
+        /// Buffer for the coding vectors of uncoded symbols
+        std::vector<uint8_t> m_unit_coefficients;
+
+    };
+}
@@ -0,0 +1,168 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+    /// @ingroup coefficient_generator_layers
+    /// @brief Generates band structured coefficients.
+    ///
+    /// Every coding vector has a random offset and only the coefficients
+    /// in the cyclic window offset, offset + 1, ..., offset +
+    /// band_width() - 1 (mod k) can be nonzero. The coefficient at the
+    /// offset is always one. Windows starting close to the end of the
+    /// block wrap around to its beginning, so every symbol lies in the
+    /// window with the same probability band_width() / k. Decoders such
+    /// as the band_linear_block_decoder can exploit the structure to
+    /// limit the elimination to the window.
+    template<class SuperCoder>
+    class band_uniform_generator : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The random generator used
+        typedef boost::random::mt19937 generator_type;
+
+        /// @copydoc layer::seed_type
+        typedef generator_type::result_type seed_type;
+
+        /// The default width of the band
+        static const uint32_t default_band_width = 32;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_band_width(default_band_width)
+            { }
+
+            /// Sets the width of the band used by the coders built.
+            /// Encoders and decoders must use the same width.
+            /// @param band_width The number of symbols in the window
+            void set_band_width(uint32_t band_width)
+            {
+                assert(band_width > 0);
+                m_band_width = band_width;
+            }
+
+            /// @return The width of the band
+            uint32_t band_width() const
+            {
+                return m_band_width;
+            }
+
+        private:
+
+            /// The width of the band
+            uint32_t m_band_width;
+
+        };
+
+    public:
+
+        /// Constructor
+        band_uniform_generator()
+            : m_band_width(0),
+              m_value_distribution(field_type::min_value,
+                                   field_type::max_value)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_band_width = std::min(the_factory.band_width(),
+                                    the_factory.symbols());
+
+            m_offset_distribution =
+                offset_distribution(0, the_factory.symbols() - 1);
+        }
+
+        /// @copydoc layer::generate(uint8_t*)
+        void generate(uint8_t *coefficients)
+        {
+            assert(coefficients != 0);
+
+            std::fill_n(coefficients, SuperCoder::coefficients_size(), 0);
+
+            value_type* c = reinterpret_cast<value_type*>(coefficients);
+
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t offset = m_offset_distribution(m_random_generator);
+
+            fifi::set_value<field_type>(c, offset, 1U);
+
+            for(uint32_t i = 1; i < m_band_width; ++i)
+            {
+                value_type coefficient =
+                    m_value_distribution(m_random_generator);
+
+                fifi::set_value<field_type>(
+                    c, (offset + i) % symbols, coefficient);
+            }
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            m_random_generator.seed(seed_value);
+        }
+
+        /// @return The width of the band
+        uint32_t band_width() const
+        {
+            return m_band_width;
+        }
+
+    private:
+
+        /// The width of the band
+        uint32_t m_band_width;
+
+        /// The type of the offset distribution
+        typedef boost::random::uniform_int_distribution<uint32_t>
+            offset_distribution;
+
+        /// Distribution that generates the offset of the band
+        offset_distribution m_offset_distribution;
+
+        /// The type of the value_type distribution
+        typedef boost::random::uniform_int_distribution<value_type>
+            value_type_distribution;
+
+        /// Distribution that generates random values from a finite field
+        value_type_distribution m_value_distribution;
+
+        /// The random generator
+        boost::random::mt19937 m_random_generator;
+
+    };
+}
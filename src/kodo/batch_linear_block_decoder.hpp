@@ -0,0 +1,326 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <sak/storage.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+#include "batch_tiles.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Allows several coded symbols to be decoded jointly.
+    ///
+    /// Between begin_batch() and end_batch() the calls to
+    /// decode_symbol(uint8_t*, uint8_t*) only record the symbol and a
+    /// copy of the coefficients. In end_batch() the recorded coefficients
+    /// are first eliminated against the existing pivots and each other,
+    /// while the row operations are recorded. The operations are then
+    /// replayed on the symbol data split into tiles, such that every
+    /// stored symbol is read once per batch instead of once per received
+    /// symbol. Uncoded symbols and calls outside a batch are forwarded
+    /// unchanged.
+    ///
+    /// The symbol buffers must stay valid and untouched until
+    /// end_batch() returns. The layer must be placed on top of a
+    /// forward_linear_block_decoder whose state it reuses.
+    template<class SuperCoder>
+    class batch_linear_block_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The direction policy of the linear block decoder
+        typedef typename SuperCoder::direction_policy direction_policy;
+
+    public:
+
+        /// Constructor
+        batch_linear_block_decoder()
+            : m_batching(false)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_batching = false;
+            m_batch_symbols.clear();
+            m_batch_coefficients.clear();
+            m_operations.clear();
+        }
+
+        /// Starts recording the coded symbols received
+        void begin_batch()
+        {
+            assert(!m_batching);
+            assert(m_batch_symbols.empty());
+
+            m_batching = true;
+        }
+
+        /// Decodes the coded symbols recorded since begin_batch()
+        void end_batch()
+        {
+            assert(m_batching);
+
+            if(!m_batch_symbols.empty())
+            {
+                decode_batch();
+            }
+
+            m_batching = false;
+            m_batch_symbols.clear();
+            m_batch_coefficients.clear();
+            m_operations.clear();
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            if(!m_batching)
+            {
+                SuperCoder::decode_symbol(symbol_data, coefficients);
+                return;
+            }
+
+            // The coefficients buffer is typically reused by the layers
+            // above for the next symbol so we have to keep a copy
+            const value_type *c =
+                reinterpret_cast<const value_type*>(coefficients);
+
+            m_batch_coefficients.insert(
+                m_batch_coefficients.end(), c,
+                c + SuperCoder::coefficients_length());
+
+            m_batch_symbols.push_back(
+                reinterpret_cast<value_type*>(symbol_data));
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            SuperCoder::decode_symbol(symbol_data, symbol_index);
+        }
+
+    protected:
+
+        // Fetch the variables needed
+        using SuperCoder::m_rank;
+        using SuperCoder::m_maximum_pivot;
+        using SuperCoder::m_last_pivot;
+        using SuperCoder::m_coded;
+
+    private:
+
+        /// The kinds of row operations recorded
+        enum class operation_kind
+        {
+            /// dest = dest - value * src
+            subtract,
+
+            /// dest = value * dest
+            multiply,
+
+            /// dest = src
+            copy
+        };
+
+        /// A row operation on the symbol data
+        struct operation
+        {
+            operation_kind m_kind;
+            operations_phase m_phase;
+            value_type *m_dest;
+            const value_type *m_src;
+            value_type m_value;
+        };
+
+        /// Records the operations on the symbol data handed out by the
+        /// elimination of the linear block decoder
+        class operation_recorder
+        {
+        public:
+
+            /// Constructor
+            /// @param operations The list the operations are added to
+            operation_recorder(std::vector<operation> &operations)
+                : m_operations(operations)
+            { }
+
+            /// Records dest = dest - value * src
+            void subtract(operations_phase phase, value_type *dest,
+                          const value_type *src, value_type value)
+            {
+                record(operation_kind::subtract, phase, dest, src, value);
+            }
+
+            /// Records dest = value * dest
+            void multiply(operations_phase phase, value_type *dest,
+                          value_type value)
+            {
+                record(operation_kind::multiply, phase, dest, 0, value);
+            }
+
+            /// Records dest = src
+            void copy(value_type *dest, const value_type *src)
+            {
+                record(operation_kind::copy, operations_phase::other,
+                       dest, src, 0);
+            }
+
+        private:
+
+            /// Records a row operation on the symbol data
+            void record(operation_kind kind, operations_phase phase,
+                        value_type *dest, const value_type *src,
+                        value_type value)
+            {
+                operation op = { kind, phase, dest, src, value };
+                m_operations.push_back(op);
+            }
+
+        private:
+
+            /// The recorded operations
+            std::vector<operation> &m_operations;
+        };
+
+    private:
+
+        /// Eliminates the recorded coefficients and applies the row
+        /// operations to the symbol data
+        void decode_batch()
+        {
+            m_operations.clear();
+
+            uint32_t coefficients_length = SuperCoder::coefficients_length();
+            uint32_t batch = static_cast<uint32_t>(m_batch_symbols.size());
+
+            for(uint32_t j = 0; j < batch; ++j)
+            {
+                eliminate(m_batch_symbols[j],
+                          &m_batch_coefficients[j * coefficients_length]);
+            }
+
+            for_each_batch_tile<field_type>(SuperCoder::symbol_length(),
+                [this](uint32_t offset, uint32_t length)
+                {
+                    replay_tile(offset, length);
+                });
+        }
+
+        /// Eliminates the coefficients of a received symbol against the
+        /// pivots, including those found earlier in the batch. The
+        /// elimination of the linear block decoder only updates the
+        /// coefficients, the operations on the symbol data are recorded.
+        /// @param symbol_data The buffer of the received symbol
+        /// @param coefficients The coefficients of the received symbol
+        void eliminate(value_type *symbol_data, value_type *coefficients)
+        {
+            operation_recorder recorder(m_operations);
+
+            auto pivot = SuperCoder::eliminate_coefficients(
+                symbol_data, coefficients, recorder);
+
+            // A non-innovative symbol costs no work on its data
+            if(!pivot)
+                return;
+
+            uint32_t pivot_index = *pivot;
+
+            // From here on the symbol is referenced through its pivot
+            SuperCoder::set_coefficients(
+                pivot_index,
+                sak::storage(coefficients, SuperCoder::coefficients_size()));
+
+            recorder.copy(SuperCoder::symbol_value(pivot_index), symbol_data);
+
+            SuperCoder::invalidate_column_index();
+
+            ++m_rank;
+
+            m_coded[pivot_index] = true;
+
+            m_maximum_pivot =
+                direction_policy::max(pivot_index, m_maximum_pivot);
+
+            m_last_pivot = pivot_index;
+        }
+
+        /// Applies the recorded operations to one tile of the symbols
+        /// @param offset The offset of the tile in value_type elements
+        /// @param length The length of the tile in value_type elements
+        void replay_tile(uint32_t offset, uint32_t length)
+        {
+            for(const auto& op : m_operations)
+            {
+                value_type *dest = op.m_dest + offset;
+
+                SuperCoder::push_operations_phase(op.m_phase);
+
+                switch(op.m_kind)
+                {
+                case operation_kind::subtract:
+                    if(fifi::is_binary<field_type>::value)
+                    {
+                        SuperCoder::subtract(
+                            dest, op.m_src + offset, length);
+                    }
+                    else
+                    {
+                        SuperCoder::multiply_subtract(
+                            dest, op.m_src + offset, op.m_value, length);
+                    }
+                    break;
+                case operation_kind::multiply:
+                    SuperCoder::multiply(dest, op.m_value, length);
+                    break;
+                case operation_kind::copy:
+                    std::copy_n(op.m_src + offset, length, dest);
+                    break;
+                }
+
+                SuperCoder::pop_operations_phase();
+            }
+        }
+
+    private:
+
+        /// True while the coded symbols are being recorded
+        bool m_batching;
+
+        /// The data of the recorded symbols
+        std::vector<value_type*> m_batch_symbols;
+
+        /// The coefficients of the recorded symbols stored back to back
+        std::vector<value_type> m_batch_coefficients;
+
+        /// The row operations on the symbol data of the current batch
+        std::vector<operation> m_operations;
+
+    };
+
+}
@@ -0,0 +1,196 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+#include "batch_tiles.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Allows several coded symbols to be produced in one pass
+    ///        over the stored symbols.
+    ///
+    /// Between begin_batch() and end_batch() the calls to
+    /// encode_symbol(uint8_t*, uint8_t*) only record the destination
+    /// and a copy of the coefficients. The recorded symbols are computed
+    /// in end_batch() as a matrix product, which is split into tiles of
+    /// the symbols such that every stored symbol is read once per batch
+    /// instead of once per coded symbol. Outside a batch the calls are
+    /// forwarded unchanged.
+    ///
+    /// The destination buffers must therefore stay valid and untouched
+    /// until end_batch() returns.
+    template<class SuperCoder>
+    class batch_linear_block_encoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+    public:
+
+        /// Constructor
+        batch_linear_block_encoder()
+            : m_batching(false)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_batching = false;
+            m_batch_symbols.clear();
+            m_batch_coefficients.clear();
+        }
+
+        /// Starts recording the coded symbols requested
+        void begin_batch()
+        {
+            assert(!m_batching);
+            assert(m_batch_symbols.empty());
+
+            m_batching = true;
+        }
+
+        /// Computes the coded symbols recorded since begin_batch()
+        void end_batch()
+        {
+            assert(m_batching);
+
+            if(!m_batch_symbols.empty())
+            {
+                SuperCoder::push_operations_phase(operations_phase::encode);
+                encode_batch();
+                SuperCoder::pop_operations_phase();
+            }
+
+            m_batching = false;
+            m_batch_symbols.clear();
+            m_batch_coefficients.clear();
+        }
+
+        /// @copydoc layer::encode_symbol(uint8_t*, uint8_t*)
+        void encode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            if(!m_batching)
+            {
+                SuperCoder::encode_symbol(symbol_data, coefficients);
+                return;
+            }
+
+            // The coefficients buffer is typically reused by the layers
+            // above for the next symbol so we have to keep a copy
+            const value_type *c =
+                reinterpret_cast<const value_type*>(coefficients);
+
+            m_batch_coefficients.insert(
+                m_batch_coefficients.end(), c,
+                c + SuperCoder::coefficients_length());
+
+            m_batch_symbols.push_back(
+                reinterpret_cast<value_type*>(symbol_data));
+        }
+
+        /// @copydoc layer::encode_symbol(uint8_t*,uint32_t)
+        void encode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            SuperCoder::encode_symbol(symbol_data, symbol_index);
+        }
+
+    private:
+
+        /// Computes the recorded symbols tile by tile
+        void encode_batch()
+        {
+            for_each_batch_tile<field_type>(SuperCoder::symbol_length(),
+                [this](uint32_t offset, uint32_t length)
+                {
+                    encode_tile(offset, length);
+                });
+        }
+
+        /// Accumulates one tile of every stored symbol into the
+        /// corresponding tile of the recorded symbols
+        /// @param offset The offset of the tile in value_type elements
+        /// @param length The length of the tile in value_type elements
+        void encode_tile(uint32_t offset, uint32_t length)
+        {
+            uint32_t batch = static_cast<uint32_t>(m_batch_symbols.size());
+            uint32_t coefficients_length = SuperCoder::coefficients_length();
+
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+            {
+                const value_type *symbol_i = 0;
+
+                for(uint32_t j = 0; j < batch; ++j)
+                {
+                    const value_type *c =
+                        &m_batch_coefficients[j * coefficients_length];
+
+                    value_type value = fifi::get_value<field_type>(c, i);
+
+                    if(!value)
+                    {
+                        continue;
+                    }
+
+                    if(symbol_i == 0)
+                    {
+                        assert(SuperCoder::symbol_pivot(i));
+
+                        symbol_i = SuperCoder::symbol_value(i);
+                        assert(symbol_i != 0);
+
+                        symbol_i += offset;
+                    }
+
+                    value_type *symbol = m_batch_symbols[j] + offset;
+
+                    if(fifi::is_binary<field_type>::value)
+                    {
+                        SuperCoder::add(symbol, symbol_i, length);
+                    }
+                    else
+                    {
+                        SuperCoder::multiply_add(
+                            symbol, symbol_i, value, length);
+                    }
+                }
+            }
+        }
+
+    private:
+
+        /// True while the coded symbols are being recorded
+        bool m_batching;
+
+        /// The destinations of the recorded symbols
+        std::vector<value_type*> m_batch_symbols;
+
+        /// The coefficients of the recorded symbols stored back to back
+        std::vector<value_type> m_batch_coefficients;
+
+    };
+
+}
@@ -0,0 +1,73 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include <fifi/fifi_utils.hpp>
+
+/// @file
+/// The tiling of the symbol data shared by the batch_linear_block_encoder
+/// and the batch_linear_block_decoder. Both layers process a batch one
+/// tile of the symbols at a time, such that every stored symbol is read
+/// once per batch.
+
+namespace kodo
+{
+
+    /// The preferred size in bytes of the tiles processed at a time
+    const uint32_t batch_tile_size = 4096;
+
+    /// Splits the symbols into tiles of roughly batch_tile_size bytes.
+    /// The tiles are kept a multiple of 64 bytes such that the region
+    /// kernels stay aligned.
+    /// @param symbol_length The length of a symbol
+    /// @return The length of a tile in value_type elements
+    template<class Field>
+    inline uint32_t batch_tile_length(uint32_t symbol_length)
+    {
+        uint32_t alignment = fifi::size_to_length<Field>(64);
+        uint32_t tile_length = fifi::size_to_length<Field>(batch_tile_size);
+
+        tile_length = std::max(tile_length, alignment);
+
+        if(symbol_length < 2 * tile_length)
+        {
+            return symbol_length;
+        }
+
+        return tile_length;
+    }
+
+    /// Invokes the function for every tile of a symbol. The last tile
+    /// takes the remaining elements, so it may be up to twice as long as
+    /// the others.
+    /// @param symbol_length The length of a symbol
+    /// @param function The function called as function(offset, length)
+    ///        with the offset and length of the tile in value_type
+    ///        elements
+    template<class Field, class Function>
+    inline void for_each_batch_tile(uint32_t symbol_length,
+                                    const Function &function)
+    {
+        uint32_t tile_length = batch_tile_length<Field>(symbol_length);
+
+        for(uint32_t offset = 0; offset < symbol_length;
+            offset += tile_length)
+        {
+            uint32_t length = symbol_length - offset;
+
+            if(length < 2 * tile_length)
+            {
+                tile_length = length;
+            }
+
+            function(offset, tile_length);
+        }
+    }
+
+}
@@ -6,6 +6,9 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
@@ -19,6 +22,7 @@
 
 #include <kodo/forward_linear_block_decoder_policy.hpp>
 #include <kodo/backward_linear_block_decoder_policy.hpp>
+#include <kodo/operations_phase.hpp>
 
 namespace kodo
 {
@@ -50,7 +54,10 @@ namespace kodo
         /// Constructor
         bidirectional_linear_block_decoder()
             : m_rank(0),
-              m_maximum_pivot(0)
+              m_maximum_pivot(0),
+              m_last_pivot(0),
+              m_column_index_valid(false),
+              m_stale_index_scans(0)
         { }
 
         /// @copydoc layer::construct(Factory&)
@@ -61,6 +68,14 @@ namespace kodo
 
             m_uncoded.resize(the_factory.max_symbols(), false);
             m_coded.resize(the_factory.max_symbols(), false);
+            m_unit_vector_stored.resize(the_factory.max_symbols(), false);
+
+            m_column_rows.resize(the_factory.max_symbols());
+            m_backward_rows.reserve(the_factory.max_symbols());
+
+            m_substitutions.reserve(the_factory.max_symbols());
+            m_innovative_coefficients.resize(
+                the_factory.max_coefficients_size());
         }
 
         /// @copydoc layer::initialize(Factory&)
@@ -71,8 +86,13 @@ namespace kodo
 
             std::fill_n(m_uncoded.begin(), the_factory.symbols(), false);
             std::fill_n(m_coded.begin(), the_factory.symbols(), false);
+            std::fill_n(m_unit_vector_stored.begin(),
+                        the_factory.symbols(), false);
 
             m_rank = 0;
+            m_last_pivot = 0;
+
+            invalidate_column_index();
 
             // Depending on the policy we either go from 0 to symbols or
             // from symbols to 0.
@@ -117,15 +137,17 @@ namespace kodo
             }
             else
             {
-                // Stores the symbol and updates the corresponding
-                // encoding vector
+                // Stores the symbol, the encoding vector is implicitly
+                // the unit vector of the pivot
                 store_uncoded_symbol(symbol, symbol_index);
 
                 // Backwards substitution
-                value_type *coefficients =
-                    SuperCoder::coefficients_value(symbol_index);
+                SuperCoder::push_operations_phase(
+                    operations_phase::backward_substitute);
 
-                backward_substitute(symbol, coefficients, symbol_index);
+                backward_substitute_uncoded(symbol, symbol_index);
+
+                SuperCoder::pop_operations_phase();
 
                 // We have increased the rank if we have finished the
                 // backwards substitution
@@ -136,6 +158,8 @@ namespace kodo
                 m_maximum_pivot =
                     direction_policy::max(symbol_index, m_maximum_pivot);
 
+                m_last_pivot = symbol_index;
+
             }
         }
 
@@ -158,6 +182,13 @@ namespace kodo
             return m_coded[index] || m_uncoded[index];
         }
 
+        /// @copydoc layer::last_pivot() const
+        uint32_t last_pivot() const
+        {
+            assert(m_rank > 0);
+            return m_last_pivot;
+        }
+
         /// @todo Add unit test
         /// @copydoc layer::symbol_pivot(uint32_t) const
         bool symbol_coded(uint32_t index) const
@@ -166,9 +197,101 @@ namespace kodo
             return m_coded[index];
         }
 
+        /// Marks a symbol as a pivot without decoding it. This is used
+        /// when the symbol and its coefficients have been restored
+        /// directly into the storage layers e.g. from a checkpoint.
+        /// @param index The pivot index of the restored symbol
+        /// @param coded True if the symbol is still coded, false if it
+        ///        is fully decoded
+        void restore_symbol_pivot(uint32_t index, bool coded)
+        {
+            assert(index < SuperCoder::symbols());
+            assert(!symbol_pivot(index));
+
+            if(coded)
+            {
+                invalidate_column_index();
+
+                m_coded[index] = true;
+            }
+            else
+            {
+                m_uncoded[index] = true;
+                m_unit_vector_stored[index] = false;
+            }
+
+            ++m_rank;
+
+            m_maximum_pivot =
+                direction_policy::max(index, m_maximum_pivot);
+
+            m_last_pivot = index;
+        }
+
+        /// The coefficients of uncoded symbols are not stored while
+        /// decoding, they are implicitly the unit vector of the pivot.
+        /// The unit vector is only written when the coefficients are
+        /// requested, e.g. by a recoder.
+        /// @copydoc layer::coefficients(uint32_t)
+        uint8_t* coefficients(uint32_t index)
+        {
+            store_unit_vector(index);
+            return SuperCoder::coefficients(index);
+        }
+
+        /// Like the non-const overload the unit vector of an uncoded
+        /// symbol is written on the first read.
+        /// @copydoc layer::coefficients(uint32_t) const
+        const uint8_t* coefficients(uint32_t index) const
+        {
+            store_unit_vector(index);
+            return SuperCoder::coefficients(index);
+        }
+
+        /// @copydoc layer::coefficients_value(uint32_t)
+        value_type* coefficients_value(uint32_t index)
+        {
+            return reinterpret_cast<value_type*>(coefficients(index));
+        }
+
+        /// @copydoc layer::coefficients_value(uint32_t) const
+        const value_type* coefficients_value(uint32_t index) const
+        {
+            return reinterpret_cast<const value_type*>(
+                coefficients(index));
+        }
+
+        /// @copydoc layer::is_innovative(const uint8_t*)
+        bool is_innovative(const uint8_t *symbol_coefficients)
+        {
+            assert(symbol_coefficients != 0);
+
+            // Reduce a copy such that the caller may still pass the
+            // coefficients to the decoder
+            std::copy_n(symbol_coefficients,
+                        SuperCoder::coefficients_size(),
+                        &m_innovative_coefficients[0]);
+
+            value_type *coefficients = reinterpret_cast<value_type*>(
+                &m_innovative_coefficients[0]);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            bool innovative =
+                reduce_coefficients_to_pivot(coefficients).is_initialized();
+
+            SuperCoder::pop_operations_phase();
+
+            return innovative;
+        }
+
     protected:
 
-        /// Decodes a symbol based on the coefficients
+        /// Decodes a symbol based on the coefficients. The coefficients
+        /// are reduced to a pivot first, the symbol data is then copied
+        /// into the storage of the pivot and decoded there, such that it
+        /// is not copied again when stored.
         /// @param symbol_data buffer containing the encoding symbol
         /// @param symbol_id buffer containing the encoding vector
         void decode_coefficients(value_type *symbol_data,
@@ -177,32 +300,29 @@ namespace kodo
             assert(symbol_data != 0);
             assert(symbol_coefficients != 0);
 
-            // See if we can find a pivot
-            auto pivot_index
-                = forward_substitute_to_pivot(
-                    symbol_data, symbol_coefficients);
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            auto pivot_index =
+                reduce_coefficients_to_pivot(symbol_coefficients);
+
+            SuperCoder::pop_operations_phase();
 
             if(!pivot_index)
                 return;
 
-            if(!fifi::is_binary<field_type>::value)
-            {
-                // Normalize symbol and vector
-                normalize(
-                    symbol_data,symbol_coefficients,*pivot_index);
-            }
+            value_type *symbol = move_into_pivot(symbol_data, *pivot_index);
 
-            // Reduce the symbol further
-            forward_substitute_from_pivot(
-                symbol_data, symbol_coefficients, *pivot_index);
+            symbol_operations operations(*this);
 
-            // Now with the found pivot reduce the existing symbols
-            backward_substitute(
-                symbol_data, symbol_coefficients, *pivot_index);
+            eliminate_symbol(
+                symbol, symbol_coefficients, *pivot_index, operations);
+
+            // Now save the received symbol, the symbol data is already in
+            // place
+            store_coded_symbol(symbol, symbol_coefficients, *pivot_index);
 
-            // Now save the received symbol
-            store_coded_symbol(
-                symbol_data, symbol_coefficients, *pivot_index);
+            invalidate_column_index();
 
             // We have increased the rank
             ++m_rank;
@@ -211,6 +331,102 @@ namespace kodo
 
             m_maximum_pivot =
                 direction_policy::max(*pivot_index, m_maximum_pivot);
+
+            m_last_pivot = *pivot_index;
+        }
+
+        /// Eliminates a received symbol against the stored symbols. The
+        /// coefficients are reduced to a pivot, normalized and reduced by
+        /// the pivots after it, and the pivot is then eliminated from the
+        /// stored coded symbols. The operations on the symbol data are
+        /// handed to an Operations object, which either applies them
+        /// directly (symbol_operations) or records them for later, e.g.
+        /// in the batch_linear_block_decoder. It provides:
+        ///
+        ///     void subtract(operations_phase phase, value_type *dest,
+        ///                   const value_type *src, value_type value);
+        ///     void multiply(operations_phase phase, value_type *dest,
+        ///                   value_type value);
+        ///
+        /// The received symbol is not stored.
+        /// @param symbol_data buffer containing the encoding symbol
+        /// @param symbol_id buffer containing the encoding vector
+        /// @param operations receives the operations on the symbol data
+        /// @return the pivot index if the symbol was innovative
+        template<class Operations>
+        boost::optional<uint32_t> eliminate_coefficients(
+            value_type *symbol_data, value_type *symbol_id,
+            Operations &operations)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_id != 0);
+
+            // See if we can find a pivot
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            auto pivot_index = reduce_coefficients_to_pivot(symbol_id);
+
+            SuperCoder::pop_operations_phase();
+
+            if(!pivot_index)
+                return boost::none;
+
+            eliminate_symbol(symbol_data, symbol_id, *pivot_index,
+                             operations);
+
+            return pivot_index;
+        }
+
+        /// Completes the elimination of a symbol whose coefficients have
+        /// been reduced to a pivot by reduce_coefficients_to_pivot(),
+        /// see eliminate_coefficients().
+        /// @param symbol_data buffer containing the encoding symbol
+        /// @param symbol_id buffer containing the encoding vector
+        /// @param pivot_index the index of the found pivot element
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
+        void eliminate_symbol(value_type *symbol_data, value_type *symbol_id,
+                              uint32_t pivot_index, Operations &operations)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_id != 0);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            forward_substitute_symbol(symbol_data, operations);
+
+            SuperCoder::pop_operations_phase();
+
+            if(!fifi::is_binary<field_type>::value)
+            {
+                // Normalize symbol and vector
+                SuperCoder::push_operations_phase(
+                    operations_phase::normalize);
+
+                normalize(symbol_data, symbol_id, pivot_index, operations);
+
+                SuperCoder::pop_operations_phase();
+            }
+
+            // Reduce the symbol further
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            forward_substitute_from_pivot(
+                symbol_data, symbol_id, pivot_index, operations);
+
+            SuperCoder::pop_operations_phase();
+
+            // Now with the found pivot reduce the existing symbols
+            SuperCoder::push_operations_phase(
+                operations_phase::backward_substitute);
+
+            backward_substitute(
+                symbol_data, symbol_id, pivot_index, operations);
+
+            SuperCoder::pop_operations_phase();
         }
 
         /// When adding a raw symbol (i.e. uncoded) with a specific
@@ -227,6 +443,8 @@ namespace kodo
 
             m_coded[pivot_index] = false;
 
+            invalidate_column_index();
+
             value_type *symbol_i =
                 SuperCoder::symbol_value(pivot_index);
 
@@ -241,17 +459,20 @@ namespace kodo
             // Subtract the new pivot symbol
             fifi::set_value<field_type>(vector_i, pivot_index, 0);
 
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
             SuperCoder::subtract(symbol_i, symbol_data,
                                  SuperCoder::symbol_length());
 
+            SuperCoder::pop_operations_phase();
+
             // Now continue our new coded symbol we know that it must
             // if found it will contain a pivot id > that the current.
             decode_coefficients(symbol_i, vector_i);
 
-            // The previous vector may still be in memory
-            std::fill_n(vector_i, SuperCoder::coefficients_length(), 0);
-
-            // Stores the symbol and sets the pivot in the vector
+            // Stores the symbol, the previous vector is left in memory
+            // until the unit vector is requested
             store_uncoded_symbol(symbol_data, pivot_index);
 
             m_uncoded[pivot_index] = true;
@@ -261,8 +482,8 @@ namespace kodo
             // substitution must already have been done.
         }
 
-        /// Iterates the encoding vector from where a pivot has been
-        /// identified and subtracts existing symbols
+        /// Normalizes the symbol and its encoding vector such that the
+        /// pivot element is one
         /// @param symbol_data the data of the encoded symbol
         /// @param symbol_id the data constituting the encoding vector
         /// @param pivot_index the index of the found pivot element
@@ -270,7 +491,18 @@ namespace kodo
                        value_type *symbol_id,
                        uint32_t pivot_index)
         {
+            symbol_operations operations(*this);
+            normalize(symbol_data, symbol_id, pivot_index, operations);
+        }
 
+        /// @copydoc normalize(value_type*,value_type*,uint32_t)
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
+        void normalize(value_type *symbol_data,
+                       value_type *symbol_id,
+                       uint32_t pivot_index,
+                       Operations &operations)
+        {
             assert(symbol_id != 0);
             assert(symbol_data != 0);
 
@@ -288,31 +520,97 @@ namespace kodo
                 SuperCoder::invert(coefficient);
 
             // Update symbol and corresponding vector
-            SuperCoder::multiply(symbol_id, inverted_coefficient,
-                                 SuperCoder::coefficients_length());
-
-            SuperCoder::multiply(symbol_data, inverted_coefficient,
-                                 SuperCoder::symbol_length());
+            multiply_coefficients(symbol_id, inverted_coefficient);
 
+            operations.multiply(operations_phase::normalize,
+                                symbol_data, inverted_coefficient);
         }
 
         /// Iterates the encoding vector and subtracts existing symbols
         /// until a pivot element is found.
+        ///
+        /// The coefficients are reduced first while the row operations
+        /// are recorded. The recorded operations are only replayed on the
+        /// symbol data if a pivot is found, so a non-innovative symbol
+        /// costs no work on its symbol data.
         /// @param symbol_data the data of the encoded symbol
         /// @param symbol_id the data constituting the encoding vector
         /// @return the pivot index if found.
         boost::optional<uint32_t> forward_substitute_to_pivot(
             value_type *symbol_data,
             value_type *symbol_id)
+        {
+            symbol_operations operations(*this);
+
+            return forward_substitute_to_pivot(
+                symbol_data, symbol_id, operations);
+        }
+
+        /// @copydoc forward_substitute_to_pivot(value_type*,value_type*)
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
+        boost::optional<uint32_t> forward_substitute_to_pivot(
+            value_type *symbol_data,
+            value_type *symbol_id,
+            Operations &operations)
         {
             assert(symbol_id != 0);
             assert(symbol_data != 0);
 
+            auto pivot_index = reduce_coefficients_to_pivot(symbol_id);
+
+            if(!pivot_index)
+            {
+                return boost::none;
+            }
+
+            forward_substitute_symbol(symbol_data, operations);
+
+            return pivot_index;
+        }
+
+        /// Applies the substitutions recorded by the last call to
+        /// reduce_coefficients_to_pivot() to the symbol data
+        /// @param symbol_data the data of the encoded symbol
+        void forward_substitute_symbol(value_type *symbol_data)
+        {
+            symbol_operations operations(*this);
+            forward_substitute_symbol(symbol_data, operations);
+        }
+
+        /// @copydoc forward_substitute_symbol(value_type*)
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
+        void forward_substitute_symbol(value_type *symbol_data,
+                                       Operations &operations)
+        {
+            assert(symbol_data != 0);
+
+            for(const auto& substitution : m_substitutions)
+            {
+                operations.subtract(
+                    operations_phase::forward_substitute, symbol_data,
+                    SuperCoder::symbol_value(substitution.first),
+                    substitution.second);
+            }
+        }
+
+        /// Iterates the encoding vector and subtracts the coefficients of
+        /// the existing symbols until a pivot element is found. The
+        /// subtracted symbols and their coefficients are recorded in
+        /// m_substitutions.
+        /// @param symbol_id the data constituting the encoding vector
+        /// @return the pivot index if found.
+        boost::optional<uint32_t> reduce_coefficients_to_pivot(
+            value_type *symbol_id)
+        {
+            assert(symbol_id != 0);
+
+            m_substitutions.clear();
+
             uint32_t start = direction_policy::min(0, SuperCoder::symbols()-1);
             uint32_t end = direction_policy::max(0, SuperCoder::symbols()-1);
 
-            // std::cout << start << " " << end << std::endl;
-
             for(direction_policy p(start, end); !p.at_end(); p.advance())
             {
                 uint32_t i = p.index();
@@ -322,37 +620,25 @@ namespace kodo
 
                 if( current_coefficient )
                 {
-                    // If symbol exists
-                    if( symbol_pivot( i ) )
+                    if( m_uncoded[i] )
+                    {
+                        // Subtracting the unit vector only clears the
+                        // coefficient
+                        fifi::set_value<field_type>(symbol_id, i, 0U);
+
+                        m_substitutions.push_back(
+                            std::make_pair(i, current_coefficient));
+                    }
+                    else if( m_coded[i] )
                     {
                         value_type *vector_i =
                             SuperCoder::coefficients_value( i );
 
-                        value_type *symbol_i =
-                            SuperCoder::symbol_value( i );
-
-                        if(fifi::is_binary<field_type>::value)
-                        {
-                            SuperCoder::subtract(
-                                symbol_id, vector_i,
-                                SuperCoder::coefficients_length());
-
-                            SuperCoder::subtract(
-                                symbol_data, symbol_i,
-                                SuperCoder::symbol_length());
-                        }
-                        else
-                        {
-                            SuperCoder::multiply_subtract(
-                                symbol_id, vector_i,
-                                current_coefficient,
-                                SuperCoder::coefficients_length());
-
-                            SuperCoder::multiply_subtract(
-                                symbol_data, symbol_i,
-                                current_coefficient,
-                                SuperCoder::symbol_length());
-                        }
+                        subtract_coefficients(
+                            symbol_id, vector_i, current_coefficient);
+
+                        m_substitutions.push_back(
+                            std::make_pair(i, current_coefficient));
                     }
                     else
                     {
@@ -369,14 +655,13 @@ namespace kodo
         /// @param symbol_data the data of the encoded symbol
         /// @param symbol_id the data constituting the encoding vector
         /// @param pivot_index the index of the found pivot element
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
         void forward_substitute_from_pivot(value_type *symbol_data,
                                            value_type *symbol_id,
-                                           uint32_t pivot_index)
+                                           uint32_t pivot_index,
+                                           Operations &operations)
         {
-            // We have received an encoded symbol - described
-            // by the symbol group. We now normalize the
-            // the encoding vector according to the symbol id.
-            // I.e. we make sure the pivot position has a "1"
             assert(symbol_id != 0);
             assert(symbol_data != 0);
 
@@ -390,8 +675,6 @@ namespace kodo
             // substitute the higher pivot values into the new packet
             uint32_t end = direction_policy::max(0, SuperCoder::symbols()-1);
 
-            // std::cout << "Pivot " << pivot_index << " to " << end << std::endl;
-
             direction_policy p(pivot_index, end);
 
             // Jump past the pivot_index position
@@ -405,64 +688,56 @@ namespace kodo
                 value_type value =
                     fifi::get_value<field_type>(symbol_id, i);
 
-
                 if( !value )
                 {
                     continue;
                 }
 
-                if( symbol_pivot(i) )
+                if( m_uncoded[i] )
                 {
-                    value_type *vector_i =
-                        SuperCoder::coefficients_value(i);
-
-                    value_type *symbol_i =
-                        SuperCoder::symbol_value(i);
-
-                    if(fifi::is_binary<field_type>::value)
-                    {
-                        SuperCoder::subtract(
-                            symbol_id, vector_i,
-                            SuperCoder::coefficients_length());
-
-                        SuperCoder::subtract(
-                            symbol_data, symbol_i,
-                            SuperCoder::symbol_length());
-                    }
-                    else
-                    {
-                        SuperCoder::multiply_subtract(
-                            symbol_id, vector_i, value,
-                            SuperCoder::coefficients_length());
-
-                        SuperCoder::multiply_subtract(
-                            symbol_data, symbol_i, value,
-                            SuperCoder::symbol_length());
-                    }
+                    fifi::set_value<field_type>(symbol_id, i, 0U);
+                }
+                else if( m_coded[i] )
+                {
+                    subtract_coefficients(
+                        symbol_id, SuperCoder::coefficients_value(i), value);
+                }
+                else
+                {
+                    continue;
                 }
+
+                operations.subtract(
+                    operations_phase::forward_substitute, symbol_data,
+                    SuperCoder::symbol_value(i), value);
             }
         }
 
         /// Backward substitute the found symbol into the
-        /// existing symbols.
+        /// existing symbols. Every coded symbol is checked since a
+        /// coded symbol changes most columns of the coding matrix, which
+        /// also makes the column index stale.
         /// @param symbol_data buffer containing the encoding symbol
         /// @param symbol_id buffer containing the encoding vector
         /// @param pivot_index the pivot index of the symbol in the
         ///        buffers symbol_id and symbol_data
+        /// @param operations receives the operations on the symbol data
+        template<class Operations>
         void backward_substitute(const value_type *symbol_data,
                                  const value_type *symbol_id,
-                                 uint32_t pivot_index)
+                                 uint32_t pivot_index,
+                                 Operations &operations)
         {
             assert(symbol_id != 0);
             assert(symbol_data != 0);
 
             assert(pivot_index < SuperCoder::symbols());
 
+            invalidate_column_index();
+
             uint32_t from = direction_policy::min(0, SuperCoder::symbols()-1);
             uint32_t to = m_maximum_pivot;
 
-            // std::cout << from << " " << to << std::endl;
-
             // We found a "1" that nobody else had as pivot, we now
             // substract this packet from other coded packets
             // - if they have a "1" on our pivot place
@@ -470,59 +745,229 @@ namespace kodo
             {
                 uint32_t i = p.index();
 
-                if( m_uncoded[i] )
+                if(i == pivot_index || !m_coded[i])
                 {
-                    // We know that we have no non-zero elements
-                    // outside the pivot position.
+                    // Uncoded symbols have no non-zero elements outside
+                    // the pivot position
                     continue;
                 }
 
-                if(i == pivot_index)
+                value_type *vector_i = SuperCoder::coefficients_value(i);
+
+                value_type value =
+                    fifi::get_value<field_type>(vector_i, pivot_index);
+
+                if(!value)
                 {
-                    // We cannot backward substitute into ourself
                     continue;
                 }
 
-                if( m_coded[i] )
-                {
-                    value_type *vector_i =
-                        SuperCoder::coefficients_value(i);
+                // Update symbol and corresponding vector
+                subtract_coefficients(vector_i, symbol_id, value);
+
+                operations.subtract(
+                    operations_phase::backward_substitute,
+                    SuperCoder::symbol_value(i), symbol_data, value);
+            }
+        }
+
+        /// Backward substitute an uncoded symbol into the existing
+        /// symbols. As the encoding vector is the unit vector of the
+        /// pivot only the coded symbols with a non-zero element on the
+        /// pivot place are touched, and their vectors only lose that
+        /// element.
+        ///
+        /// The coded symbols are found through the column index. While
+        /// the index is stale the pivots are scanned instead, which
+        /// costs a lookup per pivot, whereas rebuilding the index costs
+        /// a lookup per coefficient of the coded symbols. The index is
+        /// therefore rebuilt once the scans since it became stale
+        /// outnumber the coded symbols, so a burst of uncoded symbols
+        /// after a coded symbol uses the index and decoding coded
+        /// symbols only costs a flag.
+        /// @param symbol_data buffer containing the uncoded symbol
+        /// @param pivot_index the pivot index of the symbol
+        void backward_substitute_uncoded(const value_type *symbol_data,
+                                         uint32_t pivot_index)
+        {
+            assert(symbol_data != 0);
+            assert(pivot_index < SuperCoder::symbols());
 
-                    value_type value =
-                        fifi::get_value<field_type>(
-                            vector_i, pivot_index);
+            if(!m_column_index_valid)
+            {
+                uint32_t coded = 0;
 
-                    if( value )
+                uint32_t from =
+                    direction_policy::min(0, SuperCoder::symbols()-1);
+                uint32_t to = m_maximum_pivot;
+
+                for(direction_policy p(from, to); !p.at_end(); p.advance())
+                {
+                    if(m_coded[p.index()])
                     {
+                        ++coded;
+                        substitute_uncoded(
+                            symbol_data, pivot_index, p.index());
+                    }
+                }
+
+                ++m_stale_index_scans;
+
+                if(m_stale_index_scans > coded)
+                {
+                    build_column_index();
+                }
+
+                return;
+            }
+
+            // The uncoded symbol clears the column, so the other lists
+            // stay exact
+            m_backward_rows.clear();
+            m_backward_rows.swap(m_column_rows[pivot_index]);
+
+            for(uint32_t i : m_backward_rows)
+            {
+                substitute_uncoded(symbol_data, pivot_index, i);
+            }
+        }
+
+        /// Subtracts an uncoded symbol from a coded symbol with a
+        /// non-zero element on its pivot place
+        /// @param symbol_data buffer containing the uncoded symbol
+        /// @param pivot_index the pivot index of the uncoded symbol
+        /// @param i the pivot index of the symbol to update
+        void substitute_uncoded(const value_type *symbol_data,
+                                uint32_t pivot_index, uint32_t i)
+        {
+            if(i == pivot_index || !m_coded[i])
+            {
+                return;
+            }
+
+            value_type *vector_i = SuperCoder::coefficients_value(i);
+
+            value_type value =
+                fifi::get_value<field_type>(vector_i, pivot_index);
+
+            if(!value)
+            {
+                return;
+            }
+
+            fifi::set_value<field_type>(vector_i, pivot_index, 0U);
+
+            subtract_symbol(SuperCoder::symbol_value(i), symbol_data, value);
+        }
+
+        /// Subtracts a multiple of a symbol from another
+        /// @param dest The symbol to update
+        /// @param src The symbol to subtract
+        /// @param value The multiplier of the source symbol, which is one
+        ///        in binary fields
+        void subtract_symbol(value_type *dest, const value_type *src,
+                             value_type value)
+        {
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::subtract(
+                    dest, src, SuperCoder::symbol_length());
+            }
+            else
+            {
+                SuperCoder::multiply_subtract(
+                    dest, src, value, SuperCoder::symbol_length());
+            }
+        }
+
+        /// Multiplies a symbol with a constant
+        /// @param symbol The symbol to update
+        /// @param value The constant
+        void multiply_symbol(value_type *symbol, value_type value)
+        {
+            SuperCoder::multiply(symbol, value, SuperCoder::symbol_length());
+        }
+
+        /// Subtracts a multiple of a coefficient vector from another
+        /// @param dest The coefficients to update
+        /// @param src The coefficients to subtract
+        /// @param value The multiplier of the source coefficients, which
+        ///        is one in binary fields
+        void subtract_coefficients(value_type *dest, const value_type *src,
+                                   value_type value)
+        {
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::subtract(
+                    dest, src, SuperCoder::coefficients_length());
+            }
+            else
+            {
+                SuperCoder::multiply_subtract(
+                    dest, src, value, SuperCoder::coefficients_length());
+            }
 
-                        value_type *symbol_i =
-                            SuperCoder::symbol_value(i);
-
-                        if(fifi::is_binary<field_type>::value)
-                        {
-                            SuperCoder::subtract(
-                                vector_i, symbol_id,
-                                SuperCoder::coefficients_length());
-
-                            SuperCoder::subtract(
-                                symbol_i, symbol_data,
-                                SuperCoder::symbol_length());
-                        }
-                        else
-                        {
-
-                            // Update symbol and corresponding vector
-                            SuperCoder::multiply_subtract(
-                                vector_i, symbol_id, value,
-                                SuperCoder::coefficients_length());
-
-                            SuperCoder::multiply_subtract(
-                                symbol_i, symbol_data, value,
-                                SuperCoder::symbol_length());
-                        }
+            SuperCoder::pop_operations_region();
+        }
+
+        /// Multiplies a coefficient vector with a constant
+        /// @param coefficients The coefficients to update
+        /// @param value The constant
+        void multiply_coefficients(value_type *coefficients,
+                                   value_type value)
+        {
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            SuperCoder::multiply(
+                coefficients, value, SuperCoder::coefficients_length());
+
+            SuperCoder::pop_operations_region();
+        }
+
+        /// Marks the column index as stale after the coded symbols
+        /// changed. The index is only rebuilt when uncoded symbols need
+        /// it, so decoding coded symbols has no index bookkeeping.
+        void invalidate_column_index()
+        {
+            m_column_index_valid = false;
+            m_stale_index_scans = 0;
+        }
+
+        /// Lists every coded symbol in the columns where its encoding
+        /// vector has a non-zero element besides the pivot
+        void build_column_index()
+        {
+            uint32_t symbols = SuperCoder::symbols();
+
+            for(uint32_t j = 0; j < symbols; ++j)
+            {
+                m_column_rows[j].clear();
+            }
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(!m_coded[i])
+                {
+                    continue;
+                }
+
+                const value_type *vector_i =
+                    SuperCoder::coefficients_value(i);
+
+                for(uint32_t j = 0; j < symbols; ++j)
+                {
+                    if(j != i && fifi::get_value<field_type>(vector_i, j))
+                    {
+                        m_column_rows[j].push_back(i);
                     }
                 }
             }
+
+            m_column_index_valid = true;
         }
 
         /// Store an encoded symbol and encoding vector with the specified
@@ -548,15 +993,7 @@ namespace kodo
             SuperCoder::set_coefficients(
                 pivot_index, coefficient_storage);
 
-            // Copy it into the symbol storage
-            sak::mutable_storage dest =
-                sak::storage(SuperCoder::symbol(pivot_index),
-                             SuperCoder::symbol_size());
-
-            sak::const_storage src =
-                sak::storage(symbol_data, SuperCoder::symbol_size());
-
-            sak::copy_storage(dest, src);
+            copy_into_symbol(symbol_data, pivot_index);
         }
 
         /// Stores an uncoded or fully decoded symbol
@@ -570,27 +1007,114 @@ namespace kodo
             assert(m_coded[pivot_index] == false);
             assert(SuperCoder::is_symbol_available(pivot_index));
 
-            // Update the corresponding vector
-            value_type *vector_dest =
-                SuperCoder::coefficients_value( pivot_index );
+            // The unit vector is written on demand by coefficients()
+            m_unit_vector_stored[pivot_index] = false;
+
+            copy_into_symbol(symbol_data, pivot_index);
+
+        }
+
+        /// Writes the unit vector of an uncoded symbol to the coefficient
+        /// storage if it has not been written since the symbol was
+        /// decoded. The unit vector is already implied by the state of the
+        /// decoder, so writing it does not change the logical state and is
+        /// also done for const reads.
+        /// @param index The index of the symbol
+        void store_unit_vector(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+
+            if(!m_uncoded[index] || m_unit_vector_stored[index])
+                return;
+
+            value_type *vector_i = const_cast<value_type*>(
+                SuperCoder::coefficients_value(index));
+
+            std::fill_n(vector_i, SuperCoder::coefficients_length(), 0);
+            fifi::set_value<field_type>(vector_i, index, 1U);
+
+            m_unit_vector_stored[index] = true;
+        }
+
+        /// Copies a received symbol into the storage of its pivot once
+        /// the pivot is known, such that the remaining elimination runs
+        /// in the final location of the symbol. Only the stored symbols
+        /// of other pivots are read while eliminating, so the storage of
+        /// the new pivot is free.
+        /// @param symbol_data the data for the symbol
+        /// @param pivot_index the pivot index of the symbol
+        /// @return the storage of the pivot holding the symbol data
+        value_type* move_into_pivot(const value_type *symbol_data,
+                                    uint32_t pivot_index)
+        {
+            assert(symbol_data != 0);
+            assert(m_uncoded[pivot_index] == false);
+            assert(m_coded[pivot_index] == false);
+            assert(SuperCoder::is_symbol_available(pivot_index));
+
+            copy_into_symbol(symbol_data, pivot_index);
+
+            return SuperCoder::symbol_value(pivot_index);
+        }
 
-            // Zero out the memory first
-            std::fill_n(vector_dest, SuperCoder::coefficients_length(), 0);
+        /// Copies the symbol data into the symbol storage. The copy is
+        /// skipped if the data was decoded in place, i.e. symbol_data
+        /// already points to the storage of the symbol.
+        /// @param symbol_data the data for the symbol
+        /// @param pivot_index the pivot index of the symbol
+        void copy_into_symbol(const value_type *symbol_data,
+                              uint32_t pivot_index)
+        {
+            uint8_t *symbol = SuperCoder::symbol(pivot_index);
 
-            fifi::set_value<field_type>(vector_dest, pivot_index, 1U);
+            if(reinterpret_cast<const uint8_t*>(symbol_data) == symbol)
+                return;
 
-            // Copy it into the symbol storage
             sak::mutable_storage dest =
-                sak::storage(SuperCoder::symbol(pivot_index),
-                             SuperCoder::symbol_size());
+                sak::storage(symbol, SuperCoder::symbol_size());
 
             sak::const_storage src =
                 sak::storage(symbol_data, SuperCoder::symbol_size());
 
             sak::copy_storage(dest, src);
-
         }
 
+    protected:
+
+        /// Applies the operations on the symbol data found by
+        /// eliminate_coefficients() directly
+        class symbol_operations
+        {
+        public:
+
+            /// Constructor
+            /// @param decoder The decoder owning the symbols
+            symbol_operations(bidirectional_linear_block_decoder &decoder)
+                : m_decoder(decoder)
+            { }
+
+            /// Subtracts a multiple of a symbol from another, the phase
+            /// has already been pushed by the decoder
+            void subtract(operations_phase, value_type *dest,
+                          const value_type *src, value_type value)
+            {
+                m_decoder.subtract_symbol(dest, src, value);
+            }
+
+            /// Multiplies a symbol with a constant, the phase has already
+            /// been pushed by the decoder
+            void multiply(operations_phase, value_type *dest,
+                          value_type value)
+            {
+                m_decoder.multiply_symbol(dest, value);
+            }
+
+        private:
+
+            /// The decoder owning the symbols
+            bidirectional_linear_block_decoder &m_decoder;
+        };
+
     protected:
 
         /// The current rank of the decoder
@@ -599,12 +1123,41 @@ namespace kodo
         /// Stores the current maximum pivot index
         uint32_t m_maximum_pivot;
 
+        /// The pivot of the last symbol which increased the rank
+        uint32_t m_last_pivot;
+
         /// Tracks whether a symbol is contained which
         /// is fully decoded
         std::vector<bool> m_uncoded;
 
         /// Tracks whether a symbol is partially decoded
         std::vector<bool> m_coded;
+
+        /// Tracks whether the unit vector of an uncoded symbol has been
+        /// written to the coefficient storage, which may also happen on a
+        /// const read
+        mutable std::vector<bool> m_unit_vector_stored;
+
+        /// For every column the coded symbols with a non-zero element in
+        /// that column, only up to date if m_column_index_valid is set
+        std::vector<std::vector<uint32_t> > m_column_rows;
+
+        /// True if m_column_rows matches the coded symbols
+        bool m_column_index_valid;
+
+        /// The uncoded symbols which scanned the pivots since the column
+        /// index became stale
+        uint32_t m_stale_index_scans;
+
+        /// The coded symbols visited by the current backward substitution
+        std::vector<uint32_t> m_backward_rows;
+
+        /// The symbols and coefficients subtracted from the coefficients
+        /// of the last symbol reduced by reduce_coefficients_to_pivot()
+        std::vector<std::pair<uint32_t, value_type> > m_substitutions;
+
+        /// Buffer for the coefficients checked by is_innovative()
+        std::vector<uint8_t> m_innovative_coefficients;
     };
 
 }
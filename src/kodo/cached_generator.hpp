@@ -0,0 +1,254 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "seed_coefficient_cache.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup coefficient_generator_layers
+    /// @brief Looks up the coefficients of a seed in a cache shared by
+    ///        the coders of a factory before running the generator.
+    ///
+    /// Useful when many decoders on a host consume the same stream of
+    /// seeds, e.g. multicast receivers, since each seed is only expanded
+    /// once. The cache is disabled until the factory is given a capacity
+    /// or a cache. Only layer::generate(uint8_t*) is cached, the output
+    /// of generate_partial() depends on the state of the coder.
+    template<class SuperCoder>
+    class cached_generator : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::seed_type
+        typedef typename SuperCoder::seed_type seed_type;
+
+        /// The cache type, which only holds vectors of this field
+        typedef seed_coefficient_cache<field_type> cache_type;
+
+        /// Pointer to the cache
+        typedef boost::shared_ptr<cache_type> cache_pointer;
+
+        /// The cache keys store the seed in 32 bits
+        static_assert(sizeof(seed_type) <= sizeof(uint32_t),
+                      "Seed must fit in 32 bits");
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder. Owns the cache.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// Creates a new cache for the coders built by this factory
+            /// @param entries The maximum number of cached coefficient
+            ///        vectors, zero disables the cache
+            void set_cache_capacity(uint32_t entries)
+            {
+                if(entries == 0)
+                {
+                    m_cache.reset();
+                    return;
+                }
+
+                m_cache = boost::make_shared<cache_type>(
+                    entries, SuperCoder::factory::max_coefficients_size());
+            }
+
+            /// Uses an existing cache, which allows factories owned by
+            /// different threads to share one cache. The cache type
+            /// fixes the field, and the cache is rejected if its slots
+            /// cannot hold the coefficient vectors of this factory.
+            /// @param cache The cache or an empty pointer
+            /// @return False if the cache was rejected, in which case
+            ///         the factory keeps its current cache
+            bool set_cache(const cache_pointer &cache)
+            {
+                if(cache && cache->slot_size() <
+                   SuperCoder::factory::max_coefficients_size())
+                {
+                    return false;
+                }
+
+                m_cache = cache;
+                return true;
+            }
+
+            /// @return The cache used by the coders, may be empty
+            cache_pointer cache() const
+            {
+                return m_cache;
+            }
+
+        private:
+
+            /// The shared cache
+            cache_pointer m_cache;
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+            m_expanded.resize(the_factory.max_coefficients_size());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+            m_cache = the_factory.cache();
+
+            m_seed = 0;
+            m_seeded = false;
+            m_cached = false;
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            m_seed = seed_value;
+            m_seeded = false;
+            m_cached = false;
+        }
+
+        /// @copydoc layer::generate(uint8_t*)
+        void generate(uint8_t *coefficients)
+        {
+            assert(coefficients != 0);
+
+            uint32_t size = SuperCoder::coefficients_size();
+
+            // Only the first vector after seeding is cached
+            bool first = !m_seeded && !m_cached;
+
+            if(first && m_cache && m_cache->find(
+                   SuperCoder::symbols(), m_seed, coefficients, size))
+            {
+                m_cached = true;
+                return;
+            }
+
+            synchronize();
+            SuperCoder::generate(coefficients);
+
+            if(first && m_cache)
+            {
+                m_cache->insert(
+                    SuperCoder::symbols(), m_seed, coefficients, size);
+            }
+        }
+
+        /// @copydoc layer::generate_partial(uint8_t*)
+        void generate_partial(uint8_t *coefficients)
+        {
+            synchronize();
+            SuperCoder::generate_partial(coefficients);
+        }
+
+        /// Expands a range of seeds into the cache, e.g. ahead of the
+        /// arrival of the symbols. Uses the generator of this coder, so
+        /// seed() must be called again before generating.
+        /// @param first The first seed
+        /// @param count The number of consecutive seeds
+        void expand_seeds(seed_type first, uint32_t count)
+        {
+            if(!m_cache)
+            {
+                return;
+            }
+
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t size = SuperCoder::coefficients_size();
+
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                seed_type seed_value = (seed_type) (first + i);
+
+                if(m_cache->contains(symbols, seed_value, size))
+                {
+                    continue;
+                }
+
+                SuperCoder::seed(seed_value);
+                SuperCoder::generate(&m_expanded[0]);
+
+                m_cache->insert(symbols, seed_value, &m_expanded[0], size);
+            }
+
+            // The generator no longer holds the state of the last seed
+            m_seeded = false;
+            m_cached = false;
+        }
+
+        /// @return The cache used by this coder, may be empty
+        cache_pointer cache() const
+        {
+            return m_cache;
+        }
+
+    private:
+
+        /// Brings the generator to the state it would have without the
+        /// cache, i.e. seeded with the last seed and advanced past a
+        /// vector served from the cache
+        void synchronize()
+        {
+            if(m_seeded)
+            {
+                return;
+            }
+
+            SuperCoder::seed(m_seed);
+            m_seeded = true;
+
+            if(m_cached)
+            {
+                SuperCoder::generate(&m_expanded[0]);
+                m_cached = false;
+            }
+        }
+
+    private:
+
+        /// The shared cache
+        cache_pointer m_cache;
+
+        /// The last seed set
+        seed_type m_seed;
+
+        /// True if the generator has been seeded with m_seed
+        bool m_seeded;
+
+        /// True if the first vector of m_seed was served from the cache
+        bool m_cached;
+
+        /// Buffer used when expanding seeds
+        std::vector<uint8_t> m_expanded;
+
+    };
+
+}
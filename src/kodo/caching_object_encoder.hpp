@@ -0,0 +1,423 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "object_encoder.hpp"
+#include "rfc5052_partitioning_scheme.hpp"
+
+namespace kodo
+{
+
+    /// @brief Object encoder keeping the most recently used encoders.
+    ///
+    /// Wraps an object_encoder and keeps at most capacity() built
+    /// encoders in a least recently used list keyed by the encoder id.
+    /// A build() of a cached encoder returns it without touching the
+    /// object data. After each build() the following encoders, up to
+    /// the prefetch distance, are built by a background thread.
+    ///
+    /// The cache is thread-safe, but as for other coders an encoder
+    /// returned by build() must only be used by one thread at a time.
+    /// Since the factory pool is not thread-safe, the returned pointers
+    /// hand their encoder back to the pool under the lock used for
+    /// building.
+    /// Since the same encoder is returned for repeated requests of a
+    /// block, its state e.g. the systematic phase is shared by the
+    /// callers.
+    ///
+    /// @tparam ObjectData object_data
+    /// @tparam EncoderType An encoder stack which should be used
+    /// @tparam BlockParitioning block_partitioning
+    template
+    <
+        class ObjectData,
+        class EncoderType,
+        class BlockPartitioning = rfc5052_partitioning_scheme
+    >
+    class caching_object_encoder : boost::noncopyable
+    {
+    public:
+
+        /// The wrapped object encoder
+        typedef object_encoder<ObjectData, EncoderType, BlockPartitioning>
+            object_encoder_type;
+
+        /// The type of factory used to build encoders
+        typedef typename object_encoder_type::factory_type factory_type;
+
+        /// Pointer to an encoder
+        typedef typename object_encoder_type::pointer_type pointer_type;
+
+        /// The data source type
+        typedef ObjectData object_data;
+
+    public:
+
+        /// Constructs a new caching object encoder
+        /// @param factory the encoder factory to use
+        /// @param data the object to encode
+        /// @param capacity the maximum number of cached encoders
+        caching_object_encoder(factory_type &factory,
+                               const object_data &data,
+                               uint32_t capacity)
+            : m_encoder(factory, data),
+              m_capacity(capacity),
+              m_prefetch_distance(1),
+              m_hits(0),
+              m_misses(0),
+              m_prefetched(0),
+              m_busy(false),
+              m_stop(false),
+              m_build_mutex(boost::make_shared<std::mutex>())
+        {
+            assert(m_capacity > 0);
+        }
+
+        /// Stops the prefetch thread
+        ~caching_object_encoder()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+
+            m_work_condition.notify_all();
+
+            if(m_worker.joinable())
+            {
+                m_worker.join();
+            }
+
+            std::lock_guard<std::mutex> build_lock(*m_build_mutex);
+
+            m_index.clear();
+            m_lru.clear();
+        }
+
+        /// @return The number of encoders which may be created for
+        ///         this object
+        uint32_t encoders() const
+        {
+            return m_encoder.encoders();
+        }
+
+        /// @return The total size of the object to encode in bytes
+        uint32_t object_size() const
+        {
+            return m_encoder.object_size();
+        }
+
+        /// Returns the cached encoder or builds it
+        /// @param encoder_id Specifies the encoder to build
+        /// @return The initialized encoder
+        pointer_type build(uint32_t encoder_id)
+        {
+            assert(encoder_id < encoders());
+
+            pointer_type encoder = lookup(encoder_id, true);
+
+            if(!encoder)
+            {
+                encoder = build_and_insert(encoder_id, false);
+            }
+
+            prefetch(encoder_id);
+            return encoder;
+        }
+
+        /// Sets the number of following encoders built in the background
+        /// after a build(), zero disables the prefetching
+        /// @param distance The number of encoders to prefetch
+        void set_prefetch_distance(uint32_t distance)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_prefetch_distance = distance;
+        }
+
+        /// Blocks until the scheduled prefetches have completed
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_idle_condition.wait(lock, [this]()
+                {
+                    return m_queue.empty() && !m_busy;
+                });
+        }
+
+        /// @return The maximum number of cached encoders
+        uint32_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        /// @return The number of cached encoders
+        uint32_t cached() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return (uint32_t) m_index.size();
+        }
+
+        /// @return The number of build() calls served from the cache
+        uint64_t hits() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_hits;
+        }
+
+        /// @return The number of build() calls which built the encoder
+        uint64_t misses() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_misses;
+        }
+
+        /// @return The number of encoders built in the background
+        uint64_t prefetched() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_prefetched;
+        }
+
+    private:
+
+        /// The list of cached encoders, most recently used first
+        typedef std::list<std::pair<uint32_t, pointer_type> > lru_list;
+
+    private:
+
+        /// @param encoder_id The encoder
+        /// @param count True if the lookup counts towards the statistics
+        /// @return The cached encoder, which becomes the most recently
+        ///         used, or an empty pointer
+        pointer_type lookup(uint32_t encoder_id, bool count)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_index.find(encoder_id);
+
+            if(it == m_index.end())
+            {
+                return pointer_type();
+            }
+
+            if(count)
+            {
+                ++m_hits;
+            }
+
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return share(it->second->second);
+        }
+
+        /// Builds an encoder and inserts it in the cache. The object
+        /// encoder, its factory and object data are only used with
+        /// m_build_mutex held.
+        /// @param encoder_id The encoder
+        /// @param prefetch True if called by the prefetch thread
+        /// @return The encoder
+        pointer_type build_and_insert(uint32_t encoder_id, bool prefetch)
+        {
+            std::lock_guard<std::mutex> build_lock(*m_build_mutex);
+
+            // The prefetch thread may have built it in the meantime
+            pointer_type encoder = lookup(encoder_id, !prefetch);
+
+            if(encoder)
+            {
+                return encoder;
+            }
+
+            pointer_type built = m_encoder.build(encoder_id);
+            encoder = share(built);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if(prefetch)
+            {
+                ++m_prefetched;
+            }
+            else
+            {
+                ++m_misses;
+            }
+
+            m_lru.push_front(std::make_pair(encoder_id, built));
+            m_index[encoder_id] = m_lru.begin();
+
+            while(m_index.size() > m_capacity)
+            {
+                m_index.erase(m_lru.back().first);
+                m_lru.pop_back();
+            }
+
+            return encoder;
+        }
+
+        /// Wraps an encoder of the cache in a pointer which releases its
+        /// reference with the build lock held. Must be called while the
+        /// cache holds the encoder, such that the reference dropped by the
+        /// caller is never the last one.
+        /// @param encoder The encoder
+        /// @return The pointer handed to the caller
+        pointer_type share(const pointer_type &encoder) const
+        {
+            boost::shared_ptr<std::mutex> build_mutex = m_build_mutex;
+            pointer_type held = encoder;
+
+            return pointer_type(encoder.get(),
+                [build_mutex, held](EncoderType*) mutable
+                {
+                    std::lock_guard<std::mutex> lock(*build_mutex);
+                    held.reset();
+                });
+        }
+
+        /// Schedules the encoders following encoder_id for prefetching
+        /// @param encoder_id The encoder just requested
+        void prefetch(uint32_t encoder_id)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                // Prefetching more than the cache holds would evict the
+                // encoders before they are requested
+                uint32_t distance =
+                    std::min(m_prefetch_distance, m_capacity - 1);
+
+                for(uint32_t i = 1; i <= distance; ++i)
+                {
+                    uint32_t id = encoder_id + i;
+
+                    if(id >= encoders())
+                    {
+                        break;
+                    }
+
+                    if(m_index.count(id) == 0)
+                    {
+                        m_queue.push_back(id);
+                    }
+                }
+
+                if(m_queue.empty())
+                {
+                    return;
+                }
+
+                if(!m_worker.joinable())
+                {
+                    m_worker = std::thread(
+                        &caching_object_encoder::worker_loop, this);
+                }
+            }
+
+            m_work_condition.notify_one();
+        }
+
+        /// The prefetch thread
+        void worker_loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while(true)
+            {
+                m_work_condition.wait(lock, [this]()
+                    {
+                        return m_stop || !m_queue.empty();
+                    });
+
+                if(m_stop)
+                {
+                    return;
+                }
+
+                uint32_t encoder_id = m_queue.front();
+                m_queue.pop_front();
+
+                if(m_index.count(encoder_id) == 0)
+                {
+                    m_busy = true;
+                    lock.unlock();
+
+                    build_and_insert(encoder_id, true);
+
+                    lock.lock();
+                    m_busy = false;
+                }
+
+                if(m_queue.empty())
+                {
+                    m_idle_condition.notify_all();
+                }
+            }
+        }
+
+    private:
+
+        /// The wrapped object encoder
+        object_encoder_type m_encoder;
+
+        /// The maximum number of cached encoders
+        uint32_t m_capacity;
+
+        /// The number of encoders to prefetch after a build()
+        uint32_t m_prefetch_distance;
+
+        /// Statistics
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_prefetched;
+
+        /// True while the prefetch thread builds an encoder
+        bool m_busy;
+
+        /// Signals the prefetch thread to stop
+        bool m_stop;
+
+        /// The cached encoders, most recently used first
+        lru_list m_lru;
+
+        /// Maps encoder ids to the cached encoders
+        std::unordered_map<uint32_t, typename lru_list::iterator> m_index;
+
+        /// The encoder ids scheduled for prefetching
+        std::deque<uint32_t> m_queue;
+
+        /// Protects the cache, the statistics and the queue
+        mutable std::mutex m_mutex;
+
+        /// Serialises the use of the object encoder and its factory
+        /// pool, shared with the pointers returned by build()
+        boost::shared_ptr<std::mutex> m_build_mutex;
+
+        /// Signals the prefetch thread
+        std::condition_variable m_work_condition;
+
+        /// Signals that the prefetch queue has drained
+        std::condition_variable m_idle_condition;
+
+        /// The prefetch thread, started on first use
+        std::thread m_worker;
+
+    };
+
+}
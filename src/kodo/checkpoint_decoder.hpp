@@ -0,0 +1,307 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include <sak/convert_endian.hpp>
+#include <sak/storage.hpp>
+
+#include "checkpoint_field_id.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Allows the state of a partially decoded block to be saved
+    ///        to and restored from a binary checkpoint.
+    ///
+    /// The checkpoint uses the following layout, where all integers are
+    /// stored in big endian:
+    ///
+    /// @code
+    ///   +--------+---------+-------+---------+-------------+------+
+    ///   | magic  | version | field | symbols | symbol_size | rank |
+    ///   | 32 bit | 16 bit  | 16 bit| 32 bit  |   32 bit    |32 bit|
+    ///   +--------+---------+-------+---------+-------------+------+
+    ///   | pivot bitmap | coded bitmap | pivot symbols ...         |
+    ///   +--------------+--------------+---------------------------+
+    /// @endcode
+    ///
+    /// Only the pivot symbols are stored, in increasing index order. A
+    /// coded symbol is stored as its coefficients followed by its data
+    /// whereas a decoded symbol is stored as its data only.
+    ///
+    /// The checkpoint may be restored into a decoder built by a factory
+    /// with the same field, number of symbols and symbol size. Since the
+    /// checkpoint is only read through a pointer it may also be
+    /// restored directly from a memory mapped file.
+    template<class SuperCoder>
+    class checkpoint_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+        /// Identifies a checkpoint
+        static const uint32_t checkpoint_magic = 0x4b444350;
+
+        /// The version of the checkpoint format
+        static const uint16_t checkpoint_version = 1;
+
+        /// The size of the fixed part of the checkpoint
+        static const uint32_t checkpoint_header_size = 20;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @return The size of the largest checkpoint produced by a
+            ///         decoder built by this factory
+            uint32_t max_checkpoint_size() const
+            {
+                uint32_t max_symbols = SuperCoder::factory::max_symbols();
+
+                return checkpoint_header_size +
+                    2 * bitmap_size(max_symbols) +
+                    max_symbols * (SuperCoder::factory::max_symbol_size() +
+                    SuperCoder::factory::max_coefficients_size());
+            }
+        };
+
+    public:
+
+        /// @return The size of the checkpoint of the current state
+        uint32_t checkpoint_size() const
+        {
+            uint32_t size = checkpoint_header_size +
+                2 * bitmap_size(SuperCoder::symbols());
+
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+            {
+                if(!SuperCoder::symbol_pivot(i))
+                {
+                    continue;
+                }
+
+                size += SuperCoder::symbol_size();
+
+                if(SuperCoder::symbol_coded(i))
+                {
+                    size += SuperCoder::coefficients_size();
+                }
+            }
+
+            return size;
+        }
+
+        /// Writes the current state of the decoder
+        /// @param checkpoint The buffer for the checkpoint, it must be at
+        ///        least checkpoint_size() bytes
+        /// @return The number of bytes written
+        uint32_t write_checkpoint(uint8_t *checkpoint) const
+        {
+            assert(checkpoint != 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t symbol_size = SuperCoder::symbol_size();
+            uint32_t coefficients_size = SuperCoder::coefficients_size();
+
+            sak::big_endian::put<uint32_t>(checkpoint_magic, checkpoint);
+            sak::big_endian::put<uint16_t>(
+                checkpoint_version, checkpoint + 4);
+            sak::big_endian::put<uint16_t>(field_id(), checkpoint + 6);
+            sak::big_endian::put<uint32_t>(symbols, checkpoint + 8);
+            sak::big_endian::put<uint32_t>(symbol_size, checkpoint + 12);
+            sak::big_endian::put<uint32_t>(
+                SuperCoder::rank(), checkpoint + 16);
+
+            uint8_t *pivots = checkpoint + checkpoint_header_size;
+            uint8_t *coded = pivots + bitmap_size(symbols);
+            uint8_t *data = coded + bitmap_size(symbols);
+
+            std::fill_n(pivots, 2 * bitmap_size(symbols), 0);
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(!SuperCoder::symbol_pivot(i))
+                {
+                    continue;
+                }
+
+                pivots[i / 8] |= 1U << (i % 8);
+
+                if(SuperCoder::symbol_coded(i))
+                {
+                    coded[i / 8] |= 1U << (i % 8);
+
+                    std::copy_n(SuperCoder::coefficients(i),
+                                coefficients_size, data);
+
+                    data += coefficients_size;
+                }
+
+                std::copy_n(SuperCoder::symbol(i), symbol_size, data);
+                data += symbol_size;
+            }
+
+            return static_cast<uint32_t>(data - checkpoint);
+        }
+
+        /// Restores the state of the decoder from a checkpoint. The
+        /// decoder must not have received any symbols. If the checkpoint
+        /// is invalid or does not match the decoder the decoder is left
+        /// unchanged.
+        /// @param checkpoint The buffer containing the checkpoint
+        /// @param size The size of the checkpoint buffer
+        /// @return True if the checkpoint was restored
+        bool restore_checkpoint(const uint8_t *checkpoint, uint32_t size)
+        {
+            assert(checkpoint != 0);
+            assert(SuperCoder::rank() == 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t symbol_size = SuperCoder::symbol_size();
+            uint32_t coefficients_size = SuperCoder::coefficients_size();
+
+            uint32_t bitmaps_size = 2 * bitmap_size(symbols);
+
+            if(size < checkpoint_header_size + bitmaps_size)
+            {
+                return false;
+            }
+
+            if(sak::big_endian::get<uint32_t>(checkpoint) !=
+                   checkpoint_magic ||
+               sak::big_endian::get<uint16_t>(checkpoint + 4) !=
+                   checkpoint_version ||
+               sak::big_endian::get<uint16_t>(checkpoint + 6) !=
+                   field_id() ||
+               sak::big_endian::get<uint32_t>(checkpoint + 8) != symbols ||
+               sak::big_endian::get<uint32_t>(checkpoint + 12) !=
+                   symbol_size)
+            {
+                return false;
+            }
+
+            uint32_t rank = sak::big_endian::get<uint32_t>(checkpoint + 16);
+
+            const uint8_t *pivots = checkpoint + checkpoint_header_size;
+            const uint8_t *coded = pivots + bitmap_size(symbols);
+            const uint8_t *data = coded + bitmap_size(symbols);
+
+            // Validate the bitmaps against the rank and the size before
+            // touching the decoder
+            uint32_t pivot_count = 0;
+            uint64_t expected_size = checkpoint_header_size + bitmaps_size;
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                bool pivot = is_set(pivots, i);
+
+                if(is_set(coded, i) && !pivot)
+                {
+                    return false;
+                }
+
+                if(!pivot)
+                {
+                    continue;
+                }
+
+                ++pivot_count;
+                expected_size += symbol_size;
+
+                if(is_set(coded, i))
+                {
+                    expected_size += coefficients_size;
+                }
+            }
+
+            if(pivot_count != rank || expected_size != size)
+            {
+                return false;
+            }
+
+            // The padding bits after the last symbol must be zero
+            for(uint32_t i = symbols; i < 8 * bitmap_size(symbols); ++i)
+            {
+                if(is_set(pivots, i) || is_set(coded, i))
+                {
+                    return false;
+                }
+            }
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(!is_set(pivots, i))
+                {
+                    continue;
+                }
+
+                bool symbol_coded = is_set(coded, i);
+
+                // The unit vector of a decoded symbol is written by the
+                // decoder when its coefficients are read
+                if(symbol_coded)
+                {
+                    SuperCoder::set_coefficients(
+                        i, sak::storage(data, coefficients_size));
+
+                    data += coefficients_size;
+                }
+
+                std::copy_n(data, symbol_size, SuperCoder::symbol(i));
+                data += symbol_size;
+
+                SuperCoder::restore_symbol_pivot(i, symbol_coded);
+            }
+
+            assert(data == checkpoint + size);
+
+            return true;
+        }
+
+    private:
+
+        /// @return The identifier of the field stored in the checkpoint
+        static uint16_t field_id()
+        {
+            return checkpoint_field_id<field_type>::value;
+        }
+
+        /// @param symbols The number of symbols
+        /// @return The size in bytes of a bitmap with a bit per symbol
+        static uint32_t bitmap_size(uint32_t symbols)
+        {
+            return (symbols + 7) / 8;
+        }
+
+        /// @param bitmap The bitmap
+        /// @param index The index of the bit
+        /// @return True if the bit at the index is set
+        static bool is_set(const uint8_t *bitmap, uint32_t index)
+        {
+            return (bitmap[index / 8] >> (index % 8)) & 1U;
+        }
+
+    };
+
+}
@@ -0,0 +1,60 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <fifi/field_types.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup type_traits
+    /// Type trait giving the identifier which the checkpoint_decoder
+    /// stores for a finite field. Every field has its own explicit
+    /// identifier since fields of the same value_type, e.g.
+    /// fifi::binary32 and fifi::prime2325, cannot share a checkpoint.
+    /// A field without a specialization cannot be checkpointed.
+    ///
+    /// Example:
+    ///
+    /// uint16_t id = kodo::checkpoint_field_id<fifi::binary8>::value;
+    ///
+    template<class Field>
+    struct checkpoint_field_id;
+
+    /// @copydoc checkpoint_field_id
+    template<>
+    struct checkpoint_field_id<fifi::binary>
+        : public std::integral_constant<uint16_t, 0x0101>
+    { };
+
+    /// @copydoc checkpoint_field_id
+    template<>
+    struct checkpoint_field_id<fifi::binary8>
+        : public std::integral_constant<uint16_t, 0x0001>
+    { };
+
+    /// @copydoc checkpoint_field_id
+    template<>
+    struct checkpoint_field_id<fifi::binary16>
+        : public std::integral_constant<uint16_t, 0x0002>
+    { };
+
+    /// @copydoc checkpoint_field_id
+    template<>
+    struct checkpoint_field_id<fifi::binary32>
+        : public std::integral_constant<uint16_t, 0x0004>
+    { };
+
+    /// @copydoc checkpoint_field_id
+    template<>
+    struct checkpoint_field_id<fifi::prime2325>
+        : public std::integral_constant<uint16_t, 0x0204>
+    { };
+
+}
@@ -0,0 +1,344 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace kodo
+{
+
+    /// The values of a coder_metrics at one point in time
+    struct metrics_snapshot
+    {
+        /// The number of symbols passed to the coder
+        uint64_t m_payloads;
+
+        /// The number of symbols which increased the rank
+        uint64_t m_innovative;
+
+        /// The number of symbols which did not increase the rank
+        uint64_t m_non_innovative;
+
+        /// The number of uncoded (systematic) symbols
+        uint64_t m_systematic;
+
+        /// The number of uncoded symbols which replaced a coded symbol
+        uint64_t m_swaps;
+
+        /// The number of symbol bytes processed
+        uint64_t m_bytes;
+
+        /// The number of completed decodings
+        uint64_t m_completed;
+
+        /// The total time from the first symbol to completion of the
+        /// completed decodings in nanoseconds
+        uint64_t m_decode_nanoseconds;
+
+        /// @return The fraction of the received symbols which were not
+        ///         innovative
+        double non_innovative_rate() const
+        {
+            uint64_t received = m_innovative + m_non_innovative;
+            return received == 0 ? 0.0 : m_non_innovative / (double) received;
+        }
+
+        /// @return The average time to decode in nanoseconds
+        double average_decode_nanoseconds() const
+        {
+            return m_completed == 0 ?
+                0.0 : m_decode_nanoseconds / (double) m_completed;
+        }
+    };
+
+    /// Subtracts two snapshots, e.g. to get the counts between them
+    /// @param a The later snapshot
+    /// @param b The earlier snapshot
+    /// @return The difference of the counters
+    inline metrics_snapshot operator-(const metrics_snapshot &a,
+                                      const metrics_snapshot &b)
+    {
+        metrics_snapshot res;
+
+        assert(a.m_payloads >= b.m_payloads);
+        res.m_payloads = a.m_payloads - b.m_payloads;
+
+        assert(a.m_innovative >= b.m_innovative);
+        res.m_innovative = a.m_innovative - b.m_innovative;
+
+        assert(a.m_non_innovative >= b.m_non_innovative);
+        res.m_non_innovative = a.m_non_innovative - b.m_non_innovative;
+
+        assert(a.m_systematic >= b.m_systematic);
+        res.m_systematic = a.m_systematic - b.m_systematic;
+
+        assert(a.m_swaps >= b.m_swaps);
+        res.m_swaps = a.m_swaps - b.m_swaps;
+
+        assert(a.m_bytes >= b.m_bytes);
+        res.m_bytes = a.m_bytes - b.m_bytes;
+
+        assert(a.m_completed >= b.m_completed);
+        res.m_completed = a.m_completed - b.m_completed;
+
+        assert(a.m_decode_nanoseconds >= b.m_decode_nanoseconds);
+        res.m_decode_nanoseconds =
+            a.m_decode_nanoseconds - b.m_decode_nanoseconds;
+
+        return res;
+    }
+
+    /// Adds two snapshots, e.g. the counts of several coders
+    /// @param a The first snapshot
+    /// @param b The second snapshot
+    /// @return The sum of the counters
+    inline metrics_snapshot operator+(const metrics_snapshot &a,
+                                      const metrics_snapshot &b)
+    {
+        metrics_snapshot res;
+        res.m_payloads = a.m_payloads + b.m_payloads;
+        res.m_innovative = a.m_innovative + b.m_innovative;
+        res.m_non_innovative = a.m_non_innovative + b.m_non_innovative;
+        res.m_systematic = a.m_systematic + b.m_systematic;
+        res.m_swaps = a.m_swaps + b.m_swaps;
+        res.m_bytes = a.m_bytes + b.m_bytes;
+        res.m_completed = a.m_completed + b.m_completed;
+        res.m_decode_nanoseconds =
+            a.m_decode_nanoseconds + b.m_decode_nanoseconds;
+        return res;
+    }
+
+    /// @brief Counters of a coder or of all coders of a factory.
+    ///
+    /// Every counter is an atomic read with relaxed ordering, so another
+    /// thread can read the counters at any time without locking the
+    /// coders. The counters of a coder have a single writer which uses
+    /// increment(), a relaxed load and store without a locked
+    /// instruction. Counters shared by several threads use add(). The
+    /// totals of a factory, see metrics_registry, only grow, so a
+    /// monitoring thread computes rates from the difference of two
+    /// snapshots.
+    class coder_metrics : boost::noncopyable
+    {
+    public:
+
+        /// The counters
+        enum counter
+        {
+            payloads = 0,
+            innovative,
+            non_innovative,
+            systematic,
+            swaps,
+            bytes,
+            completed,
+            decode_nanoseconds,
+            counters
+        };
+
+    public:
+
+        /// Constructor
+        coder_metrics()
+        {
+            reset();
+        }
+
+        /// Increments a counter which may be updated by several threads
+        /// @param c The counter
+        /// @param value The increment
+        void add(counter c, uint64_t value = 1)
+        {
+            assert(c < counters);
+            m_counters[c].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /// Adds the values of a snapshot to the counters
+        /// @param s The values to add
+        void add(const metrics_snapshot &s)
+        {
+            add(payloads, s.m_payloads);
+            add(innovative, s.m_innovative);
+            add(non_innovative, s.m_non_innovative);
+            add(systematic, s.m_systematic);
+            add(swaps, s.m_swaps);
+            add(bytes, s.m_bytes);
+            add(completed, s.m_completed);
+            add(decode_nanoseconds, s.m_decode_nanoseconds);
+        }
+
+        /// Increments a counter only updated by the calling thread
+        /// @param c The counter
+        /// @param value The increment
+        void increment(counter c, uint64_t value = 1)
+        {
+            assert(c < counters);
+
+            uint64_t current = m_counters[c].load(std::memory_order_relaxed);
+            m_counters[c].store(current + value, std::memory_order_relaxed);
+        }
+
+        /// @param c The counter
+        /// @return The value of the counter
+        uint64_t value(counter c) const
+        {
+            assert(c < counters);
+            return m_counters[c].load(std::memory_order_relaxed);
+        }
+
+        /// Sets all counters to zero
+        void reset()
+        {
+            for(uint32_t i = 0; i < counters; ++i)
+            {
+                m_counters[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /// @return The current values of the counters. The counters are
+        ///         read one at a time, so a snapshot taken while the
+        ///         coders run may be off by the symbols in flight.
+        metrics_snapshot snapshot() const
+        {
+            metrics_snapshot s;
+            s.m_payloads = value(payloads);
+            s.m_innovative = value(innovative);
+            s.m_non_innovative = value(non_innovative);
+            s.m_systematic = value(systematic);
+            s.m_swaps = value(swaps);
+            s.m_bytes = value(bytes);
+            s.m_completed = value(completed);
+            s.m_decode_nanoseconds = value(decode_nanoseconds);
+            return s;
+        }
+
+        /// @return The steady clock in nanoseconds used for the decode
+        ///         time
+        static uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+
+        /// The counters
+        std::atomic<uint64_t> m_counters[counters];
+
+    };
+
+    /// @brief The totals of the coders built by a factory.
+    ///
+    /// The coders register their own coder_metrics while they exist and
+    /// keep writing them without locks. A snapshot sums the counts
+    /// retired by the coders with the current counts of the live
+    /// coders, so the totals include decodings in progress and coders
+    /// idle in the pool. Only registering, retiring and reading take
+    /// the lock, and retiring moves the counts of a coder to the retired
+    /// counts in one step, so the totals seen by a reader only grow.
+    class metrics_registry : boost::noncopyable
+    {
+    public:
+
+        /// Registers the counters of a coder
+        /// @param metrics The counters, written only by the coder
+        void attach(const coder_metrics *metrics)
+        {
+            assert(metrics != 0);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_live.push_back(metrics);
+        }
+
+        /// Adds the counters of a coder to the retired counts and
+        /// unregisters them, e.g. when the coder is destroyed
+        /// @param metrics The registered counters
+        void detach(const coder_metrics *metrics)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = std::find(m_live.begin(), m_live.end(), metrics);
+            assert(it != m_live.end());
+
+            m_retired.add(metrics->snapshot());
+
+            *it = m_live.back();
+            m_live.pop_back();
+        }
+
+        /// Adds the counters of a coder to the retired counts and resets
+        /// them, e.g. when the coder is initialized again
+        /// @param metrics The registered counters
+        void retire(coder_metrics &metrics)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_retired.add(metrics.snapshot());
+            metrics.reset();
+        }
+
+        /// @param c The counter
+        /// @return The total of the counter
+        uint64_t value(coder_metrics::counter c) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            uint64_t total = m_retired.value(c);
+
+            for(const coder_metrics *metrics : m_live)
+            {
+                total += metrics->value(c);
+            }
+
+            return total;
+        }
+
+        /// @return The totals of the counters. The counters of the live
+        ///         coders are read one at a time, so a snapshot taken
+        ///         while they run may be off by the symbols in flight.
+        metrics_snapshot snapshot() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            metrics_snapshot total = m_retired.snapshot();
+
+            for(const coder_metrics *metrics : m_live)
+            {
+                total = total + metrics->snapshot();
+            }
+
+            return total;
+        }
+
+        /// @return The number of registered coders
+        uint32_t live() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return (uint32_t) m_live.size();
+        }
+
+    private:
+
+        /// Protects the registered counters and the retired counts
+        mutable std::mutex m_mutex;
+
+        /// The counts of reset and destroyed coders
+        coder_metrics m_retired;
+
+        /// The counters of the coders which exist
+        std::vector<const coder_metrics*> m_live;
+
+    };
+
+}
@@ -0,0 +1,94 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup payload_codec_layers
+    /// @brief Reads the encoder rank written by the
+    ///        compact_payload_rank_encoder.
+    template<class SuperCoder>
+    class compact_payload_rank_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::rank_type
+        typedef typename SuperCoder::rank_type rank_type;
+
+    public:
+
+        /// The factory layer associated with this coder.
+        /// In this case only needed to provide the max_payload_size()
+        /// function.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::max_payload_size() const
+            uint32_t max_payload_size() const
+            {
+                return SuperCoder::factory::max_payload_size() +
+                    varint_size(SuperCoder::factory::max_symbols());
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_encoder_rank = 0;
+        }
+
+        /// @copydoc layer::decode(uint8_t*)
+        void decode(uint8_t* payload)
+        {
+            assert(payload != 0);
+
+            uint32_t encoder_rank = 0;
+            uint32_t read = read_varint(payload, &encoder_rank);
+
+            // We should never see an encoder which reduces its rank
+            assert(m_encoder_rank <= encoder_rank);
+            m_encoder_rank = encoder_rank;
+
+            SuperCoder::decode(payload + read);
+        }
+
+        /// @copydoc layer::payload_size() const
+        uint32_t payload_size() const
+        {
+            return SuperCoder::payload_size() +
+                varint_size(SuperCoder::symbols());
+        }
+
+        /// @return The rank of the encoder as read from the packet
+        rank_type encoder_rank() const
+        {
+            return m_encoder_rank;
+        }
+
+    private:
+
+        /// Stores the read encoder rank
+        rank_type m_encoder_rank;
+
+    };
+
+}
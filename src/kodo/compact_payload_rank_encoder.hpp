@@ -0,0 +1,71 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup payload_codec_layers
+    /// @brief Adds the rank of the encoder to the payload as a varint.
+    ///
+    /// Works like the payload_rank_encoder, but the rank only takes a
+    /// single byte for up to 127 symbols.
+    template<class SuperCoder>
+    class compact_payload_rank_encoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::rank_type
+        typedef typename SuperCoder::rank_type rank_type;
+
+    public:
+
+        /// The factory layer associated with this coder.
+        /// In this case only needed to provide the max_payload_size()
+        /// function.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::max_payload_size() const
+            uint32_t max_payload_size() const
+            {
+                return SuperCoder::factory::max_payload_size() +
+                    varint_size(SuperCoder::factory::max_symbols());
+            }
+
+        };
+
+    public:
+
+        /// @copydoc layer::encode(uint8_t*)
+        uint32_t encode(uint8_t* payload)
+        {
+            assert(payload != 0);
+
+            uint32_t written = write_varint(SuperCoder::rank(), payload);
+            return SuperCoder::encode(payload + written) + written;
+        }
+
+        /// @copydoc layer::payload_size() const
+        uint32_t payload_size() const
+        {
+            return SuperCoder::payload_size() +
+                varint_size(SuperCoder::symbols());
+        }
+
+    };
+
+}
@@ -0,0 +1,81 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    /// @brief Systematic decoding layer for the headers written by the
+    ///        compact_systematic_encoder.
+    template<class SuperCoder>
+    class compact_systematic_decoder : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::max_header_size() const
+            uint32_t max_header_size() const
+            {
+                return std::max(
+                    varint_size(SuperCoder::factory::max_symbols()),
+                    1 + SuperCoder::factory::max_header_size());
+            }
+        };
+
+    public:
+
+        /// Reads the varint in the symbol_header. If the symbol is
+        /// uncoded pass it directly to the Codec Layers otherwise pass
+        /// it to the next Codec Header Layer. Uncoded symbols with an
+        /// index beyond the block are dropped.
+        ///
+        /// @copydoc layer::decode(uint8_t*, uint8_t*)
+        void decode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            uint32_t value = 0;
+            uint32_t read = read_varint(symbol_header, &value);
+
+            if(value == 0)
+            {
+                SuperCoder::decode(symbol_data, symbol_header + read);
+            }
+            else if(value <= SuperCoder::symbols())
+            {
+                SuperCoder::decode_symbol(symbol_data, value - 1);
+            }
+
+            // Otherwise the index is out of range and the symbol of the
+            // corrupt packet is dropped
+        }
+
+        /// @copydoc layer::header_size() const
+        uint32_t header_size() const
+        {
+            return std::max(varint_size(SuperCoder::symbols()),
+                            1 + SuperCoder::header_size());
+        }
+    };
+
+}
@@ -0,0 +1,118 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include "systematic_encoder.hpp"
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    /// @brief Systematic encoding layer which packs the systematic flag
+    ///        and the symbol index into a single varint.
+    ///
+    /// A value of zero marks a coded symbol, otherwise the value is the
+    /// index of the uncoded symbol plus one. This makes the header of an
+    /// uncoded symbol one byte for up to 127 symbols, and the header of
+    /// a coded symbol one byte plus the symbol id. The systematic state
+    /// is kept by the SystematicEncoder layer which is reused for the
+    /// systematic API.
+    template<template <class> class SystematicEncoder, class SuperCoder>
+    class base_compact_systematic_encoder
+        : public SystematicEncoder<SuperCoder>
+    {
+    public:
+
+        /// The systematic encoder providing the systematic state
+        typedef SystematicEncoder<SuperCoder> Super;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public Super::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : Super::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::max_header_size() const
+            uint32_t max_header_size() const
+            {
+                return std::max(
+                    varint_size(SuperCoder::factory::max_symbols()),
+                    1 + SuperCoder::factory::max_header_size());
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::encode(uint8_t*, uint8_t*)
+        uint32_t encode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            bool in_systematic_phase =
+                m_systematic_count < SuperCoder::rank();
+
+            if(m_systematic && in_systematic_phase)
+            {
+                uint32_t written =
+                    write_varint(m_systematic_count + 1, symbol_header);
+
+                SuperCoder::encode_symbol(symbol_data, m_systematic_count);
+
+                ++m_systematic_count;
+
+                return written;
+            }
+            else
+            {
+                uint32_t written = write_varint(0, symbol_header);
+
+                return SuperCoder::encode(
+                    symbol_data, symbol_header + written) + written;
+            }
+        }
+
+        /// @copydoc layer::header_size() const
+        uint32_t header_size() const
+        {
+            return std::max(varint_size(SuperCoder::symbols()),
+                            1 + SuperCoder::header_size());
+        }
+
+    protected:
+
+        /// Access the systematic state of the systematic encoder
+        using Super::m_systematic;
+        using Super::m_systematic_count;
+
+    };
+
+    /// @copydoc base_compact_systematic_encoder
+    template<class SuperCoder>
+    class compact_systematic_encoder :
+        public base_compact_systematic_encoder<
+            systematic_encoder, SuperCoder>
+    { };
+
+    /// @copydoc base_compact_systematic_encoder
+    template<class SuperCoder>
+    class compact_non_systematic_encoder :
+        public base_compact_systematic_encoder<
+            non_systematic_encoder, SuperCoder>
+    { };
+
+}
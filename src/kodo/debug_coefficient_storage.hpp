@@ -18,6 +18,10 @@ namespace kodo
     /// @brief Print functions for coefficient storage
     ///
     /// This layer implements useful functions to print stored coefficients
+    ///
+    /// In a decoder the layer should be placed above the linear block
+    /// decoder, which writes the unit vectors of uncoded symbols only when
+    /// their coefficients are read through it.
     template<class SuperCoder>
     class debug_coefficient_storage : public SuperCoder
     {
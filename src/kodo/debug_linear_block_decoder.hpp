@@ -82,11 +82,20 @@ namespace kodo
                     out << std::setfill(' ') << std::setw(3) << i << " U:  ";
                 }
 
-                const value_type* c = SuperCoder::coefficients_value(i);
+                // The coefficients of an uncoded symbol are implicitly the
+                // unit vector of its pivot and may not be stored
+                bool uncoded = SuperCoder::symbol_pivot(i) &&
+                    !SuperCoder::symbol_coded(i);
+
+                const value_type* c = uncoded ?
+                    0 : SuperCoder::coefficients_value(i);
 
                 for(uint32_t j = 0; j < SuperCoder::symbols(); ++j)
                 {
-                    value_type value = fifi::get_value<field_type>(c, j);
+                    value_type value = uncoded ?
+                        value_type(i == j) :
+                        fifi::get_value<field_type>(c, j);
+
                     out << (uint32_t)value << " ";
                 }
 
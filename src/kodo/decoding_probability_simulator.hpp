@@ -0,0 +1,335 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/bernoulli_distribution.hpp>
+#include <boost/random/seed_seq.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "systematic_operations.hpp"
+
+namespace kodo
+{
+
+    /// @brief Monte-Carlo estimation of the decoding probability of a
+    ///        code.
+    ///
+    /// Every trial builds a decoder and feeds it coefficient vectors
+    /// produced by the generator of the encoder stack until it is
+    /// complete. The symbols carry a single field element, so the cost
+    /// of a trial is the elimination of the coefficients only. As in
+    /// the decoding_probability benchmark each transmitted symbol is
+    /// erased with a fixed probability and a systematic encoder first
+    /// sends the symbols uncoded.
+    ///
+    /// The trials are split across threads, each with its own
+    /// factories and random generator seeded from the common seed and
+    /// the thread index. The result of a run is therefore
+    /// reproducible for a given seed and number of threads.
+    ///
+    /// @tparam Encoder The encoder stack providing the generator
+    /// @tparam Decoder The decoder stack under test
+    template<class Encoder, class Decoder>
+    class decoding_probability_simulator
+    {
+    public:
+
+        /// Pointer to an encoder
+        typedef typename Encoder::pointer encoder_pointer;
+
+        /// Pointer to a decoder
+        typedef typename Decoder::pointer decoder_pointer;
+
+        /// Callback configuring the encoders of a thread, e.g. setting
+        /// the density of a sparse generator
+        typedef std::function<void (encoder_pointer&)> encoder_setup;
+
+        /// The outcome of a number of trials
+        struct result
+        {
+            /// Constructor
+            result()
+                : m_trials(0),
+                  m_transmitted(0)
+            { }
+
+            /// Adds the counts of another result
+            /// @param other The result to add
+            void merge(const result &other)
+            {
+                m_trials += other.m_trials;
+                m_transmitted += other.m_transmitted;
+
+                if(other.m_used.size() > m_used.size())
+                {
+                    m_used.resize(other.m_used.size(), 0);
+                }
+
+                for(uint32_t i = 0; i < other.m_used.size(); ++i)
+                {
+                    m_used[i] += other.m_used[i];
+                }
+
+                if(other.m_rank_used.size() > m_rank_used.size())
+                {
+                    m_rank_used.resize(other.m_rank_used.size(), 0);
+                }
+
+                for(uint32_t i = 0; i < other.m_rank_used.size(); ++i)
+                {
+                    m_rank_used[i] += other.m_rank_used[i];
+                }
+            }
+
+            /// @param received The number of received symbols
+            /// @return The fraction of the trials which decoded with at
+            ///         most the given number of received symbols
+            double decoding_probability(uint32_t received) const
+            {
+                if(m_trials == 0)
+                {
+                    return 0.0;
+                }
+
+                uint64_t decoded = 0;
+
+                for(uint32_t i = 0; i < m_used.size() && i <= received; ++i)
+                {
+                    decoded += m_used[i];
+                }
+
+                return decoded / (double) m_trials;
+            }
+
+            /// @return The average number of received symbols needed to
+            ///         decode
+            double average_used() const
+            {
+                if(m_trials == 0)
+                {
+                    return 0.0;
+                }
+
+                uint64_t total = 0;
+
+                for(uint32_t i = 0; i < m_used.size(); ++i)
+                {
+                    total += i * m_used[i];
+                }
+
+                return total / (double) m_trials;
+            }
+
+            /// The number of trials
+            uint64_t m_trials;
+
+            /// The number of transmitted symbols including the erased
+            uint64_t m_transmitted;
+
+            /// The number of trials indexed by the number of received
+            /// symbols needed to decode
+            std::vector<uint64_t> m_used;
+
+            /// The number of received symbols indexed by the rank of the
+            /// decoder when they were received
+            std::vector<uint64_t> m_rank_used;
+        };
+
+    public:
+
+        /// Constructor
+        /// @param symbols The number of symbols in a block
+        decoding_probability_simulator(uint32_t symbols)
+            : m_symbols(symbols),
+              m_erasure(0.0),
+              m_systematic(true),
+              m_seed(0),
+              m_threads(std::max(1U, std::thread::hardware_concurrency()))
+        {
+            assert(m_symbols > 0);
+        }
+
+        /// @param erasure The probability that a symbol is erased
+        void set_erasure(double erasure)
+        {
+            assert(erasure >= 0.0);
+            assert(erasure < 1.0);
+            m_erasure = erasure;
+        }
+
+        /// @param systematic True if a systematic encoder should send the
+        ///        symbols uncoded first
+        void set_systematic(bool systematic)
+        {
+            m_systematic = systematic;
+        }
+
+        /// @param seed The seed of the random generators
+        void set_seed(uint32_t seed)
+        {
+            m_seed = seed;
+        }
+
+        /// @param threads The number of threads running the trials
+        void set_threads(uint32_t threads)
+        {
+            assert(threads > 0);
+            m_threads = threads;
+        }
+
+        /// @param setup Invoked with every encoder before it is used
+        void set_encoder_setup(const encoder_setup &setup)
+        {
+            m_encoder_setup = setup;
+        }
+
+        /// @return The number of threads running the trials
+        uint32_t threads() const
+        {
+            return m_threads;
+        }
+
+        /// Runs the trials
+        /// @param trials The number of trials
+        /// @return The accumulated result
+        result run(uint64_t trials) const
+        {
+            std::vector<result> results(m_threads);
+            std::vector<std::thread> workers;
+
+            for(uint32_t i = 0; i < m_threads; ++i)
+            {
+                uint64_t count = trials / m_threads +
+                    (i < trials % m_threads ? 1 : 0);
+
+                workers.push_back(std::thread(
+                    &decoding_probability_simulator::run_thread, this,
+                    i, count, std::ref(results[i])));
+            }
+
+            result total;
+
+            for(uint32_t i = 0; i < m_threads; ++i)
+            {
+                workers[i].join();
+                total.merge(results[i]);
+            }
+
+            return total;
+        }
+
+    private:
+
+        /// Runs the trials of one thread
+        /// @param thread The index of the thread
+        /// @param trials The number of trials to run
+        /// @param out The result of the thread
+        void run_thread(uint32_t thread, uint64_t trials, result &out) const
+        {
+            typedef typename Decoder::value_type value_type;
+
+            // A symbol holds a single field element
+            const uint32_t symbol_size = sizeof(value_type);
+
+            typename Encoder::factory encoder_factory(m_symbols, symbol_size);
+            typename Decoder::factory decoder_factory(m_symbols, symbol_size);
+
+            boost::random::seed_seq sequence = { m_seed, thread };
+            boost::random::mt19937 generator(sequence);
+            boost::random::bernoulli_distribution<> erased(m_erasure);
+
+            encoder_pointer encoder = encoder_factory.build();
+
+            if(m_encoder_setup)
+            {
+                m_encoder_setup(encoder);
+            }
+
+            bool systematic =
+                m_systematic && kodo::is_systematic_encoder(encoder);
+
+            std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+                coefficients(encoder->coefficients_size());
+
+            std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+                symbol(symbol_size);
+
+            out.m_rank_used.resize(m_symbols, 0);
+
+            for(uint64_t trial = 0; trial < trials; ++trial)
+            {
+                decoder_pointer decoder = decoder_factory.build();
+                encoder->seed(generator());
+
+                uint32_t transmitted = 0;
+                uint32_t used = 0;
+
+                while(!decoder->is_complete())
+                {
+                    uint32_t index = transmitted++;
+
+                    if(erased(generator))
+                    {
+                        continue;
+                    }
+
+                    ++used;
+                    ++out.m_rank_used[decoder->rank()];
+
+                    if(systematic && index < m_symbols)
+                    {
+                        decoder->decode_symbol(&symbol[0], index);
+                    }
+                    else
+                    {
+                        encoder->generate(&coefficients[0]);
+                        decoder->decode_symbol(&symbol[0], &coefficients[0]);
+                    }
+                }
+
+                if(used >= out.m_used.size())
+                {
+                    out.m_used.resize(used + 1, 0);
+                }
+
+                ++out.m_used[used];
+                ++out.m_trials;
+                out.m_transmitted += transmitted;
+            }
+        }
+
+    private:
+
+        /// The number of symbols in a block
+        uint32_t m_symbols;
+
+        /// The erasure probability
+        double m_erasure;
+
+        /// Whether systematic encoders send the symbols uncoded first
+        bool m_systematic;
+
+        /// The seed of the random generators
+        uint32_t m_seed;
+
+        /// The number of threads
+        uint32_t m_threads;
+
+        /// Configures the encoders
+        encoder_setup m_encoder_setup;
+
+    };
+
+}
@@ -6,15 +6,25 @@
 #pragma once
 
 #include <cstdint>
+#include <cassert>
+#include <vector>
 
 #include "operations_counter.hpp"
+#include "operations_phase.hpp"
 
 namespace kodo
 {
 
     /// @ingroup debug
     /// This layer "intercepts" all calls to the finite_field_math
-    /// layer counting the different operations
+    /// layer counting the different operations and the number of bytes
+    /// they process.
+    ///
+    /// Operations inside an operations_region::coefficients region
+    /// marked by the codec layers are counted as coefficient vector work
+    /// and all other operations as payload work, independent of their
+    /// length. The bytes are also attributed to the outermost
+    /// operations_phase marked by the codec layers.
     template<class SuperCoder>
     class finite_field_counter : public SuperCoder
     {
@@ -31,6 +41,13 @@ namespace kodo
 
     public:
 
+        /// Constructor
+        finite_field_counter()
+            : m_region(operations_region::payload),
+              m_phase(operations_phase::other),
+              m_phase_depth(0)
+        { }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
@@ -39,6 +56,20 @@ namespace kodo
 
             // Reset the counter
             m_counter = operations_counter();
+
+            m_region = operations_region::payload;
+            m_regions.clear();
+
+            m_phase = operations_phase::other;
+            m_phase_depth = 0;
+        }
+
+        /// The counters are updated without synchronization, so the
+        /// operations of a counted coder must not run concurrently.
+        /// @copydoc layer::is_concurrent_safe() const
+        bool is_concurrent_safe() const
+        {
+            return false;
         }
 
         /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
@@ -46,6 +77,8 @@ namespace kodo
                       uint32_t symbol_length)
         {
             ++m_counter.m_multiply;
+            count_bytes(&operations_bytes::m_multiply, symbol_length);
+
             SuperCoder::multiply(symbol_dest, coefficient, symbol_length);
         }
 
@@ -56,6 +89,8 @@ namespace kodo
                           value_type coefficient, uint32_t symbol_length)
         {
             ++m_counter.m_multiply_add;
+            count_bytes(&operations_bytes::m_multiply_add, symbol_length);
+
             SuperCoder::multiply_add(symbol_dest, symbol_src,
                                      coefficient,
                                      symbol_length);
@@ -66,6 +101,8 @@ namespace kodo
                  uint32_t symbol_length)
         {
             ++m_counter.m_add;
+            count_bytes(&operations_bytes::m_add, symbol_length);
+
             SuperCoder::add(symbol_dest, symbol_src, symbol_length);
         }
 
@@ -78,6 +115,8 @@ namespace kodo
                                uint32_t symbol_length)
         {
             ++m_counter.m_multiply_subtract;
+            count_bytes(&operations_bytes::m_multiply_subtract, symbol_length);
+
             SuperCoder::multiply_subtract(symbol_dest, symbol_src,
                                           coefficient, symbol_length);
         }
@@ -88,6 +127,8 @@ namespace kodo
                       uint32_t symbol_length)
         {
             ++m_counter.m_subtract;
+            count_bytes(&operations_bytes::m_subtract, symbol_length);
+
             SuperCoder::subtract(symbol_dest, symbol_src,
                                  symbol_length);
         }
@@ -111,11 +152,89 @@ namespace kodo
             m_counter = operations_counter();
         }
 
+        /// Marks the beginning of a phase. Phases may be nested in which
+        /// case the operations are attributed to the outermost phase.
+        /// @param phase The phase
+        void push_operations_phase(operations_phase phase)
+        {
+            if(m_phase_depth == 0)
+            {
+                m_phase = phase;
+            }
+
+            ++m_phase_depth;
+        }
+
+        /// Marks the end of the most recently pushed phase
+        void pop_operations_phase()
+        {
+            assert(m_phase_depth > 0);
+            --m_phase_depth;
+
+            if(m_phase_depth == 0)
+            {
+                m_phase = operations_phase::other;
+            }
+        }
+
+        /// Marks the beginning of operations on a region of data. Regions
+        /// may be nested in which case the innermost region applies.
+        /// @param region The region
+        void push_operations_region(operations_region region)
+        {
+            m_regions.push_back(m_region);
+            m_region = region;
+        }
+
+        /// Marks the end of the most recently pushed region
+        void pop_operations_region()
+        {
+            assert(!m_regions.empty());
+
+            m_region = m_regions.back();
+            m_regions.pop_back();
+        }
+
+    protected:
+
+        /// Counts the bytes processed by an operation
+        /// @param operation The byte counter of the operation
+        /// @param symbol_length The length of the operation
+        void count_bytes(uint64_t operations_bytes::*operation,
+                         uint32_t symbol_length)
+        {
+            uint64_t bytes = uint64_t(symbol_length) * sizeof(value_type);
+            uint32_t phase = static_cast<uint32_t>(m_phase);
+
+            if(m_region == operations_region::payload)
+            {
+                m_counter.m_payload_bytes.*operation += bytes;
+                m_counter.m_phase_payload_bytes[phase] += bytes;
+            }
+            else
+            {
+                m_counter.m_coefficient_bytes.*operation += bytes;
+                m_counter.m_phase_coefficient_bytes[phase] += bytes;
+            }
+        }
+
     private:
 
         /// Operations counter
         operations_counter m_counter;
 
+        /// The region the operations work on
+        operations_region m_region;
+
+        /// The regions enclosing the current region
+        std::vector<operations_region> m_regions;
+
+        /// The phase the operations are attributed to
+        operations_phase m_phase;
+
+        /// The number of phases currently pushed
+        uint32_t m_phase_depth;
+
     };
 
 }
@@ -11,11 +11,20 @@
 #include <fifi/arithmetics.hpp>
 #include <fifi/fifi_utils.hpp>
 
+#include "operations_phase.hpp"
+#include "region_kernels.hpp"
+
 namespace kodo
 {
 
     /// @ingroup finite_field_layers
     /// @brief Basic layer performing common finite field operation
+    ///
+    /// For the binary extension fields the factory selects, based on the
+    /// instruction sets reported by the CPU, the widest region_kernels
+    /// implementation available. The selection happens at run-time so
+    /// the same binary runs the best kernel on every CPU. Fields without
+    /// region kernels use the Fifi implementation.
     template<class FieldImpl, class SuperCoder>
     class finite_field_math : public SuperCoder
     {
@@ -36,6 +45,12 @@ namespace kodo
         /// Pointer to coder produced by the factories
         typedef typename SuperCoder::pointer pointer;
 
+        /// The region kernels used for the field
+        typedef region_kernels<field_type> kernels_type;
+
+        /// Pointer to the region kernels
+        typedef boost::shared_ptr<const kernels_type> kernels_pointer;
+
     private:
 
         /// The field type of the finite field implementation
@@ -59,6 +74,35 @@ namespace kodo
                 SuperCoder::factory(max_symbols, max_symbol_size)
             {
                 m_field = boost::make_shared<field_impl>();
+
+                set_region_kernel(kernels_type::best_kernel());
+            }
+
+            /// Selects the region kernel used by coders built after this
+            /// call. This is mostly useful for benchmarks comparing the
+            /// kernels, by default the widest supported kernel is used.
+            /// @param kernel The region kernel, must be supported by the
+            ///        field and the CPU see is_region_kernel_supported()
+            void set_region_kernel(region_kernel kernel)
+            {
+                assert(is_region_kernel_supported(kernel));
+
+                m_kernels =
+                    boost::make_shared<const kernels_type>(*m_field, kernel);
+            }
+
+            /// @param kernel The region kernel
+            /// @return true if the kernel may be selected
+            bool is_region_kernel_supported(region_kernel kernel) const
+            {
+                return kernels_type::is_supported(kernel);
+            }
+
+            /// @return The region kernel used by the coders
+            region_kernel selected_region_kernel() const
+            {
+                assert(m_kernels);
+                return m_kernels->kernel();
             }
 
         private:
@@ -72,10 +116,19 @@ namespace kodo
                 return m_field;
             }
 
+            /// @return The region kernels used.
+            kernels_pointer kernels()
+            {
+                return m_kernels;
+            }
+
         protected:
 
             /// The field implementation
             field_pointer m_field;
+
+            /// The region kernels
+            kernels_pointer m_kernels;
         };
 
     public:
@@ -104,6 +157,33 @@ namespace kodo
             m_field = the_factory.field();
         }
 
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            // The kernel may have been changed since construction
+            m_kernels = the_factory.kernels();
+            assert(m_kernels);
+        }
+
+        /// @return The region kernel used by this coder
+        region_kernel selected_region_kernel() const
+        {
+            assert(m_kernels);
+            return m_kernels->kernel();
+        }
+
+        /// The Fifi implementation of multiply_add() and
+        /// multiply_subtract() uses the temporary buffer of the coder, so
+        /// only the region kernels may be invoked concurrently.
+        /// @copydoc layer::is_concurrent_safe() const
+        bool is_concurrent_safe() const
+        {
+            return selected_region_kernel() != region_kernel::scalar;
+        }
+
         /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
         void multiply(value_type *symbol_dest, value_type coefficient,
                       uint32_t symbol_length)
@@ -112,6 +192,13 @@ namespace kodo
             assert(symbol_dest != 0);
             assert(symbol_length > 0);
 
+            if(m_kernels->is_accelerated())
+            {
+                m_kernels->multiply(*m_field, symbol_dest, coefficient,
+                                    symbol_length);
+                return;
+            }
+
             fifi::multiply_constant(*m_field, coefficient,
                                     symbol_dest, symbol_length);
         }
@@ -127,6 +214,13 @@ namespace kodo
             assert(symbol_src != 0);
             assert(symbol_length > 0);
 
+            if(m_kernels->is_accelerated())
+            {
+                m_kernels->multiply_add(*m_field, symbol_dest, symbol_src,
+                                        coefficient, symbol_length);
+                return;
+            }
+
             fifi::multiply_add(*m_field, coefficient, symbol_dest,
                                symbol_src, &m_temp_symbol[0],
                                symbol_length);
@@ -141,6 +235,12 @@ namespace kodo
             assert(symbol_src  != 0);
             assert(symbol_length > 0);
 
+            if(m_kernels->is_accelerated())
+            {
+                m_kernels->add(symbol_dest, symbol_src, symbol_length);
+                return;
+            }
+
             fifi::add(*m_field, symbol_dest, symbol_src, symbol_length);
         }
 
@@ -158,6 +258,15 @@ namespace kodo
             assert(symbol_length <= m_temp_symbol.size());
             assert(symbol_dest != symbol_src);
 
+            // The region kernels are only provided for binary extension
+            // fields where subtraction equals addition
+            if(m_kernels->is_accelerated())
+            {
+                m_kernels->multiply_add(*m_field, symbol_dest, symbol_src,
+                                        coefficient, symbol_length);
+                return;
+            }
+
             fifi::multiply_subtract(
                 *m_field, coefficient, symbol_dest, symbol_src,
                 &m_temp_symbol[0], symbol_length);
@@ -172,6 +281,12 @@ namespace kodo
             assert(symbol_src  != 0);
             assert(symbol_length > 0);
 
+            if(m_kernels->is_accelerated())
+            {
+                m_kernels->add(symbol_dest, symbol_src, symbol_length);
+                return;
+            }
+
             fifi::subtract(*m_field, symbol_dest, symbol_src, symbol_length);
         }
 
@@ -182,11 +297,38 @@ namespace kodo
             return m_field->invert( value );
         }
 
+        /// Marks the beginning of a phase of the coding algorithm. The
+        /// phases are only used by the finite_field_counter layer.
+        /// @param phase The phase
+        void push_operations_phase(operations_phase phase)
+        {
+            (void) phase;
+        }
+
+        /// Marks the end of the most recently pushed phase
+        void pop_operations_phase()
+        { }
+
+        /// Marks the beginning of operations on a region of data. The
+        /// regions are only used by the finite_field_counter layer.
+        /// @param region The region
+        void push_operations_region(operations_region region)
+        {
+            (void) region;
+        }
+
+        /// Marks the end of the most recently pushed region
+        void pop_operations_region()
+        { }
+
     private:
 
         /// The selected field
         field_pointer m_field;
 
+        /// The selected region kernels
+        kernels_pointer m_kernels;
+
         /// Temp. symbol used in various compound operations
         std::vector<value_type> m_temp_symbol;
 
@@ -0,0 +1,168 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <sak/aligned_allocator.hpp>
+#include <sak/storage.hpp>
+
+#include "fulcrum_expansion_info.hpp"
+#include "is_binary_extension_field.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup storage_layers
+    /// @brief Computes the outer code symbols of a fulcrum encoder.
+    ///
+    /// The first source_symbols() symbols of the block are the source
+    /// symbols set by the user. The remaining expansion() symbols are
+    /// computed by the OuterStack, an encoder over the outer field
+    /// working directly on the source symbols. The coding vectors of the
+    /// outer code are produced by the generator of the OuterStack seeded
+    /// with the fulcrum_outer_seed, such that decoders can reproduce
+    /// them. The layers below this one then code over all symbols of
+    /// the expanded block using the inner field. The source symbols
+    /// must therefore be specified using set_symbols().
+    ///
+    /// @tparam OuterStack The outer encoder. It must use const shallow
+    ///         symbol storage and provide the seed() and generate()
+    ///         functions of a coefficient generator.
+    template<class OuterStack, class SuperCoder>
+    class fulcrum_expansion_encoder : public SuperCoder
+    {
+    public:
+
+        /// Pointer to the outer encoder
+        typedef typename OuterStack::pointer outer_pointer;
+
+        /// The inner code combines the outer symbols with binary
+        /// coefficients, i.e. XOR, which only matches the outer code if
+        /// the addition of the outer field is XOR
+        static_assert(
+            is_binary_extension_field<typename OuterStack::field_type>::value,
+            "The outer field of a fulcrum code must be a binary "
+            "extension field");
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_outer_factory(max_symbols, max_symbol_size)
+            { }
+
+        private:
+
+            /// Give the layer access
+            friend class fulcrum_expansion_encoder;
+
+            /// @return A reference to the outer encoder factory
+            typename OuterStack::factory& outer_factory()
+            {
+                return m_outer_factory;
+            }
+
+        private:
+
+            /// The factory building the outer encoders
+            typename OuterStack::factory m_outer_factory;
+
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            auto& outer_factory = the_factory.outer_factory();
+            m_outer_coefficients.resize(
+                outer_factory.max_coefficients_size());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            auto& outer_factory = the_factory.outer_factory();
+            outer_factory.set_symbols(SuperCoder::source_symbols());
+            outer_factory.set_symbol_size(SuperCoder::symbol_size());
+
+            // Release the previous outer encoder before building a new
+            // one, so that the pool can reuse it
+            m_outer.reset();
+            m_outer = outer_factory.build();
+        }
+
+        /// Sets the source symbols and computes the outer code symbols
+        /// @copydoc layer::set_symbols(const sak::const_storage&)
+        void set_symbols(const sak::const_storage &symbol_storage)
+        {
+            assert(symbol_storage.m_size <= SuperCoder::source_block_size());
+
+            SuperCoder::set_symbols(symbol_storage);
+            expand();
+        }
+
+        /// @return The outer encoder used to compute the outer symbols
+        const outer_pointer& outer_encoder() const
+        {
+            return m_outer;
+        }
+
+    protected:
+
+        /// Computes the expansion() outer code symbols from the source
+        /// symbols
+        void expand()
+        {
+            assert(m_outer);
+
+            uint32_t source_symbols = SuperCoder::source_symbols();
+
+            const uint8_t *source = SuperCoder::symbol(0);
+            m_outer->set_symbols(
+                sak::storage(source, SuperCoder::source_block_size()));
+
+            m_outer->seed(fulcrum_outer_seed);
+
+            for(uint32_t i = 0; i < SuperCoder::expansion(); ++i)
+            {
+                m_outer->generate(&m_outer_coefficients[0]);
+                m_outer->encode_symbol(
+                    SuperCoder::symbol(source_symbols + i),
+                    &m_outer_coefficients[0]);
+            }
+        }
+
+    protected:
+
+        /// The storage type
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// The outer encoder
+        outer_pointer m_outer;
+
+        /// Buffer for the coding vectors of the outer code
+        aligned_vector m_outer_coefficients;
+
+    };
+
+}
@@ -0,0 +1,88 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+namespace kodo
+{
+
+    /// The seed used to generate the outer code of the fulcrum codes.
+    /// Encoders and outer decoders must agree on the outer code, so the
+    /// seed is fixed rather than transmitted.
+    const uint32_t fulcrum_outer_seed = 0x46554c43;
+
+    /// @ingroup storage_layers
+    /// @brief Maps the number of source symbols to the number of
+    ///        expanded symbols used by the inner code of a fulcrum code.
+    ///
+    /// The factory constructor and set_symbols() take the number of
+    /// source symbols k, whereas all layers below this one operate on
+    /// the k + Expansion symbols of the expanded block. Hence symbols()
+    /// and max_symbols() report the expanded number of symbols and
+    /// source_symbols() the number of source symbols.
+    ///
+    /// @tparam Expansion The number of outer code symbols added to the
+    ///         source symbols
+    template<uint32_t Expansion, class SuperCoder>
+    class fulcrum_expansion_info : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols + Expansion,
+                                      max_symbol_size)
+            { }
+
+            /// Sets the number of source symbols
+            /// @copydoc layer::factory::set_symbols(uint32_t)
+            void set_symbols(uint32_t symbols)
+            {
+                SuperCoder::factory::set_symbols(symbols + Expansion);
+            }
+
+            /// @return The maximum number of source symbols
+            uint32_t max_source_symbols() const
+            {
+                return SuperCoder::factory::max_symbols() - Expansion;
+            }
+
+            /// @return The number of source symbols
+            uint32_t source_symbols() const
+            {
+                return SuperCoder::factory::symbols() - Expansion;
+            }
+        };
+
+    public:
+
+        /// @return The number of source symbols
+        uint32_t source_symbols() const
+        {
+            return SuperCoder::symbols() - Expansion;
+        }
+
+        /// @return The size in bytes of the source symbols
+        uint32_t source_block_size() const
+        {
+            return source_symbols() * SuperCoder::symbol_size();
+        }
+
+        /// @return The number of outer code symbols
+        static uint32_t expansion()
+        {
+            return Expansion;
+        }
+    };
+
+}
@@ -0,0 +1,244 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <fifi/fifi_utils.hpp>
+#include <fifi/field_types.hpp>
+
+#include <sak/aligned_allocator.hpp>
+#include <sak/convert_endian.hpp>
+
+#include "fulcrum_expansion_info.hpp"
+#include "is_binary_extension_field.hpp"
+#include "operations_phase.hpp"
+#include "systematic_base_coder.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    /// @brief Decodes the inner code headers of a fulcrum encoder using
+    ///        the outer code.
+    ///
+    /// The layer reads the systematic header and the binary coding
+    /// vector over the k + Expansion expanded symbols written by the
+    /// fulcrum encoder, and maps them to a coding vector over the k
+    /// source symbols in the outer field. An expanded symbol k + j
+    /// corresponds to row j of the outer code, which is regenerated at
+    /// initialization using the generator of this stack seeded with the
+    /// fulcrum_outer_seed. The layers below therefore only see the k
+    /// source symbols, which allows decoding as soon as k linearly
+    /// independent combinations have been received in the outer field.
+    ///
+    /// @tparam Expansion The number of outer code symbols added by the
+    ///         encoder
+    template<uint32_t Expansion, class SuperCoder>
+    class fulcrum_outer_header_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+        /// The binary inner code vectors are mapped to the outer code
+        /// by adding rows, which is only valid if the addition of the
+        /// outer field is XOR
+        static_assert(is_binary_extension_field<field_type>::value,
+                      "The outer field of a fulcrum code must be a "
+                      "binary extension field");
+
+        /// The symbol count type
+        typedef typename systematic_base_coder::counter_type
+            counter_type;
+
+        /// The flag type
+        typedef typename systematic_base_coder::flag_type
+            flag_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::max_header_size() const
+            uint32_t max_header_size() const
+            {
+                return sizeof(flag_type) + sizeof(counter_type) +
+                    fifi::elements_to_size<fifi::binary>(
+                        SuperCoder::factory::max_symbols() + Expansion);
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            uint32_t max_coefficients_size =
+                the_factory.max_coefficients_size();
+
+            m_outer_code.resize(Expansion * max_coefficients_size);
+            m_coefficients.resize(max_coefficients_size);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_inner_size = fifi::elements_to_size<fifi::binary>(
+                SuperCoder::symbols() + Expansion);
+
+            // Regenerate the outer code used by the encoder
+            SuperCoder::seed(fulcrum_outer_seed);
+
+            for(uint32_t i = 0; i < Expansion; ++i)
+            {
+                SuperCoder::generate(outer_coefficients(i));
+            }
+        }
+
+        /// Maps the inner code header to a coding vector of the outer
+        /// code and passes the symbol to the Codec Layers.
+        ///
+        /// @copydoc layer::decode(uint8_t*, uint8_t*)
+        void decode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            flag_type flag =
+                sak::big_endian::get<flag_type>(symbol_header);
+
+            symbol_header += sizeof(flag_type);
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            if(flag == systematic_base_coder::systematic_flag)
+            {
+                counter_type symbol_index =
+                    sak::big_endian::get<counter_type>(symbol_header);
+
+                assert(symbol_index < symbols + Expansion);
+
+                if(symbol_index < symbols)
+                {
+                    SuperCoder::decode_symbol(symbol_data, symbol_index);
+                    return;
+                }
+
+                // The decoder modifies the coefficients in place, so
+                // the outer code row is copied first
+                std::copy_n(outer_coefficients(symbol_index - symbols),
+                            SuperCoder::coefficients_size(),
+                            &m_coefficients[0]);
+            }
+            else
+            {
+                map_coefficients(symbol_header);
+            }
+
+            SuperCoder::decode_symbol(symbol_data, &m_coefficients[0]);
+        }
+
+        /// @copydoc layer::header_size() const
+        uint32_t header_size() const
+        {
+            return sizeof(flag_type) + sizeof(counter_type) +
+                m_inner_size;
+        }
+
+    protected:
+
+        /// Maps an inner coding vector over the expanded symbols to a
+        /// coding vector over the source symbols stored in
+        /// m_coefficients.
+        /// @param inner The binary coding vector of the inner code
+        void map_coefficients(const uint8_t *inner)
+        {
+            assert(inner != 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            std::fill(m_coefficients.begin(), m_coefficients.end(), 0);
+
+            value_type *coefficients =
+                reinterpret_cast<value_type*>(&m_coefficients[0]);
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(fifi::get_value<fifi::binary>(inner, i))
+                {
+                    fifi::set_value<field_type>(coefficients, i, 1U);
+                }
+            }
+
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            for(uint32_t i = 0; i < Expansion; ++i)
+            {
+                if(!fifi::get_value<fifi::binary>(inner, symbols + i))
+                {
+                    continue;
+                }
+
+                const value_type *row =
+                    reinterpret_cast<const value_type*>(
+                        outer_coefficients(i));
+
+                SuperCoder::add(coefficients, row,
+                                SuperCoder::coefficients_length());
+            }
+
+            SuperCoder::pop_operations_region();
+        }
+
+        /// @param index The index of the outer code symbol
+        /// @return The coding vector of the outer code symbol
+        uint8_t* outer_coefficients(uint32_t index)
+        {
+            assert(index < Expansion);
+            return &m_outer_code[index * SuperCoder::coefficients_size()];
+        }
+
+    protected:
+
+        /// The storage type
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// The coding vectors of the outer code symbols
+        aligned_vector m_outer_code;
+
+        /// Buffer for the mapped coding vector
+        aligned_vector m_coefficients;
+
+        /// The size of the binary inner coding vectors
+        uint32_t m_inner_size;
+
+    };
+
+}
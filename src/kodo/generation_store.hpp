@@ -0,0 +1,164 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+namespace kodo
+{
+
+    /// @brief Thread-safe store of read-only generations shared by many
+    ///        encoders.
+    ///
+    /// A generation is the data of one block of an object, keyed by an
+    /// object id and a block id. The store only keeps weak references, a
+    /// generation lives as long as an encoder (or the application) holds
+    /// the pointer returned by load(). Encoders attach to the data
+    /// through the shared_symbol_storage layer, so serving one object to
+    /// many sessions keeps a single copy of each block in memory.
+    class generation_store : boost::noncopyable
+    {
+    public:
+
+        /// The storage of one generation
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            generation;
+
+        /// Pointer to an immutable generation
+        typedef boost::shared_ptr<const generation> generation_pointer;
+
+    public:
+
+        /// Constructor
+        generation_store()
+            : m_prune_size(16)
+        { }
+
+        /// @param object_id The object
+        /// @param block_id The block within the object
+        /// @return The generation if it is loaded, otherwise an empty
+        ///         pointer
+        generation_pointer find(uint32_t object_id, uint32_t block_id)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_generations.find(std::make_pair(object_id, block_id));
+
+            if(it == m_generations.end())
+            {
+                return generation_pointer();
+            }
+
+            return it->second.lock();
+        }
+
+        /// Returns a loaded generation or loads it. The loader runs
+        /// without holding the lock, if two threads load the same
+        /// generation concurrently the first one stored is used.
+        ///
+        /// @param object_id The object
+        /// @param block_id The block within the object
+        /// @param size The size of the generation in bytes
+        /// @param loader Invoked as loader(uint8_t *data) to fill a new
+        ///        zero initialized generation
+        /// @return The generation
+        template<class Loader>
+        generation_pointer load(uint32_t object_id, uint32_t block_id,
+                                uint32_t size, const Loader &loader)
+        {
+            assert(size > 0);
+
+            generation_pointer existing = find(object_id, block_id);
+
+            if(existing)
+            {
+                assert(existing->size() == size);
+                return existing;
+            }
+
+            auto data = boost::make_shared<generation>(size, 0);
+            loader(&(*data)[0]);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            boost::weak_ptr<const generation> &entry =
+                m_generations[std::make_pair(object_id, block_id)];
+
+            existing = entry.lock();
+
+            if(existing)
+            {
+                return existing;
+            }
+
+            entry = data;
+
+            if(m_generations.size() >= m_prune_size)
+            {
+                prune();
+            }
+
+            return data;
+        }
+
+        /// @return The number of generations currently in memory
+        uint32_t generations()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            prune();
+            return (uint32_t) m_generations.size();
+        }
+
+    private:
+
+        /// Removes the entries of released generations. Called when the
+        /// map has doubled since the last pass, so the cost is amortised
+        /// over the insertions.
+        void prune()
+        {
+            for(auto it = m_generations.begin(); it != m_generations.end(); )
+            {
+                if(it->second.expired())
+                {
+                    it = m_generations.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            m_prune_size = 2 * (uint32_t) m_generations.size() + 16;
+        }
+
+    private:
+
+        /// Protects the map
+        std::mutex m_mutex;
+
+        /// The map size triggering the next prune()
+        uint32_t m_prune_size;
+
+        /// The generations keyed by object and block id
+        std::map<std::pair<uint32_t, uint32_t>,
+                 boost::weak_ptr<const generation> > m_generations;
+
+    };
+
+}
@@ -0,0 +1,109 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sak/storage.hpp>
+
+#include "generation_store.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup object_data_implementation
+    ///
+    /// @brief Initializes encoders with generations of a generation_store
+    ///        which are loaded from a memory buffer on first use. This
+    ///        class can be used in conjunction with object encoders.
+    ///
+    /// All object encoders serving the same object id through the same
+    /// store share one copy of each block. Blocks are identified by their
+    /// byte offset in the object. The encoders must use the
+    /// shared_symbol_storage layer, e.g. the shared_full_rlnc_encoder.
+    ///
+    /// As for the storage_reader the caller must ensure that the memory
+    /// buffer remains valid throughout the life-time of the reader.
+    template<class EncoderType>
+    class generation_store_reader
+    {
+    public:
+
+        /// Pointer to the encoder used
+        typedef typename EncoderType::pointer pointer;
+
+        /// Pointer to the store
+        typedef boost::shared_ptr<generation_store> store_pointer;
+
+    public:
+
+        /// Creates a new reader
+        /// @param store The store holding the generations
+        /// @param object_id The id of the object in the store
+        /// @param storage The memory buffer holding the object
+        generation_store_reader(const store_pointer &store,
+                                uint32_t object_id,
+                                const sak::const_storage &storage)
+            : m_store(store),
+              m_object_id(object_id),
+              m_storage(storage)
+        {
+            assert(m_store);
+            assert(m_storage.m_size > 0);
+            assert(m_storage.m_data != 0);
+        }
+
+        /// @return the size of the object in bytes
+        uint32_t size() const
+        {
+            return m_storage.m_size;
+        }
+
+        /// Attaches the encoder to the generation at the offset, loading
+        /// it into the store if no other encoder uses it.
+        /// @param encoder to be initialized
+        /// @param offset in bytes into the object
+        /// @param size the number of bytes to use
+        void read(pointer &encoder, uint32_t offset, uint32_t size)
+        {
+            assert(encoder);
+            assert(offset < m_storage.m_size);
+            assert(size > 0);
+            assert(size <= m_storage.m_size - offset);
+            assert(size <= encoder->block_size());
+
+            const uint8_t *source = m_storage.m_data + offset;
+
+            // The generation is zero padded to the full block size as
+            // required by the shallow storage
+            auto generation = m_store->load(
+                m_object_id, offset, encoder->block_size(),
+                [source, size](uint8_t *data)
+                {
+                    std::copy(source, source + size, data);
+                });
+
+            encoder->set_generation(generation);
+            encoder->set_bytes_used(size);
+        }
+
+    private:
+
+        /// The store holding the generations
+        store_pointer m_store;
+
+        /// The id of the object in the store
+        uint32_t m_object_id;
+
+        /// The memory buffer
+        sak::const_storage m_storage;
+
+    };
+
+}
@@ -0,0 +1,649 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Decoder for large generations of sparse symbols using
+    ///        peeling and inactivation.
+    ///
+    /// Received symbols are buffered together with their coefficients
+    /// until at least symbols() have been received. The decoder then
+    /// tries to decode. It first peels the structure of the coefficient
+    /// matrix: whenever a buffered symbol has exactly one unresolved
+    /// symbol it resolves that symbol. When peeling stalls, the symbol
+    /// with the fewest unresolved symbols is made resolvable by
+    /// inactivating all but one of them. Only the symbols not used for
+    /// peeling are then eliminated against the inactive symbols, which
+    /// gives a small dense system solved with Gaussian elimination.
+    /// Finally the peeled symbols are substituted with the inactive
+    /// symbols.
+    ///
+    /// Each attempt is first carried out on the coefficients only and
+    /// the row operations are recorded. The operations are replayed on
+    /// the buffered symbol data only if the attempt succeeds, otherwise
+    /// the decoder waits for another symbol and tries again.
+    ///
+    /// Since the elimination is deferred, rank() is zero until the
+    /// decoding succeeds and symbols() afterwards. The layer replaces
+    /// the linear block decoder and only needs symbol storage and
+    /// coefficient_info below it.
+    template<class SuperCoder>
+    class inactivation_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// Constructor
+        inactivation_decoder()
+            : m_rows(0),
+              m_attempted_rows(0),
+              m_complete(false)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_max_length = fifi::elements_to_length<field_type>(
+                the_factory.max_symbols());
+
+            m_max_symbol_size = the_factory.max_symbol_size();
+
+            m_state.resize(the_factory.max_symbols());
+            m_pivot.resize(the_factory.max_symbols());
+            m_column_rows.resize(the_factory.max_symbols());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_rows = 0;
+            m_attempted_rows = 0;
+            m_complete = false;
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_coefficients != 0);
+
+            if(m_complete)
+                return;
+
+            uint32_t row = add_row(symbol_data);
+
+            std::copy_n(
+                reinterpret_cast<const value_type*>(symbol_coefficients),
+                SuperCoder::coefficients_length(), coefficients(row));
+
+            update_row_columns(row);
+            try_decode();
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_index < SuperCoder::symbols());
+
+            if(m_complete)
+                return;
+
+            uint32_t row = add_row(symbol_data);
+
+            value_type *c = coefficients(row);
+            std::fill_n(c, SuperCoder::coefficients_length(), 0);
+            fifi::set_value<field_type>(c, symbol_index, 1U);
+
+            update_row_columns(row);
+            try_decode();
+        }
+
+        /// @copydoc layer::is_complete() const
+        bool is_complete() const
+        {
+            return m_complete;
+        }
+
+        /// @copydoc layer::rank() const
+        uint32_t rank() const
+        {
+            return m_complete ? SuperCoder::symbols() : 0;
+        }
+
+        /// @copydoc layer::symbol_pivot(uint32_t) const
+        bool symbol_pivot(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+            return m_complete;
+        }
+
+        /// @return The number of symbols currently buffered
+        uint32_t buffered_symbols() const
+        {
+            return m_rows;
+        }
+
+        /// @return The number of symbols inactivated by the last
+        ///         decoding attempt
+        uint32_t inactivated_symbols() const
+        {
+            return m_inactive.size();
+        }
+
+    protected:
+
+        /// The state of a symbol during a decoding attempt
+        enum column_state
+        {
+            active,
+            peeled,
+            inactive
+        };
+
+        /// A recorded row operation. If src equals dest the dest row
+        /// is multiplied by value, otherwise value times the src row is
+        /// subtracted from the dest row.
+        struct row_operation
+        {
+            uint32_t dest;
+            uint32_t src;
+            value_type value;
+        };
+
+    protected:
+
+        /// Buffers the symbol data of a received symbol
+        /// @param symbol_data The symbol data
+        /// @return The row of the buffered symbol
+        uint32_t add_row(const uint8_t *symbol_data)
+        {
+            uint32_t row = m_rows;
+            ++m_rows;
+
+            if(m_row_data.size() < m_rows * m_max_symbol_size)
+            {
+                m_row_data.resize(m_rows * m_max_symbol_size);
+                m_row_coefficients.resize(m_rows * m_max_length);
+                m_row_columns.resize(m_rows);
+            }
+
+            std::copy_n(symbol_data, SuperCoder::symbol_size(),
+                        data(row));
+
+            return row;
+        }
+
+        /// Stores the nonzero columns of a buffered row
+        /// @param row The buffered row
+        void update_row_columns(uint32_t row)
+        {
+            const value_type *c = coefficients(row);
+
+            auto& columns = m_row_columns[row];
+            columns.clear();
+
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+            {
+                if(fifi::get_value<field_type>(c, i))
+                    columns.push_back(i);
+            }
+        }
+
+        /// Attempts to decode if enough symbols have been buffered and
+        /// the buffer changed since the last attempt
+        void try_decode()
+        {
+            if(m_rows < SuperCoder::symbols())
+                return;
+
+            if(m_rows == m_attempted_rows)
+                return;
+
+            m_attempted_rows = m_rows;
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            // The elimination only works on the coefficients, the
+            // symbol data is updated by replaying the operations
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            bool success = peel() && eliminate();
+
+            SuperCoder::pop_operations_region();
+
+            if(success)
+            {
+                replay_operations();
+                store_symbols();
+                m_complete = true;
+            }
+
+            SuperCoder::pop_operations_phase();
+        }
+
+        /// Determines the peeling order and the inactive symbols using
+        /// only the structure of the coefficients
+        /// @return False if some symbol is not covered by the buffer
+        bool peel()
+        {
+            uint32_t symbols = SuperCoder::symbols();
+
+            m_order.clear();
+            m_inactive.clear();
+
+            m_row_used.assign(m_rows, false);
+            m_degree.assign(m_rows, 0);
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                m_state[i] = active;
+                m_column_rows[i].clear();
+            }
+
+            std::deque<uint32_t> ripple;
+
+            for(uint32_t r = 0; r < m_rows; ++r)
+            {
+                for(uint32_t column : m_row_columns[r])
+                    m_column_rows[column].push_back(r);
+
+                m_degree[r] = m_row_columns[r].size();
+
+                if(m_degree[r] == 1)
+                    ripple.push_back(r);
+            }
+
+            uint32_t resolved = 0;
+
+            while(resolved < symbols)
+            {
+                if(ripple.empty())
+                {
+                    // Peeling stalled, pick the unused row with the
+                    // fewest active symbols and inactivate all but one
+                    uint32_t row = min_degree_row();
+
+                    if(row == m_rows)
+                        return false;
+
+                    bool first = true;
+                    for(uint32_t column : m_row_columns[row])
+                    {
+                        if(m_state[column] != active)
+                            continue;
+
+                        if(first)
+                        {
+                            first = false;
+                            continue;
+                        }
+
+                        m_state[column] = inactive;
+                        m_inactive.push_back(column);
+                        ++resolved;
+
+                        resolve_column(column, ripple);
+                    }
+
+                    assert(m_degree[row] == 1);
+                    continue;
+                }
+
+                uint32_t row = ripple.front();
+                ripple.pop_front();
+
+                if(m_row_used[row] || m_degree[row] != 1)
+                    continue;
+
+                uint32_t column = active_column(row);
+
+                m_state[column] = peeled;
+                m_pivot[column] = row;
+                m_row_used[row] = true;
+                m_order.push_back(column);
+                ++resolved;
+
+                resolve_column(column, ripple);
+            }
+
+            return true;
+        }
+
+        /// Removes a resolved column from the degree of its rows
+        /// @param column The resolved column
+        /// @param ripple The rows which can be peeled
+        void resolve_column(uint32_t column, std::deque<uint32_t> &ripple)
+        {
+            for(uint32_t r : m_column_rows[column])
+            {
+                assert(m_degree[r] > 0);
+                --m_degree[r];
+
+                if(m_degree[r] == 1 && !m_row_used[r])
+                    ripple.push_back(r);
+            }
+        }
+
+        /// @return The unused row with the fewest active columns, or the
+        ///         number of buffered rows if no row has an active column
+        uint32_t min_degree_row() const
+        {
+            uint32_t row = m_rows;
+
+            for(uint32_t r = 0; r < m_rows; ++r)
+            {
+                if(m_row_used[r] || m_degree[r] == 0)
+                    continue;
+
+                if(row == m_rows || m_degree[r] < m_degree[row])
+                    row = r;
+            }
+
+            return row;
+        }
+
+        /// @param row A row with exactly one active column
+        /// @return The active column of the row
+        uint32_t active_column(uint32_t row) const
+        {
+            for(uint32_t column : m_row_columns[row])
+            {
+                if(m_state[column] == active)
+                    return column;
+            }
+
+            assert(0);
+            return 0;
+        }
+
+        /// Performs the elimination on a copy of the coefficients and
+        /// records the row operations.
+        /// @return False if the inactive symbols could not be solved
+        bool eliminate()
+        {
+            m_operations.clear();
+            m_work = m_row_coefficients;
+
+            // Reduce the peeled rows to their pivot and the inactive
+            // columns. The rows subtracted only contain their own pivot
+            // and inactive columns, so the values of the other peeled
+            // columns are unaffected by the order.
+            for(uint32_t column : m_order)
+            {
+                uint32_t row = m_pivot[column];
+
+                for(uint32_t j : m_row_columns[row])
+                {
+                    if(j != column && m_state[j] == peeled)
+                        subtract_pivot(row, j, m_pivot[j]);
+                }
+
+                normalize(row, column);
+            }
+
+            // Reduce the remaining rows to the inactive columns
+            m_core.clear();
+
+            for(uint32_t row = 0; row < m_rows; ++row)
+            {
+                if(m_row_used[row])
+                    continue;
+
+                for(uint32_t j : m_row_columns[row])
+                {
+                    if(m_state[j] == peeled)
+                        subtract_pivot(row, j, m_pivot[j]);
+                }
+
+                m_core.push_back(row);
+            }
+
+            // Gauss-Jordan elimination of the inactive columns
+            for(uint32_t column : m_inactive)
+            {
+                auto pivot = std::find_if(
+                    m_core.begin(), m_core.end(),
+                    [this, column](uint32_t row)
+                    {
+                        return !m_row_used[row] && fifi::get_value<
+                            field_type>(work(row), column) != 0;
+                    });
+
+                if(pivot == m_core.end())
+                    return false;
+
+                uint32_t pivot_row = *pivot;
+                m_row_used[pivot_row] = true;
+                m_pivot[column] = pivot_row;
+
+                normalize(pivot_row, column);
+
+                for(uint32_t row : m_core)
+                {
+                    if(row != pivot_row)
+                        subtract_pivot(row, column, pivot_row);
+                }
+            }
+
+            // Substitute the solved inactive columns into the peeled rows
+            for(uint32_t column : m_order)
+            {
+                uint32_t row = m_pivot[column];
+
+                for(uint32_t j : m_inactive)
+                    subtract_pivot(row, j, m_pivot[j]);
+            }
+
+            return true;
+        }
+
+        /// Eliminates a column from a row of the working coefficients
+        /// @param row The row to update
+        /// @param column The column to eliminate
+        /// @param pivot_row The row with a one in the column
+        void subtract_pivot(uint32_t row, uint32_t column,
+                            uint32_t pivot_row)
+        {
+            value_type value =
+                fifi::get_value<field_type>(work(row), column);
+
+            if(!value)
+                return;
+
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::subtract(work(row), work(pivot_row),
+                                     SuperCoder::coefficients_length());
+            }
+            else
+            {
+                SuperCoder::multiply_subtract(
+                    work(row), work(pivot_row), value,
+                    SuperCoder::coefficients_length());
+            }
+
+            row_operation operation = { row, pivot_row, value };
+            m_operations.push_back(operation);
+        }
+
+        /// Normalizes a row of the working coefficients such that the
+        /// value in the column is one
+        /// @param row The row to normalize
+        /// @param column The pivot column of the row
+        void normalize(uint32_t row, uint32_t column)
+        {
+            value_type value =
+                fifi::get_value<field_type>(work(row), column);
+
+            assert(value != 0);
+
+            if(value == 1)
+                return;
+
+            value_type inverted = SuperCoder::invert(value);
+
+            SuperCoder::multiply(work(row), inverted,
+                                 SuperCoder::coefficients_length());
+
+            row_operation operation = { row, row, inverted };
+            m_operations.push_back(operation);
+        }
+
+        /// Applies the recorded operations to the buffered symbol data
+        void replay_operations()
+        {
+            for(const auto& operation : m_operations)
+            {
+                value_type *dest = data_value(operation.dest);
+
+                if(operation.src == operation.dest)
+                {
+                    SuperCoder::multiply(dest, operation.value,
+                                         SuperCoder::symbol_length());
+                }
+                else if(fifi::is_binary<field_type>::value)
+                {
+                    SuperCoder::subtract(dest, data_value(operation.src),
+                                         SuperCoder::symbol_length());
+                }
+                else
+                {
+                    SuperCoder::multiply_subtract(
+                        dest, data_value(operation.src), operation.value,
+                        SuperCoder::symbol_length());
+                }
+            }
+        }
+
+        /// Copies the decoded symbols to the symbol storage
+        void store_symbols()
+        {
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+            {
+                std::copy_n(data(m_pivot[i]), SuperCoder::symbol_size(),
+                            SuperCoder::symbol(i));
+            }
+        }
+
+        /// @param row The buffered row
+        /// @return The symbol data of the row
+        uint8_t* data(uint32_t row)
+        {
+            assert(row < m_rows);
+            return &m_row_data[row * m_max_symbol_size];
+        }
+
+        /// @param row The buffered row
+        /// @return The symbol data of the row as value_type
+        value_type* data_value(uint32_t row)
+        {
+            return reinterpret_cast<value_type*>(data(row));
+        }
+
+        /// @param row The buffered row
+        /// @return The coefficients of the row
+        value_type* coefficients(uint32_t row)
+        {
+            assert(row < m_rows);
+            return &m_row_coefficients[row * m_max_length];
+        }
+
+        /// @param row The buffered row
+        /// @return The working coefficients of the row
+        value_type* work(uint32_t row)
+        {
+            assert(row < m_rows);
+            return &m_work[row * m_max_length];
+        }
+
+    protected:
+
+        /// The number of buffered rows
+        uint32_t m_rows;
+
+        /// The number of buffered rows at the last decoding attempt
+        uint32_t m_attempted_rows;
+
+        /// True once all symbols are decoded
+        bool m_complete;
+
+        /// The maximum coefficients length in value_type elements
+        uint32_t m_max_length;
+
+        /// The maximum symbol size in bytes
+        uint32_t m_max_symbol_size;
+
+        /// The buffered symbol data
+        std::vector<uint8_t> m_row_data;
+
+        /// The buffered coefficients
+        std::vector<value_type> m_row_coefficients;
+
+        /// The working copy of the coefficients of a decoding attempt
+        std::vector<value_type> m_work;
+
+        /// The nonzero columns of every buffered row
+        std::vector<std::vector<uint32_t> > m_row_columns;
+
+        /// The rows containing every column
+        std::vector<std::vector<uint32_t> > m_column_rows;
+
+        /// The number of active columns of every row
+        std::vector<uint32_t> m_degree;
+
+        /// Whether a row is used as a pivot
+        std::vector<bool> m_row_used;
+
+        /// The state of every column
+        std::vector<column_state> m_state;
+
+        /// The pivot row of every resolved column
+        std::vector<uint32_t> m_pivot;
+
+        /// The peeled columns in the order they were peeled
+        std::vector<uint32_t> m_order;
+
+        /// The inactivated columns
+        std::vector<uint32_t> m_inactive;
+
+        /// The rows not used for peeling
+        std::vector<uint32_t> m_core;
+
+        /// The row operations recorded during the elimination
+        std::vector<row_operation> m_operations;
+
+    };
+}
@@ -0,0 +1,218 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Drops symbols which are not innovative before they reach
+    ///        the layers below.
+    ///
+    /// The layer keeps its own echelon form of the coefficient vectors
+    /// which passed the filter. Only the coefficient vectors are
+    /// eliminated, the symbol data is never touched. This makes it
+    /// suitable as an optional rank check on top of the
+    /// relay_symbol_buffer layer.
+    template<class SuperCoder>
+    class innovative_symbol_filter : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            uint32_t max_length = fifi::elements_to_length<field_type>(
+                the_factory.max_symbols());
+
+            m_echelon.resize(the_factory.max_symbols() * max_length);
+            m_reduced.resize(max_length);
+            m_pivots.resize(the_factory.max_symbols(), false);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            std::fill_n(m_pivots.begin(), the_factory.symbols(), false);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_coefficients != 0);
+
+            std::copy_n(
+                reinterpret_cast<const value_type*>(symbol_coefficients),
+                SuperCoder::coefficients_length(), &m_reduced[0]);
+
+            if(insert_reduced())
+            {
+                SuperCoder::decode_symbol(symbol_data, symbol_coefficients);
+            }
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+            assert(symbol_data != 0);
+
+            std::fill_n(m_reduced.begin(), SuperCoder::coefficients_length(),
+                        0);
+            fifi::set_value<field_type>(&m_reduced[0], symbol_index, 1U);
+
+            if(insert_reduced())
+            {
+                SuperCoder::decode_symbol(symbol_data, symbol_index);
+            }
+        }
+
+        /// @copydoc layer::is_innovative(const uint8_t*)
+        bool is_innovative(const uint8_t *symbol_coefficients)
+        {
+            assert(symbol_coefficients != 0);
+
+            std::copy_n(
+                reinterpret_cast<const value_type*>(symbol_coefficients),
+                SuperCoder::coefficients_length(), &m_reduced[0]);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            bool innovative = reduce() < SuperCoder::symbols();
+
+            SuperCoder::pop_operations_region();
+            SuperCoder::pop_operations_phase();
+
+            return innovative;
+        }
+
+    private:
+
+        /// Reduces the coefficients in m_reduced against the stored
+        /// echelon form.
+        /// @return The pivot position of the reduced vector, or the
+        ///         number of symbols if the vector was reduced to zero
+        uint32_t reduce()
+        {
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t length = SuperCoder::coefficients_length();
+
+            value_type *reduced = &m_reduced[0];
+
+            // The stored row at pivot i only has non-zero coefficients
+            // at i and above, so eliminating in increasing order leaves
+            // the first remaining non-zero coefficient as the pivot.
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                value_type value = fifi::get_value<field_type>(reduced, i);
+
+                if(!value)
+                {
+                    continue;
+                }
+
+                if(!m_pivots[i])
+                {
+                    return i;
+                }
+
+                const value_type *row = &m_echelon[i * length];
+
+                if(fifi::is_binary<field_type>::value)
+                {
+                    SuperCoder::subtract(reduced, row, length);
+                }
+                else
+                {
+                    SuperCoder::multiply_subtract(
+                        reduced, row, value, length);
+                }
+            }
+
+            return symbols;
+        }
+
+        /// Reduces m_reduced and stores it in the echelon form if it
+        /// is innovative.
+        /// @return True if the coefficient vector was innovative
+        bool insert_reduced()
+        {
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
+            uint32_t pivot = reduce();
+            bool innovative = pivot < SuperCoder::symbols();
+
+            if(innovative)
+            {
+                uint32_t length = SuperCoder::coefficients_length();
+                value_type *reduced = &m_reduced[0];
+
+                if(!fifi::is_binary<field_type>::value)
+                {
+                    value_type value =
+                        fifi::get_value<field_type>(reduced, pivot);
+
+                    SuperCoder::multiply(
+                        reduced, SuperCoder::invert(value), length);
+                }
+
+                std::copy_n(reduced, length, &m_echelon[pivot * length]);
+                m_pivots[pivot] = true;
+            }
+
+            SuperCoder::pop_operations_region();
+            SuperCoder::pop_operations_phase();
+
+            return innovative;
+        }
+
+    private:
+
+        /// The normalized coefficient vectors which passed the filter,
+        /// stored at the row of their pivot position
+        std::vector<value_type> m_echelon;
+
+        /// Buffer used while reducing a coefficient vector
+        std::vector<value_type> m_reduced;
+
+        /// Tracks which rows of the echelon form are in use
+        std::vector<bool> m_pivots;
+
+    };
+
+}
@@ -0,0 +1,46 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <type_traits>
+
+#include <fifi/field_types.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup type_traits
+    /// Type trait helper allows compile time detection of whether a
+    /// finite field is a binary extension field, i.e. a field of order
+    /// 2^m in which addition is a bitwise XOR. This holds for
+    /// fifi::binary, fifi::binary8 and fifi::binary16 but not for
+    /// fifi::prime2325.
+    ///
+    /// Example:
+    ///
+    /// static_assert(kodo::is_binary_extension_field<fifi::binary8>::value,
+    ///               "XOR is not the addition of the field");
+    ///
+    template<class Field>
+    struct is_binary_extension_field : public std::false_type
+    { };
+
+    /// @copydoc is_binary_extension_field
+    template<>
+    struct is_binary_extension_field<fifi::binary> : public std::true_type
+    { };
+
+    /// @copydoc is_binary_extension_field
+    template<>
+    struct is_binary_extension_field<fifi::binary8> : public std::true_type
+    { };
+
+    /// @copydoc is_binary_extension_field
+    template<>
+    struct is_binary_extension_field<fifi::binary16> : public std::true_type
+    { };
+
+}
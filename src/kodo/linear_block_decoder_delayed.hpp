@@ -6,12 +6,21 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "operations_phase.hpp"
+#include "thread_pool.hpp"
+
 namespace kodo
 {
 
@@ -22,6 +31,13 @@ namespace kodo
     /// effect and can therefore improve the decoding throughput when
     /// decoding sparse symbols, in particular if the generation size
     /// is large.
+    ///
+    /// At full rank the coding matrix is triangular and the symbols are
+    /// solved by a blocked back-solve. The symbols are split into column
+    /// tiles sized such that one tile of every symbol fits in the cache,
+    /// and each tile is solved from the last pivot row to the first.
+    /// The tiles are independent and may be solved in parallel, see
+    /// factory::set_substitute_threads().
     template<class SuperCoder>
     class linear_block_decoder_delayed : public SuperCoder
     {
@@ -36,8 +52,90 @@ namespace kodo
         ///
         typedef typename SuperCoder::direction_policy direction_policy;
 
+        /// Pointer to the thread pool
+        typedef boost::shared_ptr<thread_pool> pool_pointer;
+
+        /// The number of bytes of the symbols which should fit in the
+        /// cache while solving a tile
+        static const uint32_t tile_cache_size = 262144;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer owns the thread pool used for the final
+        /// backward substitution by all coders built by the factory.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            {
+                set_substitute_threads(1);
+            }
+
+            /// Sets the number of threads solving the tiles of the final
+            /// backward substitution. The thread calling the decoder is
+            /// one of them, so a value of one disables the parallel
+            /// processing. The tiles are only solved in parallel if the
+            /// finite field operations may run concurrently, see
+            /// layer::is_concurrent_safe(). Coders built after this call
+            /// use the new thread pool.
+            /// @param threads The number of threads
+            void set_substitute_threads(uint32_t threads)
+            {
+                assert(threads > 0);
+                m_pool = boost::make_shared<thread_pool>(threads - 1);
+            }
+
+            /// @return The number of threads solving the tiles of the
+            ///         final backward substitution
+            uint32_t substitute_threads() const
+            {
+                assert(m_pool);
+                return m_pool->workers() + 1;
+            }
+
+        private:
+
+            /// Give the layer access
+            friend class linear_block_decoder_delayed;
+
+            /// @return The thread pool
+            pool_pointer pool()
+            {
+                return m_pool;
+            }
+
+        private:
+
+            /// The thread pool
+            pool_pointer m_pool;
+        };
+
     public:
 
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_solve_order.reserve(the_factory.max_symbols());
+            m_row_begin.reserve(the_factory.max_symbols() + 1);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_pool = the_factory.pool();
+            assert(m_pool);
+        }
+
         /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
         void decode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
         {
@@ -83,6 +181,8 @@ namespace kodo
                 m_maximum_pivot =
                     direction_policy::max(symbol_index, m_maximum_pivot);
 
+                m_last_pivot = symbol_index;
+
             }
 
             if(SuperCoder::is_complete())
@@ -97,6 +197,7 @@ namespace kodo
         // Fetch the variables needed
         using SuperCoder::m_rank;
         using SuperCoder::m_maximum_pivot;
+        using SuperCoder::m_last_pivot;
         using SuperCoder::m_coded;
         using SuperCoder::m_uncoded;
 
@@ -114,23 +215,46 @@ namespace kodo
             assert(coefficients != 0);
 
             // See if we can find a pivot
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
             boost::optional<uint32_t> pivot_index
-                = SuperCoder::forward_substitute_to_pivot(
-                    symbol_data, coefficients);
+                = SuperCoder::reduce_coefficients_to_pivot(coefficients);
+
+            SuperCoder::pop_operations_phase();
 
             if(!pivot_index)
                 return;
 
+            // Decode the symbol in the storage of its pivot
+            value_type *symbol =
+                SuperCoder::move_into_pivot(symbol_data, *pivot_index);
+
+            SuperCoder::push_operations_phase(
+                operations_phase::forward_substitute);
+
+            SuperCoder::forward_substitute_symbol(symbol);
+
+            SuperCoder::pop_operations_phase();
+
             if(!fifi::is_binary<field_type>::value)
             {
                 // Normalize symbol and vector
+                SuperCoder::push_operations_phase(
+                    operations_phase::normalize);
+
                 SuperCoder::normalize(
-                    symbol_data, coefficients, *pivot_index);
+                    symbol, coefficients, *pivot_index);
+
+                SuperCoder::pop_operations_phase();
             }
 
-            // Now save the received symbol
+            // Now save the received symbol, the symbol data is already in
+            // place
             SuperCoder::store_coded_symbol(
-                symbol_data, coefficients,*pivot_index);
+                symbol, coefficients, *pivot_index);
+
+            SuperCoder::invalidate_column_index();
 
             // We have increased the rank
             ++m_rank;
@@ -140,6 +264,8 @@ namespace kodo
             m_maximum_pivot =
                 direction_policy::max(*pivot_index, m_maximum_pivot);
 
+            m_last_pivot = *pivot_index;
+
             if(SuperCoder::is_complete())
             {
                 final_backward_substitute();
@@ -155,6 +281,65 @@ namespace kodo
         {
             assert(SuperCoder::is_complete());
 
+            SuperCoder::push_operations_phase(
+                operations_phase::backward_substitute);
+
+            collect_triangle();
+
+            uint32_t symbol_length = SuperCoder::symbol_length();
+            uint32_t tile_length = solve_tile_length(symbol_length);
+
+            uint32_t tiles =
+                (symbol_length + tile_length - 1) / tile_length;
+
+            auto solve = [&](uint32_t tile)
+                {
+                    uint32_t offset = tile * tile_length;
+                    uint32_t length =
+                        std::min(tile_length, symbol_length - offset);
+
+                    solve_tile(offset, length);
+                };
+
+            if(tiles > 1 && is_parallel())
+            {
+                m_pool->run(tiles, solve);
+            }
+            else
+            {
+                for(uint32_t tile = 0; tile < tiles; ++tile)
+                {
+                    solve(tile);
+                }
+            }
+
+            // Only the pivots remain in the coding matrix
+            SuperCoder::invalidate_column_index();
+
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+            {
+                if(!m_coded[i])
+                    continue;
+
+                value_type *vector_i = SuperCoder::coefficients_value(i);
+
+                std::fill_n(vector_i, SuperCoder::coefficients_length(), 0);
+                fifi::set_value<field_type>(vector_i, i, 1U);
+            }
+
+            SuperCoder::pop_operations_phase();
+        }
+
+        /// Collects the non-zero elements outside the pivots of the
+        /// coded symbols in the order in which the symbols are solved.
+        /// The pivots are visited in the order of the direction policy,
+        /// so every symbol only depends on the symbols after it.
+        void collect_triangle()
+        {
+            m_solve_order.clear();
+            m_row_begin.clear();
+            m_entries.clear();
+
             uint32_t start = direction_policy::min(0, SuperCoder::symbols()-1);
             uint32_t end = direction_policy::max(0, SuperCoder::symbols()-1);
 
@@ -162,17 +347,116 @@ namespace kodo
             {
                 uint32_t i = p.index();
 
-                value_type *symbol_i =
-                    SuperCoder::symbol_value(i);
+                m_solve_order.push_back(i);
+                m_row_begin.push_back(
+                    static_cast<uint32_t>(m_entries.size()));
 
-                value_type *vector_i =
+                // The vectors of uncoded symbols are unit vectors
+                if(!m_coded[i])
+                    continue;
+
+                const value_type *vector_i =
                     SuperCoder::coefficients_value(i);
 
-                SuperCoder::backward_substitute(
-                    symbol_i, vector_i, i);
+                for(uint32_t j = 0; j < SuperCoder::symbols(); ++j)
+                {
+                    value_type value =
+                        fifi::get_value<field_type>(vector_i, j);
+
+                    if(j != i && value)
+                    {
+                        m_entries.push_back(std::make_pair(j, value));
+                    }
+                }
             }
+
+            m_row_begin.push_back(static_cast<uint32_t>(m_entries.size()));
         }
-    };
-}
 
+        /// Solves one tile of all symbols, starting from the last symbol
+        /// in the solve order
+        /// @param offset The offset of the tile in value_type elements
+        /// @param length The length of the tile in value_type elements
+        void solve_tile(uint32_t offset, uint32_t length)
+        {
+            for(uint32_t n = static_cast<uint32_t>(m_solve_order.size());
+                n-- > 0;)
+            {
+                value_type *symbol_i =
+                    SuperCoder::symbol_value(m_solve_order[n]) + offset;
+
+                for(uint32_t e = m_row_begin[n]; e < m_row_begin[n + 1]; ++e)
+                {
+                    const value_type *symbol_j =
+                        SuperCoder::symbol_value(m_entries[e].first) + offset;
+
+                    if(fifi::is_binary<field_type>::value)
+                    {
+                        SuperCoder::subtract(symbol_i, symbol_j, length);
+                    }
+                    else
+                    {
+                        SuperCoder::multiply_subtract(
+                            symbol_i, symbol_j, m_entries[e].second, length);
+                    }
+                }
+            }
+        }
+
+        /// Chooses the tile length such that one tile of every symbol
+        /// fits in tile_cache_size bytes, and such that there is at least
+        /// one tile per thread. The tiles are kept a multiple of 64 bytes
+        /// such that the region kernels stay aligned.
+        /// @param symbol_length The length of a symbol
+        /// @return The length of a tile in value_type elements
+        uint32_t solve_tile_length(uint32_t symbol_length) const
+        {
+            uint32_t alignment = fifi::size_to_length<field_type>(64);
+
+            uint32_t tile_size =
+                std::max(tile_cache_size / SuperCoder::symbols(), 64U);
+
+            uint32_t tile_length =
+                fifi::size_to_length<field_type>((tile_size / 64) * 64);
+
+            if(is_parallel())
+            {
+                uint32_t threads = m_pool->workers() + 1;
+                tile_length = std::min(
+                    tile_length, (symbol_length + threads - 1) / threads);
+            }
+
+            tile_length = std::max(
+                alignment, (tile_length / alignment) * alignment);
 
+            return std::min(tile_length, symbol_length);
+        }
+
+        /// @return true if the tiles should be solved in parallel. This
+        ///         requires that the finite field layers below, e.g. the
+        ///         scalar Fifi math or a finite_field_counter, may be
+        ///         invoked concurrently.
+        bool is_parallel() const
+        {
+            assert(m_pool);
+
+            return m_pool->workers() > 0 && SuperCoder::is_concurrent_safe();
+        }
+
+    private:
+
+        /// The thread pool
+        pool_pointer m_pool;
+
+        /// The pivots in the order of the direction policy
+        std::vector<uint32_t> m_solve_order;
+
+        /// The first element of every symbol in m_entries, indexed by
+        /// the position in m_solve_order
+        std::vector<uint32_t> m_row_begin;
+
+        /// The column and value of the non-zero elements of the coded
+        /// symbols outside their pivots
+        std::vector<std::pair<uint32_t, value_type> > m_entries;
+    };
+}
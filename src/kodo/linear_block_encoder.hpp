@@ -12,6 +12,8 @@
 
 #include <sak/storage.hpp>
 
+#include "operations_phase.hpp"
+
 namespace kodo
 {
 
@@ -60,6 +62,8 @@ namespace kodo
             const value_type *c =
                 reinterpret_cast<const value_type*>(coefficients);
 
+            SuperCoder::push_operations_phase(operations_phase::encode);
+
             for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
             {
                 value_type value = fifi::get_value<field_type>(c, i);
@@ -88,6 +92,8 @@ namespace kodo
                         SuperCoder::symbol_length());
                 }
             }
+
+            SuperCoder::pop_operations_phase();
         }
 
     };
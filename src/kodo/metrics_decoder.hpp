@@ -0,0 +1,271 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "coder_metrics.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Maintains production counters of a decoder and of all
+    ///        decoders built by its factory.
+    ///
+    /// Like the rank_callback_decoder the layer wraps decode_symbol()
+    /// and compares the rank before and after, so it must be placed
+    /// above a linear block decoder. Each symbol counts as a payload,
+    /// as innovative or non-innovative, as systematic if uncoded and as
+    /// a swap if it replaced a coded symbol. The time from the first
+    /// symbol to is_complete() is added when a decoding completes.
+    /// Placed above a batch_linear_block_decoder, the coded symbols of a
+    /// batch are only queued by decode_symbol(), so they are counted as
+    /// innovative or non-innovative from the rank change in end_batch().
+    ///
+    /// The counters of a decoder are only written by the thread using
+    /// the decoder, so the decoders do not contend for a cache line.
+    /// They are registered with the metrics_registry of the factory
+    /// while the decoder exists, and moved to its retired counts when
+    /// the decoder is initialized again or destroyed. The totals are
+    /// never reset and can be read by another thread at any time
+    /// through factory::metrics(), including the counts of decodings
+    /// in progress.
+    template<class SuperCoder>
+    class metrics_decoder : public SuperCoder
+    {
+    public:
+
+        /// Pointer to the counters shared by the decoders of a factory
+        typedef boost::shared_ptr<metrics_registry> metrics_pointer;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder. Owns the totals.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_metrics(boost::make_shared<metrics_registry>())
+            { }
+
+            /// @return The totals of the decoders built by the factory
+            metrics_pointer metrics() const
+            {
+                return m_metrics;
+            }
+
+        private:
+
+            /// The totals
+            metrics_pointer m_metrics;
+
+        };
+
+    public:
+
+        /// Constructor
+        metrics_decoder()
+            : m_started(0),
+              m_batching(false),
+              m_batch_symbols(0)
+        { }
+
+        /// Destructor
+        ~metrics_decoder()
+        {
+            if(m_totals)
+            {
+                m_totals->detach(&m_metrics);
+            }
+        }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_totals = the_factory.metrics();
+            m_totals->attach(&m_metrics);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            // The counts of the previous use of the coder
+            m_totals->retire(m_metrics);
+            m_started = 0;
+            m_batching = false;
+            m_batch_symbols = 0;
+        }
+
+        /// Starts a batch of the batch_linear_block_decoder below
+        void begin_batch()
+        {
+            SuperCoder::begin_batch();
+
+            m_batching = true;
+            m_batch_symbols = 0;
+        }
+
+        /// Decodes the batch and counts its coded symbols as innovative
+        /// or non-innovative
+        void end_batch()
+        {
+            uint32_t rank = SuperCoder::rank();
+
+            SuperCoder::end_batch();
+
+            m_batching = false;
+
+            if(m_batch_symbols == 0)
+                return;
+
+            uint32_t innovative = SuperCoder::rank() - rank;
+            assert(innovative <= m_batch_symbols);
+
+            add(coder_metrics::innovative, innovative);
+            add(coder_metrics::non_innovative,
+                m_batch_symbols - innovative);
+
+            m_batch_symbols = 0;
+
+            check_complete(rank);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            uint32_t rank = received();
+
+            SuperCoder::decode_symbol(symbol_data, symbol_coefficients);
+
+            // The symbol is counted once the batch is decoded
+            if(m_batching)
+            {
+                ++m_batch_symbols;
+                return;
+            }
+
+            if(SuperCoder::rank() > rank)
+            {
+                add(coder_metrics::innovative);
+            }
+            else
+            {
+                add(coder_metrics::non_innovative);
+            }
+
+            check_complete(rank);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+
+            uint32_t rank = received();
+
+            add(coder_metrics::systematic);
+
+            if(SuperCoder::symbol_pivot(symbol_index) &&
+               SuperCoder::symbol_coded(symbol_index))
+            {
+                add(coder_metrics::swaps);
+            }
+
+            SuperCoder::decode_symbol(symbol_data, symbol_index);
+
+            // A swap only increases the rank if the replaced coded
+            // symbol finds a new pivot
+            if(SuperCoder::rank() > rank)
+            {
+                add(coder_metrics::innovative);
+            }
+            else
+            {
+                add(coder_metrics::non_innovative);
+            }
+
+            check_complete(rank);
+        }
+
+        /// @return The counters of the decoder since it was initialized
+        const coder_metrics& metrics() const
+        {
+            return m_metrics;
+        }
+
+    private:
+
+        /// Counts a received symbol and starts the decode time
+        /// @return The rank before the symbol
+        uint32_t received()
+        {
+            if(m_started == 0)
+            {
+                m_started = coder_metrics::now();
+            }
+
+            add(coder_metrics::payloads);
+            add(coder_metrics::bytes, SuperCoder::symbol_size());
+
+            return SuperCoder::rank();
+        }
+
+        /// Adds the decode time if the last symbol completed the decoder
+        /// @param rank The rank before the last symbol
+        void check_complete(uint32_t rank)
+        {
+            if(rank < SuperCoder::symbols() && SuperCoder::is_complete())
+            {
+                add(coder_metrics::completed);
+                add(coder_metrics::decode_nanoseconds,
+                    coder_metrics::now() - m_started);
+            }
+        }
+
+        /// Increments a counter of the decoder
+        /// @param c The counter
+        /// @param value The increment
+        void add(coder_metrics::counter c, uint64_t value = 1)
+        {
+            m_metrics.increment(c, value);
+        }
+
+    private:
+
+        /// The counters of the decoder
+        coder_metrics m_metrics;
+
+        /// The totals of the factory
+        metrics_pointer m_totals;
+
+        /// The time of the first symbol in nanoseconds, zero before
+        uint64_t m_started;
+
+        /// True between begin_batch() and end_batch()
+        bool m_batching;
+
+        /// The number of coded symbols queued in the current batch
+        uint32_t m_batch_symbols;
+
+    };
+
+}
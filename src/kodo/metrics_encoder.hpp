@@ -0,0 +1,146 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "coder_metrics.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Maintains production counters of an encoder and of all
+    ///        encoders built by its factory.
+    ///
+    /// The encoder counterpart of the metrics_decoder. Every encoded
+    /// symbol counts as a payload and its bytes, uncoded symbols also
+    /// count as systematic. The counters of an encoder are only written
+    /// by the thread using the encoder. Like those of the decoders they
+    /// are registered with the metrics_registry of the factory, which
+    /// sums them with the counts of reset and destroyed encoders, so
+    /// the totals read through factory::metrics() include encoders
+    /// which are still running.
+    template<class SuperCoder>
+    class metrics_encoder : public SuperCoder
+    {
+    public:
+
+        /// Pointer to the counters shared by the encoders of a factory
+        typedef boost::shared_ptr<metrics_registry> metrics_pointer;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder. Owns the totals.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_metrics(boost::make_shared<metrics_registry>())
+            { }
+
+            /// @return The totals of the encoders built by the factory
+            metrics_pointer metrics() const
+            {
+                return m_metrics;
+            }
+
+        private:
+
+            /// The totals
+            metrics_pointer m_metrics;
+
+        };
+
+    public:
+
+        /// Destructor
+        ~metrics_encoder()
+        {
+            if(m_totals)
+            {
+                m_totals->detach(&m_metrics);
+            }
+        }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_totals = the_factory.metrics();
+            m_totals->attach(&m_metrics);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            // The counts of the previous use of the coder
+            m_totals->retire(m_metrics);
+        }
+
+        /// @copydoc layer::encode_symbol(uint8_t*, uint8_t*)
+        void encode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            SuperCoder::encode_symbol(symbol_data, coefficients);
+            encoded();
+        }
+
+        /// @copydoc layer::encode_symbol(uint8_t*,uint32_t)
+        void encode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            SuperCoder::encode_symbol(symbol_data, symbol_index);
+
+            add(coder_metrics::systematic);
+            encoded();
+        }
+
+        /// @return The counters of the encoder since it was initialized
+        const coder_metrics& metrics() const
+        {
+            return m_metrics;
+        }
+
+    private:
+
+        /// Counts an encoded symbol
+        void encoded()
+        {
+            add(coder_metrics::payloads);
+            add(coder_metrics::bytes, SuperCoder::symbol_size());
+        }
+
+        /// Increments a counter of the encoder
+        /// @param c The counter
+        /// @param value The increment
+        void add(coder_metrics::counter c, uint64_t value = 1)
+        {
+            m_metrics.increment(c, value);
+        }
+
+    private:
+
+        /// The counters of the encoder
+        coder_metrics m_metrics;
+
+        /// The totals of the factory
+        metrics_pointer m_totals;
+
+    };
+
+}
@@ -6,12 +6,104 @@
 #pragma once
 
 #include <cstdint>
+#include <cassert>
+
+#include "operations_phase.hpp"
 
 namespace kodo
 {
 
+    /// Helper class which counts the number of bytes processed by each
+    /// of the region operations.
+    struct operations_bytes
+    {
+
+        /// Constructs a new counter and zero initializes the
+        /// counter.
+        operations_bytes()
+            : m_multiply(0),
+              m_multiply_add(0),
+              m_add(0),
+              m_multiply_subtract(0),
+              m_subtract(0)
+            { }
+
+        /// @return The number of bytes processed by all operations
+        uint64_t total() const
+        {
+            return m_multiply + m_multiply_add + m_add +
+                m_multiply_subtract + m_subtract;
+        }
+
+        /// Bytes processed by dest[i] = dest[i] * constant
+        uint64_t m_multiply;
+
+        /// Bytes processed by dest[i] = dest[i] + (constant * src[i])
+        uint64_t m_multiply_add;
+
+        /// Bytes processed by dest[i] = dest[i] + src[i]
+        uint64_t m_add;
+
+        /// Bytes processed by dest[i] = dest[i] - (constant * src[i])
+        uint64_t m_multiply_subtract;
+
+        /// Bytes processed by dest[i] = dest[i] - src[i]
+        uint64_t m_subtract;
+
+    };
+
+    /// Subtract two byte counters ala. a - b
+    /// @param a The byte counter to be reduced
+    /// @param b The byte counter subtracted from a
+    inline operations_bytes operator-(const operations_bytes &a,
+                                      const operations_bytes &b)
+    {
+        operations_bytes res;
+
+        assert(a.m_multiply >= b.m_multiply);
+        res.m_multiply = a.m_multiply - b.m_multiply;
+
+        assert(a.m_multiply_add >= b.m_multiply_add);
+        res.m_multiply_add = a.m_multiply_add - b.m_multiply_add;
+
+        assert(a.m_add >= b.m_add);
+        res.m_add = a.m_add - b.m_add;
+
+        assert(a.m_multiply_subtract >= b.m_multiply_subtract);
+        res.m_multiply_subtract =
+            a.m_multiply_subtract - b.m_multiply_subtract;
+
+        assert(a.m_subtract >= b.m_subtract);
+        res.m_subtract = a.m_subtract - b.m_subtract;
+
+        return res;
+    }
+
+    /// Add two byte counters ala. a + b
+    /// @param a The first byte counter
+    /// @param b The byte counter added to a
+    inline operations_bytes operator+(const operations_bytes &a,
+                                      const operations_bytes &b)
+    {
+        operations_bytes res;
+
+        res.m_multiply = a.m_multiply + b.m_multiply;
+        res.m_multiply_add = a.m_multiply_add + b.m_multiply_add;
+        res.m_add = a.m_add + b.m_add;
+        res.m_multiply_subtract =
+            a.m_multiply_subtract + b.m_multiply_subtract;
+        res.m_subtract = a.m_subtract + b.m_subtract;
+
+        return res;
+    }
+
     /// Helper class which is used by the finite_field_counter
-    /// layer to count the number of operations performed.
+    /// layer to count the number of operations performed and the
+    /// number of bytes they processed.
+    ///
+    /// The bytes are split into the work done on the coefficient vectors
+    /// and the work done on the symbol data (the payload), and broken
+    /// down per operations_phase.
     struct operations_counter
     {
 
@@ -24,25 +116,63 @@ namespace kodo
               m_multiply_subtract(0),
               m_subtract(0),
               m_invert(0)
-            { }
+        {
+            for(uint32_t i = 0; i < operations_phases; ++i)
+            {
+                m_phase_coefficient_bytes[i] = 0;
+                m_phase_payload_bytes[i] = 0;
+            }
+        }
+
+        /// @return The number of bytes processed by all operations
+        uint64_t total_bytes() const
+        {
+            return m_coefficient_bytes.total() + m_payload_bytes.total();
+        }
+
+        /// @param phase The phase
+        /// @return The number of coefficient bytes processed in the phase
+        uint64_t coefficient_bytes(operations_phase phase) const
+        {
+            return m_phase_coefficient_bytes[uint32_t(phase)];
+        }
+
+        /// @param phase The phase
+        /// @return The number of payload bytes processed in the phase
+        uint64_t payload_bytes(operations_phase phase) const
+        {
+            return m_phase_payload_bytes[uint32_t(phase)];
+        }
 
         /// Counter for dest[i] = dest[i] * constant
-        uint32_t m_multiply;
+        uint64_t m_multiply;
 
         /// Counter for dest[i] = dest[i] + (constant * src[i])
-        uint32_t m_multiply_add;
+        uint64_t m_multiply_add;
 
         /// Counter for dest[i] = dest[i] + src[i]
-        uint32_t m_add;
+        uint64_t m_add;
 
         /// Counter for dest[i] = dest[i] - (constant * src[i])
-        uint32_t m_multiply_subtract;
+        uint64_t m_multiply_subtract;
 
         /// Counter for dest[i] = dest[i] - src[i]
-        uint32_t m_subtract;
+        uint64_t m_subtract;
 
         /// Counter for invert(value)
-        uint32_t m_invert;
+        uint64_t m_invert;
+
+        /// Bytes processed per operation on coefficient vectors
+        operations_bytes m_coefficient_bytes;
+
+        /// Bytes processed per operation on symbol data
+        operations_bytes m_payload_bytes;
+
+        /// Bytes processed on coefficient vectors indexed by the phase
+        uint64_t m_phase_coefficient_bytes[operations_phases];
+
+        /// Bytes processed on symbol data indexed by the phase
+        uint64_t m_phase_payload_bytes[operations_phases];
 
     };
 
@@ -74,12 +204,31 @@ namespace kodo
 
         assert(a.m_invert >= b.m_invert);
         res.m_invert = a.m_invert - b.m_invert;
+
+        res.m_coefficient_bytes =
+            a.m_coefficient_bytes - b.m_coefficient_bytes;
+        res.m_payload_bytes = a.m_payload_bytes - b.m_payload_bytes;
+
+        for(uint32_t i = 0; i < operations_phases; ++i)
+        {
+            assert(a.m_phase_coefficient_bytes[i] >=
+                   b.m_phase_coefficient_bytes[i]);
+            res.m_phase_coefficient_bytes[i] =
+                a.m_phase_coefficient_bytes[i] -
+                b.m_phase_coefficient_bytes[i];
+
+            assert(a.m_phase_payload_bytes[i] >=
+                   b.m_phase_payload_bytes[i]);
+            res.m_phase_payload_bytes[i] =
+                a.m_phase_payload_bytes[i] - b.m_phase_payload_bytes[i];
+        }
+
         return res;
     }
 
-    /// Subtract two operations counters ala. a + b
-    /// @param a The operations counter to be reduced
-    /// @param b The operations counter subtracted from a
+    /// Add two operations counters ala. a + b
+    /// @param a The first operations counter
+    /// @param b The operations counter added to a
     inline operations_counter operator+(const operations_counter &a,
                                         const operations_counter &b)
     {
@@ -106,6 +255,20 @@ namespace kodo
         res.m_invert = a.m_invert + b.m_invert;
         assert(res.m_invert >= a.m_invert);
 
+        res.m_coefficient_bytes =
+            a.m_coefficient_bytes + b.m_coefficient_bytes;
+        res.m_payload_bytes = a.m_payload_bytes + b.m_payload_bytes;
+
+        for(uint32_t i = 0; i < operations_phases; ++i)
+        {
+            res.m_phase_coefficient_bytes[i] =
+                a.m_phase_coefficient_bytes[i] +
+                b.m_phase_coefficient_bytes[i];
+
+            res.m_phase_payload_bytes[i] =
+                a.m_phase_payload_bytes[i] + b.m_phase_payload_bytes[i];
+        }
+
         return res;
     }
 
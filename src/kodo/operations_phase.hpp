@@ -0,0 +1,79 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+namespace kodo
+{
+
+    /// The phases of the coding algorithms in which finite field
+    /// operations are performed. The codec layers mark the phases using
+    /// push_operations_phase() and pop_operations_phase(), which allows
+    /// the finite_field_counter layer to break down the work per phase.
+    enum class operations_phase : uint32_t
+    {
+        /// Operations performed outside a marked phase
+        other = 0,
+
+        /// Elimination of the existing pivots from a received symbol
+        forward_substitute,
+
+        /// Scaling of a received symbol such that its pivot is one
+        normalize,
+
+        /// Elimination of a new pivot from the existing symbols
+        backward_substitute,
+
+        /// Producing an encoded symbol
+        encode,
+
+        /// Producing a recoded symbol
+        recode
+    };
+
+    /// The number of phases in operations_phase
+    const uint32_t operations_phases = 6;
+
+    /// The data on which finite field operations are performed. The
+    /// codec layers mark operations on coefficient vectors using
+    /// push_operations_region() and pop_operations_region(), all other
+    /// operations work on payload data.
+    enum class operations_region : uint32_t
+    {
+        /// Symbol data or parts of it
+        payload = 0,
+
+        /// Coefficient vectors or parts of them
+        coefficients
+    };
+
+    /// @param phase The phase
+    /// @return The name of the phase
+    inline const char* operations_phase_name(operations_phase phase)
+    {
+        switch(phase)
+        {
+        case operations_phase::other:
+            return "other";
+        case operations_phase::forward_substitute:
+            return "forward_substitute";
+        case operations_phase::normalize:
+            return "normalize";
+        case operations_phase::backward_substitute:
+            return "backward_substitute";
+        case operations_phase::encode:
+            return "encode";
+        case operations_phase::recode:
+            return "recode";
+        }
+
+        assert(0);
+        return "";
+    }
+
+}
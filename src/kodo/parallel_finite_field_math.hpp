@@ -0,0 +1,313 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "thread_pool.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup finite_field_layers
+    /// @brief Splits large region operations into column stripes which
+    ///        are processed in parallel by a thread pool.
+    ///
+    /// All finite field operations are element wise, so the stripes of
+    /// an operation are independent. Operations shorter than the
+    /// parallel threshold, such as the coefficient vector operations,
+    /// are executed directly on the calling thread. This layer is meant
+    /// for decoding blocks with very large symbols, where the payload
+    /// operations dominate the decoding time.
+    ///
+    /// The operations are only split if the layers below report
+    /// layer::is_concurrent_safe(). This requires the finite_field_math
+    /// layer to use one of the region kernels, since the Fifi
+    /// implementation uses a temporary buffer shared by the whole coder.
+    /// A finite_field_counter below this layer also keeps the operations
+    /// on the calling thread, as its counters are not synchronized.
+    ///
+    /// The layer must be placed above the finite_field_math layer. A
+    /// finite_field_counter placed above this layer counts every
+    /// operation once, independent of the number of stripes.
+    template<class SuperCoder>
+    class parallel_finite_field_math : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// Pointer to the thread pool
+        typedef boost::shared_ptr<thread_pool> pool_pointer;
+
+        /// The length of a stripe is a multiple of this number of bytes
+        static const uint32_t stripe_alignment = 64;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer owns the thread pool shared by all coders
+        /// built by the factory.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_parallel_threshold(16384)
+            {
+                set_threads(std::max(std::thread::hardware_concurrency(),
+                                     1U));
+            }
+
+            /// Sets the number of threads working on an operation. The
+            /// thread calling the coder is one of them, so a value of
+            /// one disables the parallel processing. Coders built
+            /// after this call use the new thread pool.
+            /// @param threads The number of threads
+            void set_threads(uint32_t threads)
+            {
+                assert(threads > 0);
+                m_pool = boost::make_shared<thread_pool>(threads - 1);
+            }
+
+            /// @return The number of threads working on an operation
+            uint32_t threads() const
+            {
+                assert(m_pool);
+                return m_pool->workers() + 1;
+            }
+
+            /// Sets the minimum size in bytes of an operation before it
+            /// is split into stripes.
+            /// @param threshold The threshold in bytes
+            void set_parallel_threshold(uint32_t threshold)
+            {
+                m_parallel_threshold = threshold;
+            }
+
+            /// @return The minimum size in bytes of an operation before
+            ///         it is split into stripes.
+            uint32_t parallel_threshold() const
+            {
+                return m_parallel_threshold;
+            }
+
+        private:
+
+            /// Give the layer access
+            friend class parallel_finite_field_math;
+
+            /// @return The thread pool
+            pool_pointer pool()
+            {
+                return m_pool;
+            }
+
+        private:
+
+            /// The thread pool
+            pool_pointer m_pool;
+
+            /// The parallel threshold in bytes
+            uint32_t m_parallel_threshold;
+        };
+
+    public:
+
+        /// Constructor
+        parallel_finite_field_math()
+            : m_parallel_threshold(0)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_pool = the_factory.pool();
+            m_parallel_threshold = the_factory.parallel_threshold();
+
+            assert(m_pool);
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        void multiply(value_type *symbol_dest, value_type coefficient,
+                      uint32_t symbol_length)
+        {
+            if(!is_parallel(symbol_length))
+            {
+                SuperCoder::multiply(symbol_dest, coefficient,
+                                     symbol_length);
+                return;
+            }
+
+            run_stripes(symbol_length,
+                [&](uint32_t offset, uint32_t length)
+                {
+                    SuperCoder::multiply(symbol_dest + offset,
+                                         coefficient, length);
+                });
+        }
+
+        /// @copydoc layer::multiply_add(value_type*, const value_type*,
+        ///                              value_type, uint32_t)
+        void multiply_add(value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient, uint32_t symbol_length)
+        {
+            if(!is_parallel(symbol_length))
+            {
+                SuperCoder::multiply_add(symbol_dest, symbol_src,
+                                         coefficient, symbol_length);
+                return;
+            }
+
+            run_stripes(symbol_length,
+                [&](uint32_t offset, uint32_t length)
+                {
+                    SuperCoder::multiply_add(symbol_dest + offset,
+                                             symbol_src + offset,
+                                             coefficient, length);
+                });
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length)
+        {
+            if(!is_parallel(symbol_length))
+            {
+                SuperCoder::add(symbol_dest, symbol_src, symbol_length);
+                return;
+            }
+
+            run_stripes(symbol_length,
+                [&](uint32_t offset, uint32_t length)
+                {
+                    SuperCoder::add(symbol_dest + offset,
+                                    symbol_src + offset, length);
+                });
+        }
+
+        /// @copydoc layer::multiply_subtract(value_type*,
+        ///                                   const value_type*,
+        ///                                   value_type, uint32_t)
+        void multiply_subtract(value_type *symbol_dest,
+                               const value_type *symbol_src,
+                               value_type coefficient,
+                               uint32_t symbol_length)
+        {
+            if(!is_parallel(symbol_length))
+            {
+                SuperCoder::multiply_subtract(symbol_dest, symbol_src,
+                                              coefficient, symbol_length);
+                return;
+            }
+
+            run_stripes(symbol_length,
+                [&](uint32_t offset, uint32_t length)
+                {
+                    SuperCoder::multiply_subtract(symbol_dest + offset,
+                                                  symbol_src + offset,
+                                                  coefficient, length);
+                });
+        }
+
+        /// @copydoc layer::subtract(value_type*,const value_type*,
+        ///                          uint32_t)
+        void subtract(value_type *symbol_dest, const value_type *symbol_src,
+                      uint32_t symbol_length)
+        {
+            if(!is_parallel(symbol_length))
+            {
+                SuperCoder::subtract(symbol_dest, symbol_src,
+                                     symbol_length);
+                return;
+            }
+
+            run_stripes(symbol_length,
+                [&](uint32_t offset, uint32_t length)
+                {
+                    SuperCoder::subtract(symbol_dest + offset,
+                                         symbol_src + offset, length);
+                });
+        }
+
+        /// @return The number of threads working on an operation
+        uint32_t threads() const
+        {
+            assert(m_pool);
+            return m_pool->workers() + 1;
+        }
+
+    protected:
+
+        /// @param symbol_length The length of an operation
+        /// @return true if the operation should be split into stripes
+        bool is_parallel(uint32_t symbol_length) const
+        {
+            assert(m_pool);
+
+            return m_pool->workers() > 0 &&
+                symbol_length * sizeof(value_type) >= m_parallel_threshold &&
+                SuperCoder::is_concurrent_safe();
+        }
+
+        /// Splits an operation into one stripe per thread and waits for
+        /// all stripes to complete
+        /// @param symbol_length The length of the operation
+        /// @param function The function invoked with the offset and the
+        ///        length of every stripe
+        template<class Function>
+        void run_stripes(uint32_t symbol_length, const Function& function)
+        {
+            // Multiples of the stripe alignment keep the vector loops of
+            // the region kernels busy and avoid sharing cache lines
+            // between the threads
+            uint32_t alignment = stripe_alignment / sizeof(value_type);
+
+            uint32_t stripe_length =
+                (symbol_length + threads() - 1) / threads();
+
+            stripe_length =
+                ((stripe_length + alignment - 1) / alignment) * alignment;
+
+            uint32_t stripes =
+                (symbol_length + stripe_length - 1) / stripe_length;
+
+            m_pool->run(stripes,
+                [&](uint32_t stripe)
+                {
+                    uint32_t offset = stripe * stripe_length;
+                    uint32_t length =
+                        std::min(stripe_length, symbol_length - offset);
+
+                    function(offset, length);
+                });
+        }
+
+    private:
+
+        /// The thread pool
+        pool_pointer m_pool;
+
+        /// The parallel threshold in bytes
+        uint32_t m_parallel_threshold;
+    };
+
+}
@@ -53,6 +53,27 @@ namespace kodo
             SuperCoder::decode(symbol_data, symbol_id);
         }
 
+        /// Unpacks and decodes several payloads at once. The coded
+        /// symbols of the payloads are eliminated jointly, which requires
+        /// a batch_linear_block_decoder in the stack. The payload buffers
+        /// are used as scratch space while decoding.
+        /// @param payloads The buffers of the received payloads
+        /// @param count The number of payloads
+        void decode(uint8_t **payloads, uint32_t count)
+        {
+            assert(payloads != 0);
+
+            SuperCoder::begin_batch();
+
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                assert(payloads[i] != 0);
+                decode(payloads[i]);
+            }
+
+            SuperCoder::end_batch();
+        }
+
         /// @copydoc layer::payload_size() const
         uint32_t payload_size() const
         {
@@ -7,6 +7,8 @@
 
 #include <cstdint>
 
+#include "operations_phase.hpp"
+
 namespace kodo
 {
 
@@ -108,7 +110,42 @@ namespace kodo
         uint32_t recode(uint8_t *payload)
         {
             assert(m_recode_stack);
-            return m_recode_stack->encode(payload);
+
+            // The operations of the recoding stack are performed by
+            // this stack through the proxy layer
+            SuperCoder::push_operations_phase(operations_phase::recode);
+            uint32_t bytes_used = m_recode_stack->encode(payload);
+            SuperCoder::pop_operations_phase();
+
+            return bytes_used;
+        }
+
+        /// Produces several recoded payloads at once. The recoding
+        /// coefficients and headers of all payloads are generated first,
+        /// after which the symbol data of all payloads is computed in a
+        /// single pass over the stored symbols.
+        /// @param payloads The buffers for the recoded payloads, each must
+        ///        be at least payload_size() bytes
+        /// @param count The number of payloads to produce
+        /// @param bytes_used Will contain the number of bytes used by each
+        ///        of the payloads
+        void recode(uint8_t **payloads, uint32_t count, uint32_t *bytes_used)
+        {
+            assert(m_recode_stack);
+            assert(payloads != 0);
+            assert(bytes_used != 0);
+
+            SuperCoder::push_operations_phase(operations_phase::recode);
+            m_recode_stack->begin_batch();
+
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                assert(payloads[i] != 0);
+                bytes_used[i] = m_recode_stack->encode(payloads[i]);
+            }
+
+            m_recode_stack->end_batch();
+            SuperCoder::pop_operations_phase();
         }
 
         /// Make sure we have enough space for both the payload
@@ -7,6 +7,8 @@
 
 #include <cstdint>
 
+#include "operations_phase.hpp"
+
 namespace kodo
 {
 
@@ -409,6 +411,41 @@ namespace kodo
             return m_proxy->invert(value);
         }
 
+        /// @copydoc layer::push_operations_phase(operations_phase)
+        void push_operations_phase(operations_phase phase)
+        {
+            assert(m_proxy);
+            m_proxy->push_operations_phase(phase);
+        }
+
+        /// @copydoc layer::pop_operations_phase()
+        void pop_operations_phase()
+        {
+            assert(m_proxy);
+            m_proxy->pop_operations_phase();
+        }
+
+        /// @copydoc layer::is_concurrent_safe() const
+        bool is_concurrent_safe() const
+        {
+            assert(m_proxy);
+            return m_proxy->is_concurrent_safe();
+        }
+
+        /// @copydoc layer::push_operations_region(operations_region)
+        void push_operations_region(operations_region region)
+        {
+            assert(m_proxy);
+            m_proxy->push_operations_region(region);
+        }
+
+        /// @copydoc layer::pop_operations_region()
+        void pop_operations_region()
+        {
+            assert(m_proxy);
+            m_proxy->pop_operations_region();
+        }
+
         //------------------------------------------------------------------
         // CODEC API
         //------------------------------------------------------------------
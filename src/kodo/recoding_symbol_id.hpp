@@ -12,6 +12,8 @@
 
 #include <fifi/fifi_utils.hpp>
 
+#include "operations_phase.hpp"
+
 namespace kodo
 {
 
@@ -119,6 +121,9 @@ namespace kodo
             value_type *recode_coefficients
                 = reinterpret_cast<value_type*>(&m_coefficients[0]);
 
+            SuperCoder::push_operations_region(
+                operations_region::coefficients);
+
             for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
             {
                 value_type c =
@@ -148,6 +153,7 @@ namespace kodo
                 }
             }
 
+            SuperCoder::pop_operations_region();
 
             *coefficients = &m_coefficients[0];
             sak::copy_storage(
@@ -0,0 +1,198 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #include <cpuid.h>
+    #define KODO_REGION_KERNELS_X86 1
+#endif
+
+namespace kodo
+{
+
+    /// The instruction set used by the finite_field_math layer for the
+    /// region operations i.e. operations on entire symbols or coefficient
+    /// vectors. The values are ordered such that a higher value
+    /// represents a wider instruction set.
+    enum class region_kernel
+    {
+        /// Portable implementation provided by Fifi
+        scalar,
+        /// 128 bit SSSE3 split table lookups
+        ssse3,
+        /// 256 bit AVX2 split table lookups
+        avx2,
+        /// 512 bit AVX-512BW split table lookups
+        avx512,
+        /// 512 bit GFNI affine transformations
+        gfni
+    };
+
+    /// @param kernel The region kernel
+    /// @return A human readable name of the region kernel, e.g. for use
+    ///         in benchmark output
+    inline const char* region_kernel_name(region_kernel kernel)
+    {
+        switch(kernel)
+        {
+        case region_kernel::scalar:
+            return "scalar";
+        case region_kernel::ssse3:
+            return "ssse3";
+        case region_kernel::avx2:
+            return "avx2";
+        case region_kernel::avx512:
+            return "avx512";
+        case region_kernel::gfni:
+            return "gfni";
+        }
+
+        assert(0);
+        return "unknown";
+    }
+
+    /// @brief Queries the CPU (using the cpuid instruction) for the
+    ///        instruction sets usable by the region kernels.
+    ///
+    /// The AVX2 and AVX-512 checks also verify that the operating system
+    /// saves the extended register state, otherwise the instructions
+    /// cannot be used even if the CPU supports them. On compilers or
+    /// platforms where the detection is not available all instruction
+    /// sets are reported as unsupported.
+    class cpu_support
+    {
+    public:
+
+        /// Constructor runs the detection
+        cpu_support()
+            : m_ssse3(false),
+              m_avx2(false),
+              m_avx512bw(false),
+              m_gfni(false)
+        {
+#if defined(KODO_REGION_KERNELS_X86)
+            uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+            if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                return;
+
+            m_ssse3 = (ecx & bit_SSSE3) != 0;
+
+            bool osxsave = (ecx & bit_OSXSAVE) != 0;
+            bool avx = (ecx & bit_AVX) != 0;
+
+            if(!osxsave || !avx)
+                return;
+
+            uint64_t xcr0 = read_xcr0();
+
+            // The OS must save the XMM and YMM state
+            if((xcr0 & 0x6) != 0x6)
+                return;
+
+            if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+                return;
+
+            m_avx2 = (ebx & (1U << 5)) != 0;
+
+            // The OS must additionally save the opmask and ZMM state
+            bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+            m_avx512bw = zmm_state &&
+                (ebx & (1U << 16)) != 0 &&  // AVX-512F
+                (ebx & (1U << 30)) != 0;    // AVX-512BW
+
+            m_gfni = m_avx512bw && (ecx & (1U << 8)) != 0;
+#endif
+        }
+
+        /// @return true if the SSSE3 instruction set is available
+        bool has_ssse3() const
+        {
+            return m_ssse3;
+        }
+
+        /// @return true if the AVX2 instruction set is available
+        bool has_avx2() const
+        {
+            return m_avx2;
+        }
+
+        /// @return true if the AVX-512F and AVX-512BW instruction sets
+        ///         are available
+        bool has_avx512bw() const
+        {
+            return m_avx512bw;
+        }
+
+        /// @return true if the GFNI instructions are available together
+        ///         with AVX-512BW
+        bool has_gfni() const
+        {
+            return m_gfni;
+        }
+
+        /// @param kernel The region kernel
+        /// @return true if the CPU can run the given region kernel
+        bool supports(region_kernel kernel) const
+        {
+            switch(kernel)
+            {
+            case region_kernel::scalar:
+                return true;
+            case region_kernel::ssse3:
+                return m_ssse3;
+            case region_kernel::avx2:
+                return m_avx2;
+            case region_kernel::avx512:
+                return m_avx512bw;
+            case region_kernel::gfni:
+                return m_gfni;
+            }
+
+            return false;
+        }
+
+        /// @return The process wide cpu_support instance, the detection
+        ///         is only performed once
+        static const cpu_support& instance()
+        {
+            static cpu_support support;
+            return support;
+        }
+
+    private:
+
+#if defined(KODO_REGION_KERNELS_X86)
+        /// @return The XCR0 register describing the register state
+        ///         saved by the operating system
+        static uint64_t read_xcr0()
+        {
+            uint32_t eax = 0, edx = 0;
+            __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (uint64_t(edx) << 32) | eax;
+        }
+#endif
+
+    private:
+
+        /// SSSE3 support
+        bool m_ssse3;
+
+        /// AVX2 support
+        bool m_avx2;
+
+        /// AVX-512F and AVX-512BW support
+        bool m_avx512bw;
+
+        /// GFNI support
+        bool m_gfni;
+    };
+
+}
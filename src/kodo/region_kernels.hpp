@@ -0,0 +1,1068 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+#include <fifi/field_types.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "region_kernel.hpp"
+
+#if defined(KODO_REGION_KERNELS_X86)
+    #include <immintrin.h>
+    #define KODO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace kodo
+{
+
+    /// @ingroup finite_field_layers
+    /// @brief Instruction set specific implementations of the region
+    ///        operations used by the finite_field_math layer.
+    ///
+    /// The default implementation provides no kernels, in which case the
+    /// finite_field_math layer uses the Fifi implementation. The binary
+    /// extension fields fifi::binary, fifi::binary8 and fifi::binary16
+    /// are specialized below. Since subtraction equals addition in these
+    /// fields the subtract and multiply_subtract operations are handled
+    /// by the add and multiply_add kernels.
+    template<class Field>
+    class region_kernels
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef Field field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// Constructor
+        /// @param field The finite field implementation
+        /// @param kernel The region kernel to use
+        template<class FieldImpl>
+        region_kernels(const FieldImpl& field, region_kernel kernel)
+        {
+            (void) field;
+            (void) kernel;
+            assert(kernel == region_kernel::scalar);
+        }
+
+        /// @param kernel The region kernel
+        /// @return true if the kernel is implemented for the field and
+        ///         supported by the CPU
+        static bool is_supported(region_kernel kernel)
+        {
+            return kernel == region_kernel::scalar;
+        }
+
+        /// @return The widest region kernel supported
+        static region_kernel best_kernel()
+        {
+            return region_kernel::scalar;
+        }
+
+        /// @return The selected region kernel
+        region_kernel kernel() const
+        {
+            return region_kernel::scalar;
+        }
+
+        /// @return true if the kernels should be used instead of the
+        ///         Fifi implementation
+        bool is_accelerated() const
+        {
+            return false;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        template<class FieldImpl>
+        void multiply(const FieldImpl&, value_type*, value_type,
+                      uint32_t) const
+        {
+            assert(0);
+        }
+
+        /// @copydoc layer::multiply_add(value_type*, const value_type*,
+        ///                              value_type, uint32_t)
+        template<class FieldImpl>
+        void multiply_add(const FieldImpl&, value_type*, const value_type*,
+                          value_type, uint32_t) const
+        {
+            assert(0);
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type*, const value_type*, uint32_t) const
+        {
+            assert(0);
+        }
+    };
+
+    /// Helper returning the widest supported kernel among the ones
+    /// implemented for a field.
+    /// @param gfni true if the field implements the GFNI kernel
+    /// @return The widest region kernel supported by the CPU
+    inline region_kernel best_region_kernel(bool gfni)
+    {
+        const cpu_support& cpu = cpu_support::instance();
+
+        if(gfni && cpu.has_gfni())
+            return region_kernel::gfni;
+
+        if(cpu.has_avx512bw())
+            return region_kernel::avx512;
+
+        if(cpu.has_avx2())
+            return region_kernel::avx2;
+
+        if(cpu.has_ssse3())
+            return region_kernel::ssse3;
+
+        return region_kernel::scalar;
+    }
+
+#if defined(KODO_REGION_KERNELS_X86)
+
+    /// Replicates a 16 byte table into the four lanes of a 512 bit
+    /// register. The table is replicated in memory and loaded, since
+    /// GCC reports the undefined source register of the broadcast
+    /// intrinsic as uninitialized.
+    /// @param table The 16 byte table
+    /// @return The table in every 128 bit lane
+    KODO_TARGET("avx512f")
+    inline __m512i broadcast_table_avx512(const uint8_t *table)
+    {
+        alignas(64) uint8_t lanes[64];
+
+        for(uint32_t k = 0; k < 4; ++k)
+        {
+            std::copy_n(table, 16, lanes + 16 * k);
+        }
+
+        return _mm512_load_si512((const void*)lanes);
+    }
+
+    /// Split table kernels for the binary8 field. For a coefficient c
+    /// the product c * x is computed as lo[x & 0xf] ^ hi[x >> 4] where
+    /// the two 16 byte tables are looked up with the byte shuffle
+    /// instructions.
+    struct binary8_split_kernels
+    {
+        template<bool Accumulate>
+        KODO_TARGET("ssse3")
+        static void ssse3(uint8_t *dest, const uint8_t *src,
+                          const uint8_t *lo, const uint8_t *hi,
+                          uint32_t length)
+        {
+            const __m128i table_lo = _mm_loadu_si128((const __m128i*)lo);
+            const __m128i table_hi = _mm_loadu_si128((const __m128i*)hi);
+            const __m128i mask = _mm_set1_epi8(0x0f);
+
+            uint32_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+
+                __m128i l = _mm_and_si128(x, mask);
+                __m128i h = _mm_and_si128(_mm_srli_epi64(x, 4), mask);
+
+                __m128i p = _mm_xor_si128(_mm_shuffle_epi8(table_lo, l),
+                                          _mm_shuffle_epi8(table_hi, h));
+
+                if(Accumulate)
+                {
+                    p = _mm_xor_si128(
+                        p, _mm_loadu_si128((const __m128i*)(dest + i)));
+                }
+
+                _mm_storeu_si128((__m128i*)(dest + i), p);
+            }
+
+            tail<Accumulate>(dest, src, lo, hi, i, length);
+        }
+
+        template<bool Accumulate>
+        KODO_TARGET("avx2")
+        static void avx2(uint8_t *dest, const uint8_t *src,
+                         const uint8_t *lo, const uint8_t *hi,
+                         uint32_t length)
+        {
+            const __m256i table_lo = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i*)lo));
+            const __m256i table_hi = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i*)hi));
+            const __m256i mask = _mm256_set1_epi8(0x0f);
+
+            uint32_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+
+                __m256i l = _mm256_and_si256(x, mask);
+                __m256i h = _mm256_and_si256(_mm256_srli_epi64(x, 4), mask);
+
+                __m256i p = _mm256_xor_si256(
+                    _mm256_shuffle_epi8(table_lo, l),
+                    _mm256_shuffle_epi8(table_hi, h));
+
+                if(Accumulate)
+                {
+                    p = _mm256_xor_si256(
+                        p, _mm256_loadu_si256((const __m256i*)(dest + i)));
+                }
+
+                _mm256_storeu_si256((__m256i*)(dest + i), p);
+            }
+
+            tail<Accumulate>(dest, src, lo, hi, i, length);
+        }
+
+        template<bool Accumulate>
+        KODO_TARGET("avx512f,avx512bw")
+        static void avx512(uint8_t *dest, const uint8_t *src,
+                           const uint8_t *lo, const uint8_t *hi,
+                           uint32_t length)
+        {
+            const __m512i table_lo = broadcast_table_avx512(lo);
+            const __m512i table_hi = broadcast_table_avx512(hi);
+            const __m512i mask = _mm512_set1_epi8(0x0f);
+
+            uint32_t i = 0;
+            for(; i + 64 <= length; i += 64)
+            {
+                __m512i x = _mm512_loadu_si512((const void*)(src + i));
+
+                __m512i l = _mm512_and_si512(x, mask);
+                __m512i h = _mm512_and_si512(_mm512_srli_epi16(x, 4), mask);
+
+                __m512i p = _mm512_xor_si512(
+                    _mm512_shuffle_epi8(table_lo, l),
+                    _mm512_shuffle_epi8(table_hi, h));
+
+                if(Accumulate)
+                {
+                    p = _mm512_xor_si512(
+                        p, _mm512_loadu_si512((const void*)(dest + i)));
+                }
+
+                _mm512_storeu_si512((void*)(dest + i), p);
+            }
+
+            tail<Accumulate>(dest, src, lo, hi, i, length);
+        }
+
+        template<bool Accumulate>
+        KODO_TARGET("avx512f,avx512bw,gfni")
+        static void gfni(uint8_t *dest, const uint8_t *src,
+                         uint64_t affine, const uint8_t *lo,
+                         const uint8_t *hi, uint32_t length)
+        {
+            const __m512i matrix = _mm512_set1_epi64((long long)affine);
+
+            uint32_t i = 0;
+            for(; i + 64 <= length; i += 64)
+            {
+                __m512i x = _mm512_loadu_si512((const void*)(src + i));
+                __m512i p = _mm512_gf2p8affine_epi64_epi8(x, matrix, 0);
+
+                if(Accumulate)
+                {
+                    p = _mm512_xor_si512(
+                        p, _mm512_loadu_si512((const void*)(dest + i)));
+                }
+
+                _mm512_storeu_si512((void*)(dest + i), p);
+            }
+
+            tail<Accumulate>(dest, src, lo, hi, i, length);
+        }
+
+        /// Processes the bytes not covered by a full vector
+        template<bool Accumulate>
+        static void tail(uint8_t *dest, const uint8_t *src,
+                         const uint8_t *lo, const uint8_t *hi,
+                         uint32_t i, uint32_t length)
+        {
+            for(; i < length; ++i)
+            {
+                uint8_t p = lo[src[i] & 0x0f] ^ hi[src[i] >> 4];
+                dest[i] = Accumulate ? (dest[i] ^ p) : p;
+            }
+        }
+    };
+
+    /// Split table kernels for the binary16 field. For a coefficient c
+    /// the product c * x is the sum of four 16 bit table lookups, one per
+    /// nibble of x. Each 16 bit table is stored as a table of low bytes
+    /// and a table of high bytes. The vector kernels therefore first
+    /// separate the low and high bytes of 16 elements, perform the
+    /// eight byte shuffles and finally interleave the result bytes.
+    struct binary16_split_kernels
+    {
+        /// The tables for one coefficient, the low byte tables are
+        /// stored first followed by the high byte tables
+        struct tables
+        {
+            uint8_t m_lo[4][16];
+            uint8_t m_hi[4][16];
+        };
+
+        template<bool Accumulate>
+        KODO_TARGET("ssse3")
+        static void ssse3(uint16_t *dest, const uint16_t *src,
+                          const tables &t, uint32_t length)
+        {
+            const __m128i split = _mm_setr_epi8(
+                0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+            const __m128i mask = _mm_set1_epi8(0x0f);
+
+            __m128i lo[4];
+            __m128i hi[4];
+
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                lo[k] = _mm_loadu_si128((const __m128i*)t.m_lo[k]);
+                hi[k] = _mm_loadu_si128((const __m128i*)t.m_hi[k]);
+            }
+
+            uint32_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                __m128i a = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i*)(src + i)), split);
+                __m128i b = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i*)(src + i + 8)), split);
+
+                __m128i low_bytes = _mm_unpacklo_epi64(a, b);
+                __m128i high_bytes = _mm_unpackhi_epi64(a, b);
+
+                __m128i n[4];
+                n[0] = _mm_and_si128(low_bytes, mask);
+                n[1] = _mm_and_si128(_mm_srli_epi64(low_bytes, 4), mask);
+                n[2] = _mm_and_si128(high_bytes, mask);
+                n[3] = _mm_and_si128(_mm_srli_epi64(high_bytes, 4), mask);
+
+                __m128i rl = _mm_setzero_si128();
+                __m128i rh = _mm_setzero_si128();
+
+                for(uint32_t k = 0; k < 4; ++k)
+                {
+                    rl = _mm_xor_si128(rl, _mm_shuffle_epi8(lo[k], n[k]));
+                    rh = _mm_xor_si128(rh, _mm_shuffle_epi8(hi[k], n[k]));
+                }
+
+                __m128i ra = _mm_unpacklo_epi8(rl, rh);
+                __m128i rb = _mm_unpackhi_epi8(rl, rh);
+
+                if(Accumulate)
+                {
+                    ra = _mm_xor_si128(
+                        ra, _mm_loadu_si128((const __m128i*)(dest + i)));
+                    rb = _mm_xor_si128(
+                        rb, _mm_loadu_si128((const __m128i*)(dest + i + 8)));
+                }
+
+                _mm_storeu_si128((__m128i*)(dest + i), ra);
+                _mm_storeu_si128((__m128i*)(dest + i + 8), rb);
+            }
+
+            tail<Accumulate>(dest, src, t, i, length);
+        }
+
+        template<bool Accumulate>
+        KODO_TARGET("avx2")
+        static void avx2(uint16_t *dest, const uint16_t *src,
+                         const tables &t, uint32_t length)
+        {
+            // The byte shuffles operate within each 128 bit lane, so the
+            // separated bytes of two input vectors end up in the same
+            // lane order as the input elements
+            const __m256i split = _mm256_setr_epi8(
+                0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+            const __m256i mask = _mm256_set1_epi8(0x0f);
+
+            __m256i lo[4];
+            __m256i hi[4];
+
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                lo[k] = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i*)t.m_lo[k]));
+                hi[k] = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i*)t.m_hi[k]));
+            }
+
+            uint32_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                __m256i a = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256((const __m256i*)(src + i)), split);
+                __m256i b = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256((const __m256i*)(src + i + 16)),
+                    split);
+
+                __m256i low_bytes = _mm256_unpacklo_epi64(a, b);
+                __m256i high_bytes = _mm256_unpackhi_epi64(a, b);
+
+                __m256i n[4];
+                n[0] = _mm256_and_si256(low_bytes, mask);
+                n[1] = _mm256_and_si256(
+                    _mm256_srli_epi64(low_bytes, 4), mask);
+                n[2] = _mm256_and_si256(high_bytes, mask);
+                n[3] = _mm256_and_si256(
+                    _mm256_srli_epi64(high_bytes, 4), mask);
+
+                __m256i rl = _mm256_setzero_si256();
+                __m256i rh = _mm256_setzero_si256();
+
+                for(uint32_t k = 0; k < 4; ++k)
+                {
+                    rl = _mm256_xor_si256(
+                        rl, _mm256_shuffle_epi8(lo[k], n[k]));
+                    rh = _mm256_xor_si256(
+                        rh, _mm256_shuffle_epi8(hi[k], n[k]));
+                }
+
+                __m256i ra = _mm256_unpacklo_epi8(rl, rh);
+                __m256i rb = _mm256_unpackhi_epi8(rl, rh);
+
+                if(Accumulate)
+                {
+                    ra = _mm256_xor_si256(
+                        ra, _mm256_loadu_si256((const __m256i*)(dest + i)));
+                    rb = _mm256_xor_si256(
+                        rb, _mm256_loadu_si256(
+                            (const __m256i*)(dest + i + 16)));
+                }
+
+                _mm256_storeu_si256((__m256i*)(dest + i), ra);
+                _mm256_storeu_si256((__m256i*)(dest + i + 16), rb);
+            }
+
+            tail<Accumulate>(dest, src, t, i, length);
+        }
+
+        template<bool Accumulate>
+        KODO_TARGET("avx512f,avx512bw")
+        static void avx512(uint16_t *dest, const uint16_t *src,
+                           const tables &t, uint32_t length)
+        {
+            static const uint8_t split_table[16] =
+                { 0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15 };
+
+            const __m512i split = broadcast_table_avx512(split_table);
+            const __m512i mask = _mm512_set1_epi8(0x0f);
+
+            __m512i lo[4];
+            __m512i hi[4];
+
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                lo[k] = broadcast_table_avx512(t.m_lo[k]);
+                hi[k] = broadcast_table_avx512(t.m_hi[k]);
+            }
+
+            uint32_t i = 0;
+            for(; i + 64 <= length; i += 64)
+            {
+                __m512i a = _mm512_shuffle_epi8(
+                    _mm512_loadu_si512((const void*)(src + i)), split);
+                __m512i b = _mm512_shuffle_epi8(
+                    _mm512_loadu_si512((const void*)(src + i + 32)), split);
+
+                // The zero masking forms take no undefined source,
+                // which GCC reports as uninitialized
+                __m512i low_bytes = _mm512_maskz_unpacklo_epi64(0xff, a, b);
+                __m512i high_bytes = _mm512_maskz_unpackhi_epi64(0xff, a, b);
+
+                __m512i n[4];
+                n[0] = _mm512_and_si512(low_bytes, mask);
+                n[1] = _mm512_and_si512(
+                    _mm512_srli_epi16(low_bytes, 4), mask);
+                n[2] = _mm512_and_si512(high_bytes, mask);
+                n[3] = _mm512_and_si512(
+                    _mm512_srli_epi16(high_bytes, 4), mask);
+
+                __m512i rl = _mm512_setzero_si512();
+                __m512i rh = _mm512_setzero_si512();
+
+                for(uint32_t k = 0; k < 4; ++k)
+                {
+                    rl = _mm512_xor_si512(
+                        rl, _mm512_shuffle_epi8(lo[k], n[k]));
+                    rh = _mm512_xor_si512(
+                        rh, _mm512_shuffle_epi8(hi[k], n[k]));
+                }
+
+                __m512i ra = _mm512_unpacklo_epi8(rl, rh);
+                __m512i rb = _mm512_unpackhi_epi8(rl, rh);
+
+                if(Accumulate)
+                {
+                    ra = _mm512_xor_si512(
+                        ra, _mm512_loadu_si512((const void*)(dest + i)));
+                    rb = _mm512_xor_si512(
+                        rb, _mm512_loadu_si512((const void*)(dest + i + 32)));
+                }
+
+                _mm512_storeu_si512((void*)(dest + i), ra);
+                _mm512_storeu_si512((void*)(dest + i + 32), rb);
+            }
+
+            tail<Accumulate>(dest, src, t, i, length);
+        }
+
+        /// Processes the elements not covered by a full vector
+        template<bool Accumulate>
+        static void tail(uint16_t *dest, const uint16_t *src,
+                         const tables &t, uint32_t i, uint32_t length)
+        {
+            for(; i < length; ++i)
+            {
+                uint16_t x = src[i];
+                uint16_t p = 0;
+
+                for(uint32_t k = 0; k < 4; ++k)
+                {
+                    uint32_t nibble = (x >> (4 * k)) & 0x0f;
+                    p ^= uint16_t(t.m_lo[k][nibble] |
+                                  (t.m_hi[k][nibble] << 8));
+                }
+
+                dest[i] = Accumulate ? uint16_t(dest[i] ^ p) : p;
+            }
+        }
+    };
+
+    /// Addition kernels i.e. dest[i] = dest[i] ^ src[i] on bytes
+    struct xor_kernels
+    {
+        KODO_TARGET("sse2")
+        static void sse2(uint8_t *dest, const uint8_t *src, uint32_t length)
+        {
+            uint32_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+                _mm_storeu_si128((__m128i*)(dest + i), _mm_xor_si128(d, s));
+            }
+
+            tail(dest, src, i, length);
+        }
+
+        KODO_TARGET("avx2")
+        static void avx2(uint8_t *dest, const uint8_t *src, uint32_t length)
+        {
+            uint32_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+                __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+                _mm256_storeu_si256((__m256i*)(dest + i),
+                                    _mm256_xor_si256(d, s));
+            }
+
+            tail(dest, src, i, length);
+        }
+
+        KODO_TARGET("avx512f")
+        static void avx512(uint8_t *dest, const uint8_t *src,
+                           uint32_t length)
+        {
+            uint32_t i = 0;
+            for(; i + 64 <= length; i += 64)
+            {
+                __m512i d = _mm512_loadu_si512((const void*)(dest + i));
+                __m512i s = _mm512_loadu_si512((const void*)(src + i));
+                _mm512_storeu_si512((void*)(dest + i),
+                                    _mm512_xor_si512(d, s));
+            }
+
+            tail(dest, src, i, length);
+        }
+
+        /// Processes the bytes not covered by a full vector
+        static void tail(uint8_t *dest, const uint8_t *src,
+                         uint32_t i, uint32_t length)
+        {
+            for(; i < length; ++i)
+            {
+                dest[i] ^= src[i];
+            }
+        }
+
+        /// Dispatches to the selected kernel
+        static void run(region_kernel kernel, uint8_t *dest,
+                        const uint8_t *src, uint32_t length)
+        {
+            switch(kernel)
+            {
+            case region_kernel::ssse3:
+                sse2(dest, src, length);
+                break;
+            case region_kernel::avx2:
+                avx2(dest, src, length);
+                break;
+            case region_kernel::avx512:
+            case region_kernel::gfni:
+                avx512(dest, src, length);
+                break;
+            default:
+                tail(dest, src, 0, length);
+                break;
+            }
+        }
+    };
+
+    /// Region kernels for the binary field, the data is bit packed so
+    /// only the addition needs a kernel.
+    template<>
+    class region_kernels<fifi::binary>
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef fifi::binary field_type;
+
+        /// @copydoc layer::value_type
+        typedef field_type::value_type value_type;
+
+    public:
+
+        /// @copydoc region_kernels::region_kernels(const FieldImpl&,
+        ///                                         region_kernel)
+        template<class FieldImpl>
+        region_kernels(const FieldImpl& field, region_kernel kernel)
+            : m_kernel(kernel)
+        {
+            (void) field;
+            assert(is_supported(kernel));
+        }
+
+        /// @copydoc region_kernels::is_supported(region_kernel)
+        static bool is_supported(region_kernel kernel)
+        {
+            return kernel != region_kernel::gfni &&
+                cpu_support::instance().supports(kernel);
+        }
+
+        /// @copydoc region_kernels::best_kernel()
+        static region_kernel best_kernel()
+        {
+            return best_region_kernel(false);
+        }
+
+        /// @copydoc region_kernels::kernel() const
+        region_kernel kernel() const
+        {
+            return m_kernel;
+        }
+
+        /// @copydoc region_kernels::is_accelerated() const
+        bool is_accelerated() const
+        {
+            return m_kernel != region_kernel::scalar;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        template<class FieldImpl>
+        void multiply(const FieldImpl&, value_type *symbol_dest,
+                      value_type coefficient, uint32_t symbol_length) const
+        {
+            if(!coefficient)
+            {
+                std::fill_n(symbol_dest, symbol_length, 0);
+            }
+        }
+
+        /// @copydoc layer::multiply_add(value_type*, const value_type*,
+        ///                              value_type, uint32_t)
+        template<class FieldImpl>
+        void multiply_add(const FieldImpl&, value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient,
+                          uint32_t symbol_length) const
+        {
+            if(coefficient)
+            {
+                add(symbol_dest, symbol_src, symbol_length);
+            }
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length) const
+        {
+            xor_kernels::run(m_kernel, symbol_dest, symbol_src,
+                             symbol_length);
+        }
+
+    private:
+
+        /// The selected kernel
+        region_kernel m_kernel;
+    };
+
+    /// Region kernels for the binary8 field. The split tables and the
+    /// GFNI matrices are computed for all 256 coefficients up front.
+    template<>
+    class region_kernels<fifi::binary8>
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef fifi::binary8 field_type;
+
+        /// @copydoc layer::value_type
+        typedef field_type::value_type value_type;
+
+    public:
+
+        /// @copydoc region_kernels::region_kernels(const FieldImpl&,
+        ///                                         region_kernel)
+        template<class FieldImpl>
+        region_kernels(const FieldImpl& field, region_kernel kernel)
+            : m_kernel(kernel),
+              m_tables(256 * 32),
+              m_affine(256, 0)
+        {
+            assert(is_supported(kernel));
+
+            for(uint32_t c = 0; c < 256; ++c)
+            {
+                uint8_t *lo = &m_tables[c * 32];
+                uint8_t *hi = lo + 16;
+
+                for(uint32_t n = 0; n < 16; ++n)
+                {
+                    lo[n] = field.multiply(value_type(c), value_type(n));
+                    hi[n] = field.multiply(value_type(c), value_type(n << 4));
+                }
+
+                // The GF2P8AFFINEQB instruction computes output bit i as
+                // the parity of the input masked with byte 7 - i of the
+                // matrix. Multiplying by c is linear, so bit j of that
+                // byte is bit i of c * x^j.
+                uint64_t affine = 0;
+                for(uint32_t j = 0; j < 8; ++j)
+                {
+                    value_type column =
+                        field.multiply(value_type(c), value_type(1U << j));
+
+                    for(uint32_t i = 0; i < 8; ++i)
+                    {
+                        if((column >> i) & 1U)
+                            affine |= uint64_t(1) << (8 * (7 - i) + j);
+                    }
+                }
+
+                m_affine[c] = affine;
+            }
+        }
+
+        /// @copydoc region_kernels::is_supported(region_kernel)
+        static bool is_supported(region_kernel kernel)
+        {
+            return cpu_support::instance().supports(kernel);
+        }
+
+        /// @copydoc region_kernels::best_kernel()
+        static region_kernel best_kernel()
+        {
+            return best_region_kernel(true);
+        }
+
+        /// @copydoc region_kernels::kernel() const
+        region_kernel kernel() const
+        {
+            return m_kernel;
+        }
+
+        /// @copydoc region_kernels::is_accelerated() const
+        bool is_accelerated() const
+        {
+            return m_kernel != region_kernel::scalar;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        template<class FieldImpl>
+        void multiply(const FieldImpl&, value_type *symbol_dest,
+                      value_type coefficient, uint32_t symbol_length) const
+        {
+            run<false>(symbol_dest, symbol_dest, coefficient, symbol_length);
+        }
+
+        /// @copydoc layer::multiply_add(value_type*, const value_type*,
+        ///                              value_type, uint32_t)
+        template<class FieldImpl>
+        void multiply_add(const FieldImpl&, value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient,
+                          uint32_t symbol_length) const
+        {
+            if(coefficient)
+            {
+                run<true>(symbol_dest, symbol_src, coefficient,
+                          symbol_length);
+            }
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length) const
+        {
+            xor_kernels::run(m_kernel, symbol_dest, symbol_src,
+                             symbol_length);
+        }
+
+    private:
+
+        /// Dispatches to the selected kernel
+        template<bool Accumulate>
+        void run(value_type *dest, const value_type *src,
+                 value_type coefficient, uint32_t length) const
+        {
+            const uint8_t *lo = &m_tables[coefficient * 32];
+            const uint8_t *hi = lo + 16;
+
+            switch(m_kernel)
+            {
+            case region_kernel::ssse3:
+                binary8_split_kernels::ssse3<Accumulate>(
+                    dest, src, lo, hi, length);
+                break;
+            case region_kernel::avx2:
+                binary8_split_kernels::avx2<Accumulate>(
+                    dest, src, lo, hi, length);
+                break;
+            case region_kernel::avx512:
+                binary8_split_kernels::avx512<Accumulate>(
+                    dest, src, lo, hi, length);
+                break;
+            case region_kernel::gfni:
+                binary8_split_kernels::gfni<Accumulate>(
+                    dest, src, m_affine[coefficient], lo, hi, length);
+                break;
+            default:
+                binary8_split_kernels::tail<Accumulate>(
+                    dest, src, lo, hi, 0, length);
+                break;
+            }
+        }
+
+    private:
+
+        /// The selected kernel
+        region_kernel m_kernel;
+
+        /// The aligned storage type
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// The low and high nibble tables for every coefficient
+        aligned_vector m_tables;
+
+        /// The GFNI affine matrices for every coefficient
+        std::vector<uint64_t> m_affine;
+    };
+
+    /// Region kernels for the binary16 field. Precomputing the tables
+    /// for all 2^16 coefficients would use 8 MB, so the tables are built
+    /// for the coefficient on every call from the 16 products c * x^j.
+    /// Building the tables costs about as much as multiplying 250
+    /// elements with the field implementation, so shorter regions, e.g.
+    /// the coefficient vectors of small generations, are multiplied
+    /// element by element instead.
+    template<>
+    class region_kernels<fifi::binary16>
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef fifi::binary16 field_type;
+
+        /// @copydoc layer::value_type
+        typedef field_type::value_type value_type;
+
+        /// The tables type
+        typedef binary16_split_kernels::tables tables;
+
+        /// The length in value_type elements from which the tables are
+        /// built. Measured with the log table field, building the tables
+        /// costs roughly 500 ns and the ssse3 and avx2 kernels overtake
+        /// the field implementation at about 250 elements.
+        static const uint32_t table_threshold = 256;
+
+    public:
+
+        /// @copydoc region_kernels::region_kernels(const FieldImpl&,
+        ///                                         region_kernel)
+        template<class FieldImpl>
+        region_kernels(const FieldImpl& field, region_kernel kernel)
+            : m_kernel(kernel)
+        {
+            (void) field;
+            assert(is_supported(kernel));
+        }
+
+        /// @copydoc region_kernels::is_supported(region_kernel)
+        static bool is_supported(region_kernel kernel)
+        {
+            return kernel != region_kernel::gfni &&
+                cpu_support::instance().supports(kernel);
+        }
+
+        /// @copydoc region_kernels::best_kernel()
+        static region_kernel best_kernel()
+        {
+            return best_region_kernel(false);
+        }
+
+        /// @copydoc region_kernels::kernel() const
+        region_kernel kernel() const
+        {
+            return m_kernel;
+        }
+
+        /// @copydoc region_kernels::is_accelerated() const
+        bool is_accelerated() const
+        {
+            return m_kernel != region_kernel::scalar;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        template<class FieldImpl>
+        void multiply(const FieldImpl& field, value_type *symbol_dest,
+                      value_type coefficient, uint32_t symbol_length) const
+        {
+            if(symbol_length < table_threshold)
+            {
+                for(uint32_t i = 0; i < symbol_length; ++i)
+                {
+                    symbol_dest[i] =
+                        field.multiply(symbol_dest[i], coefficient);
+                }
+                return;
+            }
+
+            tables t;
+            build_tables(field, coefficient, t);
+
+            run<false>(symbol_dest, symbol_dest, t, symbol_length);
+        }
+
+        /// @copydoc layer::multiply_add(value_type*, const value_type*,
+        ///                              value_type, uint32_t)
+        template<class FieldImpl>
+        void multiply_add(const FieldImpl& field, value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient,
+                          uint32_t symbol_length) const
+        {
+            if(!coefficient)
+                return;
+
+            if(symbol_length < table_threshold)
+            {
+                for(uint32_t i = 0; i < symbol_length; ++i)
+                {
+                    symbol_dest[i] ^=
+                        field.multiply(symbol_src[i], coefficient);
+                }
+                return;
+            }
+
+            tables t;
+            build_tables(field, coefficient, t);
+
+            run<true>(symbol_dest, symbol_src, t, symbol_length);
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length) const
+        {
+            xor_kernels::run(m_kernel,
+                             reinterpret_cast<uint8_t*>(symbol_dest),
+                             reinterpret_cast<const uint8_t*>(symbol_src),
+                             symbol_length * sizeof(value_type));
+        }
+
+    private:
+
+        /// Builds the split tables for a coefficient
+        template<class FieldImpl>
+        static void build_tables(const FieldImpl& field,
+                                 value_type coefficient, tables &t)
+        {
+            value_type basis[16];
+            for(uint32_t j = 0; j < 16; ++j)
+            {
+                basis[j] = field.multiply(coefficient, value_type(1U << j));
+            }
+
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                for(uint32_t n = 0; n < 16; ++n)
+                {
+                    value_type product = 0;
+                    for(uint32_t b = 0; b < 4; ++b)
+                    {
+                        if((n >> b) & 1U)
+                            product ^= basis[4 * k + b];
+                    }
+
+                    t.m_lo[k][n] = uint8_t(product & 0xff);
+                    t.m_hi[k][n] = uint8_t(product >> 8);
+                }
+            }
+        }
+
+        /// Dispatches to the selected kernel
+        template<bool Accumulate>
+        void run(value_type *dest, const value_type *src,
+                 const tables &t, uint32_t length) const
+        {
+            switch(m_kernel)
+            {
+            case region_kernel::ssse3:
+                binary16_split_kernels::ssse3<Accumulate>(
+                    dest, src, t, length);
+                break;
+            case region_kernel::avx2:
+                binary16_split_kernels::avx2<Accumulate>(
+                    dest, src, t, length);
+                break;
+            case region_kernel::avx512:
+                binary16_split_kernels::avx512<Accumulate>(
+                    dest, src, t, length);
+                break;
+            default:
+                binary16_split_kernels::tail<Accumulate>(
+                    dest, src, t, 0, length);
+                break;
+            }
+        }
+
+    private:
+
+        /// The selected kernel
+        region_kernel m_kernel;
+    };
+
+#endif
+
+}
@@ -0,0 +1,144 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include <sak/storage.hpp>
+
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Buffers the received symbols and their coefficient
+    ///        vectors without performing any elimination.
+    ///
+    /// Every accepted symbol is stored in the next free slot of the
+    /// symbol and coefficient storage, i.e. slot i holds the i'th
+    /// received symbol and not the i'th source symbol. A recoding stack
+    /// on top of this layer therefore produces random combinations of
+    /// the buffered symbols, which is all a relay needs in order to
+    /// forward coded symbols. Uncoded symbols are stored together with
+    /// the corresponding unit coefficient vector.
+    ///
+    /// Once the buffer is full additional symbols are dropped. Use the
+    /// innovative_symbol_filter layer on top of this layer to avoid
+    /// spending slots on non-innovative symbols.
+    template<class SuperCoder>
+    class relay_symbol_buffer : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// Constructor
+        relay_symbol_buffer()
+            : m_buffered(0)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_buffered = 0;
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_coefficients != 0);
+
+            if(is_complete())
+            {
+                return;
+            }
+
+            SuperCoder::set_coefficients(
+                m_buffered, sak::storage(symbol_coefficients,
+                                         SuperCoder::coefficients_size()));
+
+            store_symbol(symbol_data);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+            assert(symbol_data != 0);
+
+            if(is_complete())
+            {
+                return;
+            }
+
+            value_type *coefficients =
+                SuperCoder::coefficients_value(m_buffered);
+
+            std::fill_n(coefficients, SuperCoder::coefficients_length(), 0);
+            fifi::set_value<field_type>(coefficients, symbol_index, 1U);
+
+            store_symbol(symbol_data);
+        }
+
+        /// @return True if every slot of the buffer is occupied
+        /// @copydoc layer::is_complete() const
+        bool is_complete() const
+        {
+            return m_buffered == SuperCoder::symbols();
+        }
+
+        /// The number of buffered symbols. Note that this is only the
+        /// rank of the buffered symbols if non-innovative symbols have
+        /// been filtered out before reaching this layer.
+        /// @copydoc layer::rank() const
+        uint32_t rank() const
+        {
+            return m_buffered;
+        }
+
+        /// @return True if the slot holds a buffered symbol
+        /// @copydoc layer::symbol_pivot(uint32_t) const
+        bool symbol_pivot(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+            return index < m_buffered;
+        }
+
+    private:
+
+        /// Copies the symbol data into the next free slot
+        /// @param symbol_data The data of the received symbol
+        void store_symbol(const uint8_t *symbol_data)
+        {
+            SuperCoder::set_symbol(
+                m_buffered,
+                sak::storage(symbol_data, SuperCoder::symbol_size()));
+
+            ++m_buffered;
+        }
+
+    protected:
+
+        /// The number of buffered symbols
+        uint32_t m_buffered;
+
+    };
+
+}
@@ -0,0 +1,99 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <fifi/default_field.hpp>
+
+#include "seed_codes.hpp"
+#include "../band_uniform_generator.hpp"
+#include "../band_linear_block_decoder.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup fec_stacks
+    /// @brief Complete stack implementing a band structured RLNC encoder.
+    ///
+    /// The coding vectors only have nonzero coefficients within a
+    /// cyclic window of band_width() symbols starting at a random
+    /// offset, see the band_uniform_generator. As for the
+    /// seed_rlnc_encoder only the seed is sent as the symbol id. The band
+    /// width is set on the factory and must match the one used by the
+    /// decoder.
+    template<class Field>
+    class band_rlnc_encoder
+        : public // Payload Codec API
+                 payload_encoder<
+                 // Codec Header API
+                 systematic_encoder<
+                 symbol_id_encoder<
+                 // Symbol ID API
+                 seed_symbol_id_writer<
+                 // Coefficient Generator API
+                 band_uniform_generator<
+                 // Codec API
+                 encode_symbol_tracker<
+                 zero_symbol_encoder<
+                 linear_block_encoder<
+                 storage_aware_encoder<
+                 // Coefficient Storage API
+                 coefficient_info<
+                 // Symbol Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 band_rlnc_encoder<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a band structured RLNC decoder.
+    ///
+    /// Regenerates the band structured coding vectors from the seed and
+    /// decodes them with the band_linear_block_decoder, which limits
+    /// the elimination to the band of every symbol. This makes large
+    /// generations practical.
+    template<class Field>
+    class band_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 seed_symbol_id_reader<
+                 // Coefficient Generator API
+                 band_uniform_generator<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 band_linear_block_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field Math API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 band_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+}
@@ -0,0 +1,131 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "on_the_fly_codes.hpp"
+#include "../compact_payload_rank_encoder.hpp"
+#include "../compact_payload_rank_decoder.hpp"
+#include "../compact_systematic_encoder.hpp"
+#include "../compact_systematic_decoder.hpp"
+#include "../truncated_symbol_id_writer.hpp"
+#include "../truncated_symbol_id_reader.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup fec_stacks
+    /// @brief The on_the_fly_encoder with compact headers.
+    ///
+    /// The encoder rank, the systematic flag and the symbol index are
+    /// written as varints, and the coefficients of the symbols not yet
+    /// specified are omitted from the symbol id. For small symbols and
+    /// generations this considerably reduces the header overhead.
+    template<class Field>
+    class compact_on_the_fly_encoder :
+        public // Payload Codec API
+               compact_payload_rank_encoder<
+               payload_encoder<
+               // Codec Header API
+               compact_systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               truncated_symbol_id_writer<
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               storage_aware_generator<
+               uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               rank_info<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               compact_on_the_fly_encoder<Field>
+               > > > > > > > > > > > > > > > > > > > >
+    { };
+
+    /// Recoding stack producing symbols with the compact headers of the
+    /// compact_on_the_fly_encoder.
+    /// @copydoc on_the_fly_recoding_stack
+    template<class MainStack>
+    class compact_on_the_fly_recoding_stack
+        : public // Payload API
+                 compact_payload_rank_encoder<
+                 payload_encoder<
+                 // Codec Header API
+                 compact_non_systematic_encoder<
+                 symbol_id_encoder<
+                 // Symbol ID API
+                 truncated_symbol_id_writer<
+                 recoding_symbol_id<
+                 // Coefficient Generator API
+                 uniform_generator<
+                 // Codec API
+                 encode_symbol_tracker<
+                 zero_symbol_encoder<
+                 batch_linear_block_encoder<
+                 linear_block_encoder<
+                 rank_info<
+                 // Proxy
+                 proxy_layer<
+                 compact_on_the_fly_recoding_stack<MainStack>,
+                 MainStack> > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief The on_the_fly_decoder for the compact headers.
+    ///
+    /// Decodes the symbols produced by the compact_on_the_fly_encoder and
+    /// recodes using the compact_on_the_fly_recoding_stack.
+    template<class Field>
+    class compact_on_the_fly_decoder :
+        public // Payload API
+               partial_decoding_tracker<
+               payload_recoder<compact_on_the_fly_recoding_stack,
+               compact_payload_rank_decoder<
+               payload_decoder<
+               // Codec Header API
+               compact_systematic_decoder<
+               symbol_id_decoder<
+               // Symbol ID API
+               truncated_symbol_id_reader<
+               plain_symbol_id_reader<
+               // Codec API
+               aligned_coefficients_decoder<
+               forward_linear_block_decoder<
+               rank_info<
+               // Coefficient Storage API
+               coefficient_storage<
+               coefficient_info<
+               // Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               compact_on_the_fly_decoder<Field>
+               > > > > > > > > > > > > > > > > > > >
+    { };
+
+}
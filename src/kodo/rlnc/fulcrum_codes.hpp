@@ -0,0 +1,171 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <fifi/default_field.hpp>
+
+#include "full_vector_codes.hpp"
+#include "../shallow_symbol_storage.hpp"
+#include "../fulcrum_expansion_info.hpp"
+#include "../fulcrum_expansion_encoder.hpp"
+#include "../fulcrum_outer_header_decoder.hpp"
+
+namespace kodo
+{
+
+    /// Outer encoder of the fulcrum codes. Computes the outer code
+    /// symbols directly from the source symbols stored in the
+    /// fulcrum_encoder.
+    template<class OuterField>
+    class fulcrum_outer_stack :
+        public // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               const_shallow_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<OuterField>::type,
+               finite_field_info<OuterField,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               fulcrum_outer_stack<OuterField>
+               > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a fulcrum encoder.
+    ///
+    /// The k source symbols are first expanded with Expansion symbols
+    /// of an outer code over the OuterField. The expanded block is then
+    /// coded using a binary RLNC inner code, which is what is sent on
+    /// the wire. Receivers can either decode the inner code using only
+    /// binary operations (fulcrum_inner_decoder), or decode the outer
+    /// code from only k linearly independent symbols
+    /// (fulcrum_outer_decoder).
+    ///
+    /// The factory and set_symbols() take the number of source symbols,
+    /// whereas symbols() reports the number of expanded symbols. See
+    /// the fulcrum_expansion_info layer.
+    template<class OuterField, uint32_t Expansion = 4>
+    class fulcrum_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               fulcrum_expansion_encoder<fulcrum_outer_stack<OuterField>,
+               fulcrum_expansion_info<Expansion,
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<
+                   typename fifi::default_field<fifi::binary>::type,
+               finite_field_info<fifi::binary,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               fulcrum_encoder<OuterField, Expansion>
+               > > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Decoder of the fulcrum inner code.
+    ///
+    /// Decodes the expanded block using only binary operations, which
+    /// requires k + Expansion linearly independent symbols. Once
+    /// complete the first source_block_size() bytes contain the source
+    /// symbols.
+    template<uint32_t Expansion = 4>
+    class fulcrum_inner_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 fulcrum_expansion_info<Expansion,
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<
+                     typename fifi::default_field<fifi::binary>::type,
+                 finite_field_info<fifi::binary,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 fulcrum_inner_decoder<Expansion>
+                     > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Decoder of the fulcrum outer code.
+    ///
+    /// Maps every received inner code symbol to a combination of the k
+    /// source symbols over the OuterField, and decodes the source
+    /// symbols directly. This requires only k linearly independent
+    /// symbols in the OuterField at the cost of operations in the
+    /// larger field.
+    template<class OuterField, uint32_t Expansion = 4>
+    class fulcrum_outer_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 fulcrum_outer_header_decoder<Expansion,
+                 // Coefficient Generator API
+                 uniform_generator<
+                 // Codec API
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<
+                     typename fifi::default_field<OuterField>::type,
+                 finite_field_info<OuterField,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 fulcrum_outer_decoder<OuterField, Expansion>
+                     > > > > > > > > > > > >
+    { };
+
+}
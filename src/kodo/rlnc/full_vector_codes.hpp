@@ -14,12 +14,15 @@
 #include "../final_coder_factory.hpp"
 #include "../finite_field_math.hpp"
 #include "../finite_field_info.hpp"
+#include "../parallel_finite_field_math.hpp"
 #include "../zero_symbol_encoder.hpp"
 #include "../systematic_encoder.hpp"
 #include "../systematic_decoder.hpp"
 #include "../storage_bytes_used.hpp"
 #include "../storage_block_info.hpp"
 #include "../deep_symbol_storage.hpp"
+#include "../shallow_symbol_storage.hpp"
+#include "../shared_symbol_storage.hpp"
 #include "../payload_encoder.hpp"
 #include "../payload_recoder.hpp"
 #include "../payload_decoder.hpp"
@@ -35,10 +38,16 @@
 #include "../storage_aware_encoder.hpp"
 #include "../encode_symbol_tracker.hpp"
 #include "../cached_symbol_decoder.hpp"
+#include "../checkpoint_decoder.hpp"
+#include "../relay_symbol_buffer.hpp"
+#include "../innovative_symbol_filter.hpp"
+#include "../inactivation_decoder.hpp"
 #include "../debug_cached_symbol_decoder.hpp"
 #include "../debug_linear_block_decoder.hpp"
 
 #include "../linear_block_encoder.hpp"
+#include "../batch_linear_block_encoder.hpp"
+#include "../batch_linear_block_decoder.hpp"
 #include "../forward_linear_block_decoder.hpp"
 #include "../linear_block_decoder_delayed.hpp"
 
@@ -88,6 +97,48 @@ namespace kodo
                    > > > > > > > > > > > > > > > > >
     { };
 
+    /// @ingroup fec_stacks
+    /// @brief RLNC encoder working on a generation shared with other
+    ///        encoders.
+    ///
+    /// Identical to the full_rlnc_encoder, except that the symbols are
+    /// attached with set_generation() to read-only data owned by a
+    /// generation_store, see the generation_store_reader. The memory of
+    /// an encoder is then limited to the symbol pointers, the coding
+    /// coefficients and the counters.
+    template<class Field>
+    class shared_full_rlnc_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               shared_symbol_storage<
+               const_shallow_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               shared_full_rlnc_encoder<Field
+                   > > > > > > > > > > > > > > > > > >
+    { };
+
     /// Intermediate stack implementing the recoding functionality of a
     /// RLNC code. As can be seen we are able to reuse a great deal of
     /// layers from the encode stack. It is important that the symbols
@@ -111,10 +162,11 @@ namespace kodo
                  // Codec API
                  encode_symbol_tracker<
                  zero_symbol_encoder<
+                 batch_linear_block_encoder<
                  linear_block_encoder<
                  // Proxy
                  proxy_layer<
-                 recoding_stack<MainStack>, MainStack> > > > > > > > >
+                 recoding_stack<MainStack>, MainStack> > > > > > > > > >
     { };
 
     /// @ingroup fec_stacks
@@ -124,6 +176,8 @@ namespace kodo
     /// described for the encoder):
     /// - Recoding using the recoding_stack
     /// - Linear block decoder using Gauss-Jordan elimination.
+    /// - Joint decoding of several payloads using
+    ///   decode(uint8_t**,uint32_t).
     template<class Field>
     class full_rlnc_decoder
         : public // Payload API
@@ -135,7 +189,9 @@ namespace kodo
                  // Symbol ID API
                  plain_symbol_id_reader<
                  // Codec API
+                 checkpoint_decoder<
                  aligned_coefficients_decoder<
+                 batch_linear_block_decoder<
                  forward_linear_block_decoder<
                  // Coefficient Storage API
                  coefficient_storage<
@@ -151,7 +207,54 @@ namespace kodo
                  final_coder_factory_pool<
                  // Final type
                  full_rlnc_decoder<Field>
-                     > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a full_rlnc_decoder which decodes
+    ///        directly into buffers provided by the application.
+    ///
+    /// The mutable_shallow_symbol_storage is used instead of the
+    /// deep_symbol_storage, so the buffers must be set with
+    /// set_symbols() or set_symbol() before decoding. The pivot of a
+    /// received symbol is found from its coefficients, the symbol data is
+    /// then copied once into the buffer of the pivot and decoded there,
+    /// leaving the incoming payload untouched. No copy_symbols() is
+    /// needed once the decoder is complete. An uncoded symbol whose
+    /// pivot is not yet known, see symbol_pivot(), may be received
+    /// directly into its target buffer and passed to
+    /// decode_symbol(uint8_t*,uint32_t), in which case it is not copied
+    /// at all.
+    template<class Field>
+    class shallow_full_rlnc_decoder
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 checkpoint_decoder<
+                 aligned_coefficients_decoder<
+                 batch_linear_block_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 mutable_shallow_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 shallow_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
     { };
 
     /// @ingroup fec_stacks
@@ -192,6 +295,163 @@ namespace kodo
                      > > > > > > > > > > > > > > > > > >
     { };
 
-}
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a full_rlnc_decoder which processes the
+    ///        symbol data of large symbols using several threads.
+    ///
+    /// The coefficient vector elimination is performed on the calling
+    /// thread, whereas every operation on the symbol data is split into
+    /// stripes processed by the thread pool of the factory. See the
+    /// parallel_finite_field_math layer for the factory settings.
+    ///
+    /// @copydoc full_rlnc_decoder
+    template<class Field>
+    class parallel_full_rlnc_decoder
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 parallel_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 parallel_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a RLNC decoder for large generations of
+    ///        sparse symbols.
+    ///
+    /// Uses the inactivation_decoder, which buffers the received symbols
+    /// and decodes them using peeling and inactivation once enough
+    /// symbols have been received. This avoids the fill-in of the
+    /// Gauss-Jordan elimination when the coding vectors are sparse, e.g.
+    /// when produced by the sparse_uniform_generator.
+    template<class Field>
+    class inactivation_full_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 inactivation_decoder<
+                 // Coefficient Storage API
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 inactivation_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a RLNC relay which recodes without
+    ///        decoding.
+    ///
+    /// The relay accepts the same payloads as the full_rlnc_decoder, but
+    /// instead of performing the elimination it buffers the received
+    /// symbols together with their coefficient vectors. Recoded
+    /// symbols are produced by the recoding_stack as random
+    /// combinations of the buffered symbols, so the cost per forwarded
+    /// symbol is a single linear combination. Symbols received once
+    /// the buffer is full are dropped.
+    template<class Field>
+    class full_rlnc_relay
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 relay_symbol_buffer<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_relay<Field>
+                     > > > > > > > > > > > > > > >
+    { };
 
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a full_rlnc_relay which only buffers
+    ///        innovative symbols.
+    ///
+    /// The rank check is performed on the coefficient vectors only, the
+    /// symbol data of a received symbol is copied once if it is
+    /// innovative and otherwise never touched. In return rank() and
+    /// is_complete() reflect the actual rank of the buffered symbols.
+    ///
+    /// @copydoc full_rlnc_relay
+    template<class Field>
+    class filtered_full_rlnc_relay
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 innovative_symbol_filter<
+                 relay_symbol_buffer<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 filtered_full_rlnc_relay<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
 
+}
@@ -88,12 +88,13 @@ namespace kodo
                  // Codec API
                  encode_symbol_tracker<
                  zero_symbol_encoder<
+                 batch_linear_block_encoder<
                  linear_block_encoder<
                  rank_info<
                  // Proxy
                  proxy_layer<
                  on_the_fly_recoding_stack<MainStack>,
-                 MainStack> > > > > > > > > > >
+                 MainStack> > > > > > > > > > > >
     { };
 
     /// @ingroup fec_stacks
@@ -136,6 +137,47 @@ namespace kodo
                > > > > > > > > > > > > > > > > > >
     { };
 
+    /// @ingroup fec_stacks
+    /// @brief Implementation of an on_the_fly_decoder which decodes
+    ///        directly into buffers provided by the application.
+    ///
+    /// As for the shallow_full_rlnc_decoder the buffers must be set
+    /// before decoding. Symbols reported as decoded by the
+    /// partial_decoding_tracker can be read from the application
+    /// buffers directly.
+    template<class Field>
+    class shallow_on_the_fly_decoder :
+        public // Payload API
+               partial_decoding_tracker<
+               payload_recoder<on_the_fly_recoding_stack,
+               payload_rank_decoder<
+               payload_decoder<
+               // Codec Header API
+               systematic_decoder<
+               symbol_id_decoder<
+               // Symbol ID API
+               plain_symbol_id_reader<
+               // Codec API
+               aligned_coefficients_decoder<
+               forward_linear_block_decoder<
+               rank_info<
+               // Coefficient Storage API
+               coefficient_storage<
+               coefficient_info<
+               // Storage API
+               mutable_shallow_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               shallow_on_the_fly_decoder<Field>
+               > > > > > > > > > > > > > > > > > >
+    { };
+
     /// @ingroup fec_stacks
     /// @brief Implementation of a complete RLNC decoder
     ///
@@ -20,6 +20,7 @@
 #include "../storage_bytes_used.hpp"
 #include "../storage_block_info.hpp"
 #include "../deep_symbol_storage.hpp"
+#include "../shallow_symbol_storage.hpp"
 #include "../payload_encoder.hpp"
 #include "../payload_recoder.hpp"
 #include "../payload_decoder.hpp"
@@ -31,6 +32,7 @@
 #include "../seed_symbol_id_writer.hpp"
 #include "../seed_symbol_id_reader.hpp"
 #include "../uniform_generator.hpp"
+#include "../cached_generator.hpp"
 #include "../recoding_symbol_id.hpp"
 #include "../proxy_layer.hpp"
 #include "../storage_aware_encoder.hpp"
@@ -91,6 +93,8 @@ namespace kodo
     /// Adds the following features (including those described for
     /// the encoder):
     /// - Linear block decoder using Gauss-Jordan elimination.
+    /// - Optional cache of the expanded coefficient vectors shared by
+    ///   the decoders of a factory, see factory::set_cache_capacity().
     template<class Field>
     class seed_rlnc_decoder
         : public // Payload API
@@ -101,6 +105,7 @@ namespace kodo
                  // Symbol ID API
                  seed_symbol_id_reader<
                  // Coefficient Generator API
+                 cached_generator<
                  uniform_generator<
                  // Codec API
                  aligned_coefficients_decoder<
@@ -119,7 +124,45 @@ namespace kodo
                  final_coder_factory_pool<
                  // Final type
                  seed_rlnc_decoder<Field>
-                     > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Implementation of a seed_rlnc_decoder which decodes
+    ///        directly into buffers provided by the application.
+    ///
+    /// As for the shallow_full_rlnc_decoder the buffers must be set
+    /// with set_symbols() or set_symbol() before decoding.
+    template<class Field>
+    class shallow_seed_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 seed_symbol_id_reader<
+                 // Coefficient Generator API
+                 cached_generator<
+                 uniform_generator<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 mutable_shallow_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field Math API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 shallow_seed_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > >
     { };
 
 }
@@ -0,0 +1,287 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace kodo
+{
+
+    /// @brief Scalar tables for the additive FFT over a binary extension
+    ///        field, using the polynomial basis of Lin, Chung and Han.
+    ///
+    /// The evaluation points are w_i, the field element with the integer
+    /// representation i. The subspace W_l = {w_0, ..., w_(2^l - 1)} is
+    /// spanned by v_j = w_(2^j) for j < l. Its vanishing polynomial s_l
+    /// is linearised and the basis polynomials are the products
+    /// X_i = prod s_l(x) / s_l(v_l) over the set bits l of i.
+    ///
+    /// Besides the butterfly factors the class provides log / exp tables
+    /// for the fields scalar arithmetic, which are used to evaluate the
+    /// erasure locator polynomial of the decoder.
+    template<class Field>
+    class additive_fft_basis
+    {
+    public:
+
+        /// The field type
+        typedef Field field_type;
+
+        /// The value type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// Builds the tables using the field implementation
+        /// @param field The field implementation
+        template<class FieldImpl>
+        additive_fft_basis(const FieldImpl &field);
+
+        /// @return The number of bits in a field element i.e. the largest
+        ///         transform covers 2^degree() points
+        uint32_t degree() const
+        {
+            return m_degree;
+        }
+
+        /// @param level The subspace polynomial
+        /// @param point The evaluation point
+        /// @return The normalised subspace polynomial s_level(point) /
+        ///         s_level(v_level)
+        value_type skew(uint32_t level, value_type point) const;
+
+        /// @param level The subspace polynomial
+        /// @return The (constant) formal derivative of the normalised
+        ///         subspace polynomial of the given level
+        value_type derivative(uint32_t level) const
+        {
+            assert(level < m_degree);
+            return m_derivative[level];
+        }
+
+        /// @return The product of a and b
+        value_type multiply(value_type a, value_type b) const
+        {
+            if(!a || !b)
+            {
+                return 0;
+            }
+
+            return m_exp[(m_log[a] + m_log[b]) % m_modulus];
+        }
+
+        /// @return The inverse of a
+        value_type invert(value_type a) const
+        {
+            assert(a != 0);
+            return m_exp[(m_modulus - m_log[a]) % m_modulus];
+        }
+
+        /// Evaluates the erasure locator L(x) = prod (x - w_e) over the
+        /// erased positions e of a transform with size points. Computes
+        /// the log of all evaluations at once through a Walsh-Hadamard
+        /// transform, since w_i - w_e = w_(i xor e).
+        ///
+        /// @param erased Flags the erased positions of the transform
+        /// @param locator On return holds L(w_i) for the positions which
+        ///        are not erased and L'(w_e) for the erased positions
+        void erasure_locator(const std::vector<bool> &erased,
+                             std::vector<value_type> &locator) const;
+
+    private:
+
+        /// In-place Walsh-Hadamard transform modulo m_modulus
+        void walsh_hadamard(std::vector<uint32_t> &data) const;
+
+    private:
+
+        /// The number of bits in a field element
+        uint32_t m_degree;
+
+        /// The order of the multiplicative group
+        uint32_t m_modulus;
+
+        /// The subspace polynomials evaluated at the next basis vector
+        /// i.e. s_l(v_l)
+        std::vector<value_type> m_vanishing;
+
+        /// The inverse of m_vanishing
+        std::vector<value_type> m_normalize;
+
+        /// The formal derivatives of the normalised subspace polynomials
+        std::vector<value_type> m_derivative;
+
+        /// Discrete logarithms of the field elements
+        std::vector<uint32_t> m_log;
+
+        /// Powers of the primitive element
+        std::vector<value_type> m_exp;
+
+    };
+
+    template<class Field>
+    template<class FieldImpl>
+    additive_fft_basis<Field>::additive_fft_basis(const FieldImpl &field)
+        : m_degree(0),
+          m_modulus(field_type::order - 1)
+    {
+        while((1U << m_degree) < field_type::order)
+        {
+            ++m_degree;
+        }
+
+        assert((1U << m_degree) == field_type::order);
+
+        // Find a primitive element to build the log / exp tables
+        m_log.resize(field_type::order);
+        m_exp.resize(m_modulus);
+
+        for(uint32_t candidate = 2; candidate < field_type::order;
+            ++candidate)
+        {
+            value_type power = 1;
+            uint32_t period = 0;
+
+            do
+            {
+                m_exp[period] = power;
+                power = field.multiply(power, (value_type) candidate);
+                ++period;
+            }
+            while(power != 1 && period < m_modulus);
+
+            if(power == 1 && period == m_modulus)
+            {
+                break;
+            }
+        }
+
+        for(uint32_t i = 0; i < m_modulus; ++i)
+        {
+            m_log[m_exp[i]] = i;
+        }
+
+        // The subspace polynomials satisfy the recurrence
+        // s_(l+1)(x) = s_l(x) * (s_l(x) + s_l(v_l)) with s_0(x) = x. The
+        // coefficient of x is therefore the product of the s_l(v_l).
+        m_vanishing.resize(m_degree);
+        m_normalize.resize(m_degree);
+        m_derivative.resize(m_degree);
+
+        value_type linear = 1;
+
+        for(uint32_t l = 0; l < m_degree; ++l)
+        {
+            value_type v = (value_type) (1U << l);
+
+            for(uint32_t j = 0; j < l; ++j)
+            {
+                v = multiply(v, v ^ m_vanishing[j]);
+            }
+
+            assert(v != 0);
+
+            m_vanishing[l] = v;
+            m_normalize[l] = invert(v);
+            m_derivative[l] = multiply(linear, m_normalize[l]);
+
+            linear = multiply(linear, v);
+        }
+    }
+
+    template<class Field>
+    inline auto additive_fft_basis<Field>::skew(
+        uint32_t level, value_type point) const -> value_type
+    {
+        assert(level < m_degree);
+
+        for(uint32_t j = 0; j < level; ++j)
+        {
+            point = multiply(point, point ^ m_vanishing[j]);
+        }
+
+        return multiply(point, m_normalize[level]);
+    }
+
+    template<class Field>
+    inline void additive_fft_basis<Field>::erasure_locator(
+        const std::vector<bool> &erased,
+        std::vector<value_type> &locator) const
+    {
+        uint32_t size = (uint32_t) erased.size();
+
+        assert(size > 0);
+        assert((size & (size - 1)) == 0);
+        assert(size <= field_type::order);
+
+        // The log of the locator is the xor-convolution of the erasure
+        // indicator with the logs of the evaluation points. The entry
+        // at zero is left out such that the erased positions receive
+        // the log of the derivative.
+        std::vector<uint32_t> points(size, 0);
+        std::vector<uint32_t> indicator(size, 0);
+
+        for(uint32_t i = 1; i < size; ++i)
+        {
+            points[i] = m_log[i];
+        }
+
+        for(uint32_t i = 0; i < size; ++i)
+        {
+            indicator[i] = erased[i] ? 1 : 0;
+        }
+
+        walsh_hadamard(points);
+        walsh_hadamard(indicator);
+
+        for(uint32_t i = 0; i < size; ++i)
+        {
+            indicator[i] = (uint32_t)
+                (((uint64_t) indicator[i] * points[i]) % m_modulus);
+        }
+
+        walsh_hadamard(indicator);
+
+        // Divide by the size, since 2^degree = 1 modulo 2^degree - 1
+        // the inverse of 2^k is 2^(degree - k)
+        uint32_t scale = (field_type::order / size) % m_modulus;
+
+        locator.resize(size);
+
+        for(uint32_t i = 0; i < size; ++i)
+        {
+            uint32_t log = (uint32_t)
+                (((uint64_t) indicator[i] * scale) % m_modulus);
+
+            locator[i] = m_exp[log];
+        }
+    }
+
+    template<class Field>
+    inline void additive_fft_basis<Field>::walsh_hadamard(
+        std::vector<uint32_t> &data) const
+    {
+        uint32_t size = (uint32_t) data.size();
+
+        for(uint32_t width = 1; width < size; width <<= 1)
+        {
+            for(uint32_t start = 0; start < size; start += 2 * width)
+            {
+                for(uint32_t i = start; i < start + width; ++i)
+                {
+                    uint32_t a = data[i];
+                    uint32_t b = data[i + width];
+
+                    data[i] = (a + b) % m_modulus;
+                    data[i + width] = (a + m_modulus - b) % m_modulus;
+                }
+            }
+        }
+    }
+
+}
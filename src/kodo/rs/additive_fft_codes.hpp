@@ -0,0 +1,91 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <fifi/default_field.hpp>
+
+#include "../final_coder_factory_pool.hpp"
+#include "../finite_field_math.hpp"
+#include "../finite_field_info.hpp"
+#include "../systematic_encoder.hpp"
+#include "../systematic_decoder.hpp"
+#include "../storage_bytes_used.hpp"
+#include "../storage_block_info.hpp"
+#include "../deep_symbol_storage.hpp"
+#include "../payload_encoder.hpp"
+#include "../payload_decoder.hpp"
+#include "../storage_aware_encoder.hpp"
+#include "../linear_block_encoder.hpp"
+
+#include "additive_fft_transform.hpp"
+#include "additive_fft_encoder.hpp"
+#include "additive_fft_decoder.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup fec_stacks
+    /// @brief Reed-Solomon encoder computing the repair symbols with the
+    ///        additive FFT.
+    ///
+    /// Produces the same kind of MDS code as the rs_encoder but without
+    /// a generator matrix, which makes large generations over
+    /// fifi::binary16 practical. Supports the binary extension fields
+    /// fifi::binary8 and fifi::binary16, with up to half the field order
+    /// source symbols.
+    template<class Field>
+    class fft_rs_encoder
+        : public // Payload Codec API
+                 payload_encoder<
+                 // Codec Header API
+                 systematic_encoder<
+                 additive_fft_encoder<
+                 additive_fft_transform<
+                 // Codec API
+                 linear_block_encoder<
+                 storage_aware_encoder<
+                 // Symbol Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 fft_rs_encoder<Field>
+                     > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Erasure decoder for the fft_rs_encoder. Decodes once as
+    ///        many distinct symbols as source symbols have been received.
+    template<class Field>
+    class fft_rs_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 additive_fft_decoder<
+                 additive_fft_transform<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 fft_rs_decoder<Field>
+                     > > > > > > > > > >
+    { };
+
+}
@@ -0,0 +1,313 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <sak/convert_endian.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    /// @brief Erasure decoder for the additive_fft_encoder.
+    ///
+    /// Source and repair symbols are buffered until k distinct symbols
+    /// have been received. The missing source symbols are then recovered
+    /// with the erasure locator L(x), which vanishes in the missing
+    /// points: the product L * P of the locator and the source polynomial
+    /// is known in every point of a transform of size N, it is
+    /// interpolated, differentiated and evaluated again. In a missing
+    /// point (L * P)' = L' * P, which yields P. The decoding costs three
+    /// transforms of size N, where N is the power of two covering the
+    /// highest received repair symbol.
+    template<class SuperCoder>
+    class additive_fft_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            {
+                assert(max_symbols <= field_type::order / 2);
+            }
+
+            /// @copydoc layer::max_header_size() const
+            uint32_t max_header_size() const
+            {
+                return sizeof(value_type);
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_uncoded.resize(the_factory.max_symbols(), false);
+            m_received.resize(field_type::order, false);
+            m_repair.resize(the_factory.max_symbols() *
+                            the_factory.max_symbol_size());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            std::fill_n(m_uncoded.begin(), SuperCoder::symbols(), false);
+
+            for(uint32_t i = 0; i < m_repair_index.size(); ++i)
+            {
+                m_received[m_repair_index[i]] = false;
+            }
+
+            m_repair_index.clear();
+
+            m_levels = 0;
+            while((1U << m_levels) < SuperCoder::symbols())
+            {
+                ++m_levels;
+            }
+
+            m_rank = 0;
+        }
+
+        /// @copydoc layer::decode(uint8_t*, uint8_t*)
+        void decode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            uint32_t repair_index =
+                sak::big_endian::get<value_type>(symbol_header);
+
+            assert(repair_index < field_type::order - (1U << m_levels));
+
+            if(is_complete() || m_received[repair_index])
+            {
+                return;
+            }
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+            uint32_t slot = (uint32_t) m_repair_index.size();
+
+            std::copy(symbol_data, symbol_data + symbol_size,
+                      &m_repair[slot * symbol_size]);
+
+            m_received[repair_index] = true;
+            m_repair_index.push_back(repair_index);
+
+            ++m_rank;
+
+            if(is_complete())
+            {
+                recover();
+            }
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_index < SuperCoder::symbols());
+
+            if(is_complete() || m_uncoded[symbol_index])
+            {
+                return;
+            }
+
+            std::copy(symbol_data, symbol_data + SuperCoder::symbol_size(),
+                      SuperCoder::symbol(symbol_index));
+
+            m_uncoded[symbol_index] = true;
+            ++m_rank;
+
+            if(is_complete())
+            {
+                recover();
+            }
+        }
+
+        /// @copydoc layer::is_complete() const
+        bool is_complete() const
+        {
+            return m_rank == SuperCoder::symbols();
+        }
+
+        /// @copydoc layer::rank() const
+        uint32_t rank() const
+        {
+            return m_rank;
+        }
+
+        /// @copydoc layer::symbol_pivot(uint32_t) const
+        bool symbol_pivot(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+            return is_complete() || m_uncoded[index];
+        }
+
+        /// @copydoc layer::header_size() const
+        uint32_t header_size() const
+        {
+            return sizeof(value_type);
+        }
+
+    protected:
+
+        /// Recovers the missing source symbols once k distinct symbols
+        /// have been received
+        void recover()
+        {
+            if(m_repair_index.empty())
+            {
+                return;
+            }
+
+            uint32_t symbols = SuperCoder::symbols();
+            uint32_t symbol_size = SuperCoder::symbol_size();
+            uint32_t length = SuperCoder::symbol_length();
+            uint32_t source_size = 1U << m_levels;
+
+            uint32_t highest = *std::max_element(
+                m_repair_index.begin(), m_repair_index.end());
+
+            uint32_t levels = m_levels;
+            while((1U << levels) <= source_size + highest)
+            {
+                ++levels;
+            }
+
+            uint32_t size = 1U << levels;
+
+            // Every point of the transform is erased unless received, the
+            // zero padding of the source block counts as received
+            std::vector<bool> erased(size, true);
+
+            for(uint32_t i = 0; i < source_size; ++i)
+            {
+                erased[i] = i < symbols && !m_uncoded[i];
+            }
+
+            for(uint32_t i = 0; i < m_repair_index.size(); ++i)
+            {
+                erased[source_size + m_repair_index[i]] = false;
+            }
+
+            SuperCoder::basis().erasure_locator(erased, m_locator);
+
+            m_work.resize(size * symbol_size);
+            std::fill(m_work.begin(), m_work.end(), 0);
+
+            m_pointers.resize(size);
+
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                m_pointers[i] =
+                    reinterpret_cast<value_type*>(&m_work[i * symbol_size]);
+            }
+
+            // Evaluations of L * P in the received points
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(m_uncoded[i])
+                {
+                    SuperCoder::multiply_add(
+                        m_pointers[i], SuperCoder::symbol_value(i),
+                        m_locator[i], length);
+                }
+            }
+
+            for(uint32_t i = 0; i < m_repair_index.size(); ++i)
+            {
+                uint32_t point = source_size + m_repair_index[i];
+
+                SuperCoder::multiply_add(
+                    m_pointers[point],
+                    reinterpret_cast<const value_type*>(
+                        &m_repair[i * symbol_size]),
+                    m_locator[point], length);
+            }
+
+            SuperCoder::ifft(&m_pointers[0], levels, 0);
+            SuperCoder::formal_derivative(&m_pointers[0], levels);
+            SuperCoder::fft(&m_pointers[0], levels, 0);
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(m_uncoded[i])
+                {
+                    continue;
+                }
+
+                value_type *symbol = m_pointers[i];
+
+                SuperCoder::multiply(
+                    symbol, SuperCoder::basis().invert(m_locator[i]),
+                    length);
+
+                std::copy(&m_work[i * symbol_size],
+                          &m_work[(i + 1) * symbol_size],
+                          SuperCoder::symbol(i));
+
+                m_uncoded[i] = true;
+            }
+        }
+
+    protected:
+
+        /// The log2 of the padded number of source symbols
+        uint32_t m_levels;
+
+        /// The number of distinct symbols received
+        uint32_t m_rank;
+
+        /// Tracks the source symbols which are available
+        std::vector<bool> m_uncoded;
+
+        /// Tracks the repair symbols which have been received
+        std::vector<bool> m_received;
+
+        /// The indices of the buffered repair symbols
+        std::vector<uint32_t> m_repair_index;
+
+        /// The buffered repair symbols
+        std::vector<uint8_t> m_repair;
+
+        /// The erasure locator evaluations
+        std::vector<value_type> m_locator;
+
+        /// Transform buffer
+        std::vector<uint8_t> m_work;
+
+        /// Symbol pointers into the transform buffer
+        std::vector<value_type*> m_pointers;
+
+    };
+
+}
@@ -0,0 +1,240 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <sak/convert_endian.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    /// @brief Reed-Solomon encoder based on the additive FFT.
+    ///
+    /// The k source symbols are padded with zero symbols to m = 2^levels
+    /// and seen as the evaluations of a polynomial of degree less than m
+    /// in the points w_0, ..., w_(m-1). Repair symbol j is the evaluation
+    /// in w_(m+j). The polynomial is interpolated with one inverse
+    /// transform and every further block of m repair symbols costs one
+    /// forward transform, so n - k repair symbols cost O(n log m)
+    /// symbol operations instead of the O(k (n - k)) of a dense
+    /// generator matrix.
+    ///
+    /// The header carries the repair symbol index. The layer is placed
+    /// below the systematic_encoder, which produces the source symbols.
+    template<class SuperCoder>
+    class additive_fft_encoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            {
+                // The padded source block must leave room for at least
+                // as many repair symbols in the field
+                assert(max_symbols <= field_type::order / 2);
+            }
+
+            /// @copydoc layer::max_header_size() const
+            uint32_t max_header_size() const
+            {
+                return sizeof(value_type);
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_levels = 0;
+            while((1U << m_levels) < SuperCoder::symbols())
+            {
+                ++m_levels;
+            }
+
+            m_repair_count = 0;
+            m_interpolated = false;
+            m_blocks.clear();
+        }
+
+        /// Sets the source symbols and discards the repair symbols
+        /// computed from the previous ones
+        /// @copydoc layer::set_symbols(const sak::const_storage&)
+        void set_symbols(const sak::const_storage &symbol_storage)
+        {
+            SuperCoder::set_symbols(symbol_storage);
+            discard_repair_blocks();
+        }
+
+        /// Sets a source symbol and discards the repair symbols
+        /// computed from the previous one
+        /// @copydoc layer::set_symbol(uint32_t, const sak::const_storage&)
+        void set_symbol(uint32_t index, const sak::const_storage &symbol)
+        {
+            SuperCoder::set_symbol(index, symbol);
+            discard_repair_blocks();
+        }
+
+        /// @copydoc layer::encode(uint8_t*, uint8_t*)
+        uint32_t encode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            uint32_t repair_index = m_repair_count % repair_symbols();
+            ++m_repair_count;
+
+            sak::big_endian::put<value_type>(
+                (value_type) repair_index, symbol_header);
+
+            uint32_t block_size = 1U << m_levels;
+            uint32_t block = repair_index >> m_levels;
+            uint32_t offset = repair_index & (block_size - 1);
+
+            const uint8_t *repair = repair_block(block) +
+                offset * SuperCoder::symbol_size();
+
+            std::copy(repair, repair + SuperCoder::symbol_size(),
+                      symbol_data);
+
+            return sizeof(value_type);
+        }
+
+        /// @copydoc layer::header_size() const
+        uint32_t header_size() const
+        {
+            return sizeof(value_type);
+        }
+
+        /// @return The number of distinct repair symbols the encoder can
+        ///         produce, after which the repair symbols repeat
+        uint32_t repair_symbols() const
+        {
+            return field_type::order - (1U << m_levels);
+        }
+
+    protected:
+
+        /// @param block The index of a block of 2^levels repair symbols
+        /// @return The repair symbols of the block, computed on first use
+        const uint8_t* repair_block(uint32_t block)
+        {
+            uint32_t block_size = 1U << m_levels;
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            if(!m_interpolated)
+            {
+                // Did you forget to set the data on the encoder?
+                assert(SuperCoder::rank() == SuperCoder::symbols());
+
+                m_coefficients.resize(block_size * symbol_size);
+                std::fill(m_coefficients.begin(), m_coefficients.end(), 0);
+
+                for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
+                {
+                    const uint8_t *symbol = SuperCoder::symbol(i);
+                    std::copy(symbol, symbol + symbol_size,
+                              &m_coefficients[i * symbol_size]);
+                }
+
+                symbol_pointers(m_coefficients);
+                SuperCoder::ifft(&m_pointers[0], m_levels, 0);
+
+                m_interpolated = true;
+            }
+
+            if(block >= m_blocks.size())
+            {
+                m_blocks.resize(block + 1);
+            }
+
+            std::vector<uint8_t> &repair = m_blocks[block];
+
+            if(repair.empty())
+            {
+                repair = m_coefficients;
+
+                symbol_pointers(repair);
+                SuperCoder::fft(&m_pointers[0], m_levels,
+                                (block + 1) * block_size);
+            }
+
+            return &repair[0];
+        }
+
+        /// Marks the interpolated polynomial and the repair blocks as
+        /// stale, keeping their memory for the next computation
+        void discard_repair_blocks()
+        {
+            m_interpolated = false;
+
+            for(auto& repair : m_blocks)
+            {
+                repair.clear();
+            }
+        }
+
+        /// Points m_pointers to the symbols of a buffer
+        /// @param buffer The buffer holding 2^levels symbols
+        void symbol_pointers(std::vector<uint8_t> &buffer)
+        {
+            uint32_t block_size = 1U << m_levels;
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            m_pointers.resize(block_size);
+
+            for(uint32_t i = 0; i < block_size; ++i)
+            {
+                m_pointers[i] = reinterpret_cast<value_type*>(
+                    &buffer[i * symbol_size]);
+            }
+        }
+
+    protected:
+
+        /// The log2 of the padded number of source symbols
+        uint32_t m_levels;
+
+        /// The number of repair symbols produced
+        uint32_t m_repair_count;
+
+        /// True if m_coefficients holds the interpolated polynomial
+        bool m_interpolated;
+
+        /// The coefficients of the source polynomial
+        std::vector<uint8_t> m_coefficients;
+
+        /// The computed blocks of repair symbols
+        std::vector< std::vector<uint8_t> > m_blocks;
+
+        /// Symbol pointers handed to the transforms
+        std::vector<value_type*> m_pointers;
+
+    };
+
+}
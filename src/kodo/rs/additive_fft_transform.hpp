@@ -0,0 +1,214 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "additive_fft_basis.hpp"
+
+namespace kodo
+{
+
+    /// @brief Additive FFT on whole symbols.
+    ///
+    /// A transform of size 2^k maps the coefficients of a polynomial of
+    /// degree less than 2^k in the basis of additive_fft_basis to its
+    /// evaluations in the points w_i + offset, where i < 2^k and offset
+    /// is a multiple of 2^k. Each transform costs k * 2^(k-1)
+    /// multiply-add and add operations on symbols.
+    ///
+    /// The basis tables are computed once by the factory and shared by
+    /// all coders built from it.
+    template<class SuperCoder>
+    class additive_fft_transform : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The basis type
+        typedef additive_fft_basis<field_type> basis_type;
+
+        /// Pointer to the basis
+        typedef boost::shared_ptr<const basis_type> basis_pointer;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder. Builds the
+        /// basis tables.
+        class factory : public SuperCoder::factory
+        {
+        protected:
+
+            /// Access to the finite field implementation
+            using SuperCoder::factory::m_field;
+
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            {
+                assert(m_field);
+                m_basis = boost::make_shared<const basis_type>(*m_field);
+            }
+
+            /// @return The basis shared by the coders
+            basis_pointer basis() const
+            {
+                return m_basis;
+            }
+
+        private:
+
+            /// The basis tables
+            basis_pointer m_basis;
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+            m_basis = the_factory.basis();
+        }
+
+        /// @return The basis tables
+        const basis_type& basis() const
+        {
+            assert(m_basis);
+            return *m_basis;
+        }
+
+        /// Transforms coefficients to evaluations
+        /// @param symbols The 2^levels symbols transformed in place
+        /// @param levels The log2 of the transform size
+        /// @param offset The offset of the evaluation points
+        void fft(value_type **symbols, uint32_t levels, uint32_t offset)
+        {
+            assert(symbols != 0);
+            assert(levels <= m_basis->degree());
+
+            uint32_t size = 1U << levels;
+            uint32_t length = SuperCoder::symbol_length();
+
+            for(uint32_t l = levels; l-- > 0; )
+            {
+                uint32_t half = 1U << l;
+
+                for(uint32_t start = 0; start < size; start += 2 * half)
+                {
+                    value_type skew = m_basis->skew(
+                        l, (value_type) (offset ^ start));
+
+                    for(uint32_t i = start; i < start + half; ++i)
+                    {
+                        if(skew)
+                        {
+                            SuperCoder::multiply_add(
+                                symbols[i], symbols[i + half], skew,
+                                length);
+                        }
+
+                        SuperCoder::add(symbols[i + half], symbols[i],
+                                        length);
+                    }
+                }
+            }
+        }
+
+        /// Transforms evaluations to coefficients, the inverse of fft()
+        /// @param symbols The 2^levels symbols transformed in place
+        /// @param levels The log2 of the transform size
+        /// @param offset The offset of the evaluation points
+        void ifft(value_type **symbols, uint32_t levels, uint32_t offset)
+        {
+            assert(symbols != 0);
+            assert(levels <= m_basis->degree());
+
+            uint32_t size = 1U << levels;
+            uint32_t length = SuperCoder::symbol_length();
+
+            for(uint32_t l = 0; l < levels; ++l)
+            {
+                uint32_t half = 1U << l;
+
+                for(uint32_t start = 0; start < size; start += 2 * half)
+                {
+                    value_type skew = m_basis->skew(
+                        l, (value_type) (offset ^ start));
+
+                    for(uint32_t i = start; i < start + half; ++i)
+                    {
+                        SuperCoder::add(symbols[i + half], symbols[i],
+                                        length);
+
+                        if(skew)
+                        {
+                            SuperCoder::multiply_add(
+                                symbols[i], symbols[i + half], skew,
+                                length);
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Replaces the coefficients of a polynomial with those of its
+        /// formal derivative. Since the derivative of the normalised
+        /// subspace polynomial of level l is a constant c_l, the
+        /// derivative of X_i is the sum of c_l * X_(i xor 2^l) over the
+        /// set bits l of i.
+        /// @param symbols The 2^levels coefficient symbols
+        /// @param levels The log2 of the number of coefficients
+        void formal_derivative(value_type **symbols, uint32_t levels)
+        {
+            assert(symbols != 0);
+
+            uint32_t size = 1U << levels;
+            uint32_t length = SuperCoder::symbol_length();
+
+            // The new coefficient j only depends on coefficients above j
+            // so the result can be formed in place in increasing order
+            for(uint32_t j = 0; j < size; ++j)
+            {
+                std::fill_n(symbols[j], length, 0);
+
+                for(uint32_t l = 0; l < levels; ++l)
+                {
+                    uint32_t source = j | (1U << l);
+
+                    if(source == j)
+                    {
+                        continue;
+                    }
+
+                    SuperCoder::multiply_add(
+                        symbols[j], symbols[source],
+                        m_basis->derivative(l), length);
+                }
+            }
+        }
+
+    private:
+
+        /// The basis tables
+        basis_pointer m_basis;
+
+    };
+
+}
@@ -0,0 +1,274 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace kodo
+{
+
+    /// @brief Bounded, thread-safe cache of coefficient vectors expanded
+    ///        from seeds.
+    ///
+    /// The vectors are kept in a slab of fixed size slots, one slot per
+    /// entry, and are keyed by the number of symbols, the size of the
+    /// vector and the seed. The field is part of the type of the cache,
+    /// so coders of different fields cannot share a cache. When the
+    /// cache is full a slot is reclaimed with the clock algorithm, so
+    /// seeds which are looked up repeatedly stay cached.
+    ///
+    /// @tparam Field The finite field of the cached vectors
+    template<class Field>
+    class seed_coefficient_cache : boost::noncopyable
+    {
+    public:
+
+        /// The finite field of the cached vectors
+        typedef Field field_type;
+
+        /// Constructs a new cache
+        /// @param capacity The maximum number of cached vectors
+        /// @param slot_size The maximum size of a coefficient vector in
+        ///        bytes
+        seed_coefficient_cache(uint32_t capacity, uint32_t slot_size)
+            : m_capacity(capacity),
+              m_slot_size(slot_size),
+              m_hand(0),
+              m_hits(0),
+              m_misses(0)
+        {
+            assert(m_capacity > 0);
+            assert(m_slot_size > 0);
+
+            m_slab.resize(m_capacity * m_slot_size);
+            m_keys.reserve(m_capacity);
+            m_referenced.reserve(m_capacity);
+            m_index.reserve(m_capacity);
+        }
+
+        /// Copies a cached coefficient vector
+        /// @param symbols The number of symbols of the coder
+        /// @param seed The seed of the vector
+        /// @param coefficients The buffer receiving the vector
+        /// @param size The size of the vector in bytes
+        /// @return True if the vector was cached
+        bool find(uint32_t symbols, uint32_t seed, uint8_t *coefficients,
+                  uint32_t size)
+        {
+            assert(coefficients != 0);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_index.find(cache_key(symbols, size, seed));
+
+            if(it == m_index.end())
+            {
+                ++m_misses;
+                return false;
+            }
+
+            ++m_hits;
+
+            uint32_t slot = it->second;
+            m_referenced[slot] = true;
+
+            const uint8_t *data = &m_slab[slot * m_slot_size];
+            std::copy(data, data + size, coefficients);
+
+            return true;
+        }
+
+        /// @param symbols The number of symbols of the coder
+        /// @param seed The seed of the vector
+        /// @param size The size of the vector in bytes
+        /// @return True if the vector is cached
+        bool contains(uint32_t symbols, uint32_t seed, uint32_t size) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_index.count(cache_key(symbols, size, seed)) > 0;
+        }
+
+        /// Stores a coefficient vector, possibly evicting another one
+        /// @param symbols The number of symbols of the coder
+        /// @param seed The seed of the vector
+        /// @param coefficients The vector
+        /// @param size The size of the vector in bytes
+        /// @return False if the vector does not fit in a slot and was
+        ///         not stored
+        bool insert(uint32_t symbols, uint32_t seed,
+                    const uint8_t *coefficients, uint32_t size)
+        {
+            assert(coefficients != 0);
+
+            if(size > m_slot_size)
+            {
+                return false;
+            }
+
+            cache_key key(symbols, size, seed);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if(m_index.count(key))
+            {
+                return true;
+            }
+
+            uint32_t slot;
+
+            if(m_keys.size() < m_capacity)
+            {
+                slot = (uint32_t) m_keys.size();
+                m_keys.push_back(key);
+                m_referenced.push_back(false);
+            }
+            else
+            {
+                // Give every referenced slot a second chance
+                while(m_referenced[m_hand])
+                {
+                    m_referenced[m_hand] = false;
+                    m_hand = (m_hand + 1) % m_capacity;
+                }
+
+                slot = m_hand;
+                m_hand = (m_hand + 1) % m_capacity;
+
+                m_index.erase(m_keys[slot]);
+                m_keys[slot] = key;
+            }
+
+            m_index[key] = slot;
+
+            std::copy(coefficients, coefficients + size,
+                      &m_slab[slot * m_slot_size]);
+
+            return true;
+        }
+
+        /// @return The maximum number of cached vectors
+        uint32_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        /// @return The maximum size of a cached vector in bytes
+        uint32_t slot_size() const
+        {
+            return m_slot_size;
+        }
+
+        /// @return The number of cached vectors
+        uint32_t size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return (uint32_t) m_index.size();
+        }
+
+        /// @return The number of lookups which found a cached vector
+        uint64_t hits() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_hits;
+        }
+
+        /// @return The number of lookups which did not find a vector
+        uint64_t misses() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_misses;
+        }
+
+    private:
+
+        /// Identifies a cached vector
+        struct cache_key
+        {
+            /// Constructs a new key
+            /// @param symbols The number of symbols of the coder
+            /// @param size The size of the vector in bytes
+            /// @param seed The seed of the vector
+            cache_key(uint32_t symbols, uint32_t size, uint32_t seed)
+                : m_symbols(symbols),
+                  m_size(size),
+                  m_seed(seed)
+            { }
+
+            /// @return True if both keys identify the same vector
+            bool operator==(const cache_key &other) const
+            {
+                return m_symbols == other.m_symbols &&
+                    m_size == other.m_size &&
+                    m_seed == other.m_seed;
+            }
+
+            /// The number of symbols of the coder
+            uint32_t m_symbols;
+
+            /// The size of the vector in bytes
+            uint32_t m_size;
+
+            /// The seed of the vector
+            uint32_t m_seed;
+        };
+
+        /// Hashes a cache_key
+        struct cache_key_hash
+        {
+            /// @param key The key
+            /// @return The hash of the key
+            std::size_t operator()(const cache_key &key) const
+            {
+                uint64_t value = (uint64_t(key.m_symbols) << 32) ^
+                    (uint64_t(key.m_size) << 16) ^ key.m_seed;
+
+                return std::hash<uint64_t>()(value);
+            }
+        };
+
+    private:
+
+        /// Protects the cache
+        mutable std::mutex m_mutex;
+
+        /// The maximum number of cached vectors
+        uint32_t m_capacity;
+
+        /// The size of a slot in the slab
+        uint32_t m_slot_size;
+
+        /// The clock hand pointing to the next eviction candidate
+        uint32_t m_hand;
+
+        /// The number of successful lookups
+        uint64_t m_hits;
+
+        /// The number of failed lookups
+        uint64_t m_misses;
+
+        /// The coefficient vectors
+        std::vector<uint8_t> m_slab;
+
+        /// The key stored in each slot
+        std::vector<cache_key> m_keys;
+
+        /// The clock reference bits of the slots
+        std::vector<bool> m_referenced;
+
+        /// Maps keys to slots
+        std::unordered_map<cache_key, uint32_t, cache_key_hash> m_index;
+
+    };
+
+}
@@ -0,0 +1,72 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <sak/storage.hpp>
+
+#include "generation_store.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup symbol_storage_layers
+    /// @brief Attaches an encoder to a generation of a generation_store.
+    ///
+    /// Must be placed above a const_shallow_symbol_storage layer. The
+    /// encoder holds a reference to the generation until it is
+    /// initialized again, so the shared data outlives every encoder
+    /// using it while the encoder itself only stores the symbol pointers.
+    /// Note that an encoder returned to the factory pool keeps its
+    /// reference until it is built again, use free_unused() on the pool
+    /// to release the generations of idle encoders.
+    template<class SuperCoder>
+    class shared_symbol_storage : public SuperCoder
+    {
+    public:
+
+        /// Pointer to a generation
+        typedef generation_store::generation_pointer generation_pointer;
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+            m_generation.reset();
+        }
+
+        /// Sets the symbols of the encoder to the data of a generation
+        /// @param generation The generation, which must hold at least
+        ///        block_size() bytes
+        void set_generation(const generation_pointer &generation)
+        {
+            assert(generation);
+            assert(generation->size() >= SuperCoder::block_size());
+
+            m_generation = generation;
+
+            SuperCoder::set_symbols(
+                sak::storage(&(*generation)[0], SuperCoder::block_size()));
+        }
+
+        /// @return The generation used by the encoder, may be empty
+        generation_pointer generation() const
+        {
+            return m_generation;
+        }
+
+    private:
+
+        /// The shared generation
+        generation_pointer m_generation;
+
+    };
+
+}
@@ -0,0 +1,209 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace kodo
+{
+
+    /// @brief Fixed size pool of worker threads executing indexed tasks.
+    ///
+    /// The thread calling run() takes part in executing the tasks and
+    /// returns when all tasks have completed. Several threads may call
+    /// run() concurrently in which case the workers are shared between
+    /// the jobs.
+    class thread_pool : boost::noncopyable
+    {
+    public:
+
+        /// The task function, invoked with the index of the task
+        typedef std::function<void (uint32_t)> task_function;
+
+    public:
+
+        /// Constructs a new thread pool
+        /// @param workers The number of worker threads to start, the
+        ///        threads calling run() are not included in this number
+        thread_pool(uint32_t workers)
+            : m_stop(false)
+        {
+            for(uint32_t i = 0; i < workers; ++i)
+            {
+                m_workers.push_back(
+                    std::thread(&thread_pool::worker_loop, this));
+            }
+        }
+
+        /// Stops and joins the worker threads
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+
+            m_work_condition.notify_all();
+
+            for(auto& worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        /// @return The number of worker threads
+        uint32_t workers() const
+        {
+            return static_cast<uint32_t>(m_workers.size());
+        }
+
+        /// Executes task(0) ... task(tasks - 1) using the worker threads
+        /// and the calling thread. Returns when all tasks have completed.
+        /// @param tasks The number of tasks
+        /// @param task The task function
+        void run(uint32_t tasks, const task_function& task)
+        {
+            assert(task);
+
+            if(tasks == 0)
+                return;
+
+            job j(tasks, task);
+
+            if(tasks > 1 && m_workers.size() > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_jobs.push_back(&j);
+                }
+
+                m_work_condition.notify_all();
+            }
+
+            // The calling thread works on its own job
+            uint32_t index;
+            while((index = j.m_next++) < tasks)
+            {
+                execute(j, index);
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            // The job may still be queued if the workers did not see
+            // that all tasks were taken
+            auto it = std::find(m_jobs.begin(), m_jobs.end(), &j);
+            if(it != m_jobs.end())
+            {
+                m_jobs.erase(it);
+            }
+
+            m_done_condition.wait(
+                lock, [&j]() { return j.m_done == j.m_tasks; });
+        }
+
+    private:
+
+        /// A job submitted to run()
+        struct job
+        {
+            job(uint32_t tasks, const task_function& function)
+                : m_tasks(tasks),
+                  m_function(function),
+                  m_next(0),
+                  m_done(0)
+            { }
+
+            /// The number of tasks
+            const uint32_t m_tasks;
+
+            /// The task function
+            const task_function& m_function;
+
+            /// The next task index to execute
+            std::atomic<uint32_t> m_next;
+
+            /// The number of tasks completed
+            std::atomic<uint32_t> m_done;
+        };
+
+        /// Executes a task and signals the caller if it was the last one.
+        /// The job must not be accessed after the completion count has
+        /// been incremented, since the caller may then return.
+        void execute(job& j, uint32_t index)
+        {
+            j.m_function(index);
+
+            uint32_t tasks = j.m_tasks;
+
+            if(++j.m_done == tasks)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done_condition.notify_all();
+            }
+        }
+
+        /// The loop executed by the worker threads
+        void worker_loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while(true)
+            {
+                m_work_condition.wait(
+                    lock, [this]() { return m_stop || !m_jobs.empty(); });
+
+                if(m_stop)
+                    return;
+
+                job* j = m_jobs.front();
+                uint32_t index = j->m_next++;
+
+                if(index >= j->m_tasks)
+                {
+                    // All tasks have been taken
+                    m_jobs.pop_front();
+                    continue;
+                }
+
+                lock.unlock();
+                execute(*j, index);
+                lock.lock();
+            }
+        }
+
+    private:
+
+        /// Protects the job queue
+        std::mutex m_mutex;
+
+        /// Signaled when jobs are added or the pool is stopped
+        std::condition_variable m_work_condition;
+
+        /// Signaled when a job completes
+        std::condition_variable m_done_condition;
+
+        /// The jobs with tasks not yet taken
+        std::deque<job*> m_jobs;
+
+        /// True when the workers should exit
+        bool m_stop;
+
+        /// The worker threads
+        std::vector<std::thread> m_workers;
+    };
+
+}
@@ -0,0 +1,394 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #include <x86intrin.h>
+    #define KODO_TRACE_TSC 1
+#endif
+
+namespace kodo
+{
+
+    /// The events recorded by the trace_layer
+    enum class trace_event_type : uint8_t
+    {
+        /// A coded symbol was received, the value is the rank before
+        received_coded,
+        /// An uncoded symbol was received, the value is its index
+        received_uncoded,
+        /// A symbol increased the rank, the value is the new pivot
+        pivot_found,
+        /// A symbol did not increase the rank, the value is the rank
+        non_innovative,
+        /// An uncoded symbol replaced a coded symbol at its pivot, the
+        /// value is the index
+        swap_decode,
+        /// The decoder reached full rank, the value is the rank
+        complete
+    };
+
+    /// The number of event types
+    const uint32_t trace_event_types = 6;
+
+    /// @param type The event type
+    /// @return The name of the event type
+    inline const char* trace_event_name(trace_event_type type)
+    {
+        switch(type)
+        {
+        case trace_event_type::received_coded:
+            return "received_coded";
+        case trace_event_type::received_uncoded:
+            return "received_uncoded";
+        case trace_event_type::pivot_found:
+            return "pivot_found";
+        case trace_event_type::non_innovative:
+            return "non_innovative";
+        case trace_event_type::swap_decode:
+            return "swap_decode";
+        case trace_event_type::complete:
+            return "complete";
+        }
+
+        assert(0);
+        return "unknown";
+    }
+
+    /// A recorded event, kept at 16 bytes so a ring buffer entry fits
+    /// four times in a cache line
+    struct trace_event
+    {
+        /// The time stamp in trace_clock ticks
+        uint64_t m_timestamp;
+
+        /// The value of the event, see trace_event_type
+        uint32_t m_value;
+
+        /// The id of the coder which recorded the event
+        uint16_t m_coder;
+
+        /// The trace_event_type
+        uint8_t m_type;
+
+        /// Unused
+        uint8_t m_reserved;
+    };
+
+    static_assert(sizeof(trace_event) == 16,
+                  "A trace event should be 16 bytes");
+
+    /// @brief The clock of the trace events.
+    ///
+    /// Reads the time stamp counter on x86 and the steady clock in
+    /// nanoseconds elsewhere. The ticks are converted to microseconds
+    /// when the events are exported.
+    struct trace_clock
+    {
+        /// @return The current time in ticks
+        static uint64_t now()
+        {
+#if defined(KODO_TRACE_TSC)
+            return __rdtsc();
+#else
+            return steady_nanoseconds();
+#endif
+        }
+
+        /// @return The steady clock in nanoseconds
+        static uint64_t steady_nanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    };
+
+    /// @brief Ring buffer of the events of one thread.
+    ///
+    /// Only the owning thread writes, so recording is two relaxed
+    /// stores and a release increment without locks. When the buffer is
+    /// full the oldest events are overwritten. Other threads may take a
+    /// snapshot() at any time, events overwritten while copying are
+    /// dropped from the snapshot.
+    ///
+    /// The slots are atomics since the writer may overwrite a slot
+    /// while a snapshot reads it. A release fence before the writer
+    /// fills a slot and an acquire fence before the snapshot re-reads
+    /// the head ensure that a snapshot which read a partly overwritten
+    /// slot also sees the head of the overwriting event.
+    class trace_buffer : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param thread The index of the owning thread
+        /// @param capacity The number of events kept, a power of two
+        trace_buffer(uint32_t thread, uint32_t capacity)
+            : m_thread(thread),
+              m_mask(capacity - 1),
+              m_events(capacity),
+              m_head(0)
+        {
+            assert(capacity > 0);
+            assert((capacity & m_mask) == 0);
+        }
+
+        /// Records an event
+        /// @param type The event type
+        /// @param coder The id of the coder
+        /// @param value The value of the event
+        void record(trace_event_type type, uint16_t coder, uint32_t value)
+        {
+            uint64_t head = m_head.load(std::memory_order_relaxed);
+
+            // Orders the previous increment of the head before the
+            // stores to the slot
+            std::atomic_thread_fence(std::memory_order_release);
+
+            trace_slot &slot = m_events[head & m_mask];
+            slot.m_timestamp.store(
+                trace_clock::now(), std::memory_order_relaxed);
+            slot.m_data.store(
+                uint64_t(value) | (uint64_t(coder) << 32) |
+                (uint64_t(type) << 48), std::memory_order_relaxed);
+
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        /// The writer may be overwriting the oldest event at any time,
+        /// so a snapshot of a full buffer holds at most capacity - 1
+        /// events.
+        /// @return The events currently in the buffer, oldest first
+        std::vector<trace_event> snapshot() const
+        {
+            uint64_t head = m_head.load(std::memory_order_acquire);
+            uint64_t capacity = m_mask + 1;
+            uint64_t first = head > capacity ? head - capacity : 0;
+
+            std::vector<trace_event> events;
+            events.reserve((size_t) (head - first));
+
+            for(uint64_t i = first; i < head; ++i)
+            {
+                const trace_slot &slot = m_events[i & m_mask];
+                uint64_t data = slot.m_data.load(std::memory_order_relaxed);
+
+                trace_event event;
+                event.m_timestamp =
+                    slot.m_timestamp.load(std::memory_order_relaxed);
+                event.m_value = (uint32_t) data;
+                event.m_coder = (uint16_t) (data >> 32);
+                event.m_type = (uint8_t) (data >> 48);
+                event.m_reserved = 0;
+
+                events.push_back(event);
+            }
+
+            // Makes the head seen below at least as recent as any event
+            // whose stores were read above
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Drop the events the writer may have overwritten meanwhile.
+            // The writer may also be writing event end, which reuses the
+            // slot of event end - capacity.
+            uint64_t end = m_head.load(std::memory_order_relaxed);
+
+            if(end + 1 > first + capacity)
+            {
+                uint64_t overwritten = std::min<uint64_t>(
+                    end + 1 - (first + capacity), events.size());
+
+                events.erase(events.begin(),
+                             events.begin() + (size_t) overwritten);
+            }
+
+            return events;
+        }
+
+        /// @return The total number of events recorded
+        uint64_t recorded() const
+        {
+            return m_head.load(std::memory_order_acquire);
+        }
+
+        /// @return The index of the owning thread
+        uint32_t thread() const
+        {
+            return m_thread;
+        }
+
+    private:
+
+        /// A slot of the ring buffer holding a packed trace_event
+        struct trace_slot
+        {
+            /// The time stamp in trace_clock ticks
+            std::atomic<uint64_t> m_timestamp;
+
+            /// The value in the low 32 bits, then the coder id and the
+            /// event type
+            std::atomic<uint64_t> m_data;
+        };
+
+    private:
+
+        /// The index of the owning thread
+        uint32_t m_thread;
+
+        /// The capacity minus one
+        uint64_t m_mask;
+
+        /// The events
+        std::vector<trace_slot> m_events;
+
+        /// The number of events recorded
+        std::atomic<uint64_t> m_head;
+
+    };
+
+    /// @brief The trace buffers of all threads.
+    ///
+    /// A thread gets its buffer on the first event it records. The
+    /// buffers outlive their threads so the events can be exported
+    /// after the threads finished.
+    class trace_registry : boost::noncopyable
+    {
+    public:
+
+        /// Pointer to a buffer
+        typedef boost::shared_ptr<trace_buffer> buffer_pointer;
+
+    public:
+
+        /// @return The process wide registry
+        static trace_registry& instance()
+        {
+            static trace_registry registry;
+            return registry;
+        }
+
+        /// @return The buffer of the calling thread
+        trace_buffer& local()
+        {
+            static thread_local buffer_pointer buffer;
+
+            if(!buffer)
+            {
+                buffer = add_buffer();
+            }
+
+            return *buffer;
+        }
+
+        /// @return A new unique coder id, wrapping after 65536 coders
+        uint16_t next_coder_id()
+        {
+            return (uint16_t) m_coder_ids.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+
+        /// Sets the number of events kept per thread for the buffers
+        /// created afterwards
+        /// @param capacity The number of events, a power of two
+        void set_capacity(uint32_t capacity)
+        {
+            assert(capacity > 0);
+            assert((capacity & (capacity - 1)) == 0);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = capacity;
+        }
+
+        /// @return The buffers of the threads which recorded events
+        std::vector<buffer_pointer> buffers() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_buffers;
+        }
+
+        /// @param ticks A duration in trace_clock ticks
+        /// @return The duration in microseconds
+        double microseconds(uint64_t ticks) const
+        {
+#if defined(KODO_TRACE_TSC)
+            // Calibrate the time stamp counter against the steady clock
+            // over the lifetime of the registry
+            uint64_t elapsed_ticks = trace_clock::now() - m_start_ticks;
+            uint64_t elapsed_ns =
+                trace_clock::steady_nanoseconds() - m_start_ns;
+
+            if(elapsed_ticks == 0 || elapsed_ns == 0)
+            {
+                return 0.0;
+            }
+
+            return ticks * (elapsed_ns / 1000.0) / elapsed_ticks;
+#else
+            return ticks / 1000.0;
+#endif
+        }
+
+        /// @return The time stamp of the registry creation
+        uint64_t start_ticks() const
+        {
+            return m_start_ticks;
+        }
+
+    private:
+
+        /// Constructor
+        trace_registry()
+            : m_capacity(1 << 16),
+              m_coder_ids(0),
+              m_start_ticks(trace_clock::now()),
+              m_start_ns(trace_clock::steady_nanoseconds())
+        { }
+
+        /// @return A new buffer for the calling thread
+        buffer_pointer add_buffer()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto buffer = boost::make_shared<trace_buffer>(
+                (uint32_t) m_buffers.size(), m_capacity);
+
+            m_buffers.push_back(buffer);
+            return buffer;
+        }
+
+    private:
+
+        /// Protects the buffers and the capacity
+        mutable std::mutex m_mutex;
+
+        /// The buffers of the threads
+        std::vector<buffer_pointer> m_buffers;
+
+        /// The capacity of new buffers
+        uint32_t m_capacity;
+
+        /// The next coder id
+        std::atomic<uint32_t> m_coder_ids;
+
+        /// The clocks when the registry was created
+        uint64_t m_start_ticks;
+        uint64_t m_start_ns;
+
+    };
+
+}
@@ -0,0 +1,76 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "trace_buffer.hpp"
+
+namespace kodo
+{
+
+    /// Writes the events of the trace buffers in the Chrome trace event
+    /// format, which can be opened in chrome://tracing or Perfetto. Every
+    /// event is an instant event on the track of the thread that
+    /// recorded it, with the coder id and the event value as arguments.
+    /// Time stamps are in microseconds since the registry was created,
+    /// written with three decimals so the nanosecond resolution is kept
+    /// for long traces. The formatting of the stream is restored.
+    /// @param out The output stream
+    /// @param registry The registry holding the buffers
+    inline void write_chrome_trace(
+        std::ostream &out,
+        const trace_registry &registry = trace_registry::instance())
+    {
+        std::vector<trace_registry::buffer_pointer> buffers =
+            registry.buffers();
+
+        uint64_t start = registry.start_ticks();
+        bool first = true;
+
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"traceEvents\":[";
+
+        for(const auto &buffer : buffers)
+        {
+            uint32_t thread = buffer->thread();
+
+            out << (first ? "\n" : ",\n");
+            first = false;
+
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                << "\"tid\":" << thread << ",\"args\":{\"name\":\"kodo "
+                << thread << "\"}}";
+
+            for(const trace_event &event : buffer->snapshot())
+            {
+                uint64_t ticks = event.m_timestamp > start ?
+                    event.m_timestamp - start : 0;
+
+                out << ",\n{\"name\":\""
+                    << trace_event_name((trace_event_type) event.m_type)
+                    << "\",\"cat\":\"kodo\",\"ph\":\"i\",\"s\":\"t\","
+                    << "\"ts\":" << registry.microseconds(ticks) << ","
+                    << "\"pid\":0,\"tid\":" << thread << ","
+                    << "\"args\":{\"coder\":" << event.m_coder << ","
+                    << "\"value\":" << event.m_value << "}}";
+            }
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+}
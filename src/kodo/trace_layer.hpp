@@ -0,0 +1,321 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <vector>
+
+#include "trace_buffer.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup debug
+    /// @brief Records the progress of a decoder as compact events in
+    ///        the trace buffer of the calling thread.
+    ///
+    /// Can be placed anywhere above a linear block decoder, i.e. a layer
+    /// providing layer::rank(), layer::symbol_pivot(uint32_t) and
+    /// layer::last_pivot(). Each
+    /// decoded symbol records when it was received and whether it found
+    /// a pivot, was not innovative, or replaced a coded symbol
+    /// (swap_decode). The last symbol also records that the decoder is
+    /// complete. The events are exported with write_chrome_trace().
+    ///
+    /// Placed above a batch_linear_block_decoder, the coded symbols of a
+    /// batch are only queued by decode_symbol(), so their outcome is
+    /// recorded in end_batch() from the pivots found by the batch. Below
+    /// it the batched symbols bypass decode_symbol() and are not
+    /// recorded.
+    ///
+    /// Unlike the debug layers nothing is formatted while decoding, an
+    /// event is a time stamp and a 16 byte store into a ring buffer.
+    /// Tracing can be switched off per factory. Defining
+    /// KODO_DISABLE_TRACE turns the coder into a pass-through without
+    /// members, which neither assigns coder ids nor touches the trace
+    /// registry.
+    template<class SuperCoder>
+    class trace_layer : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_trace(true)
+            { }
+
+            /// @param enabled True if the coders initialized afterwards
+            ///        should record events
+            void set_trace(bool enabled)
+            {
+                m_trace = enabled;
+            }
+
+            /// @return True if the coders record events
+            bool trace() const
+            {
+                return m_trace;
+            }
+
+        private:
+
+            /// Whether the coders record events
+            bool m_trace;
+
+        };
+
+    public:
+
+#if !defined(KODO_DISABLE_TRACE)
+
+        /// Constructor
+        trace_layer()
+            : m_trace_id(0),
+              m_trace(false),
+              m_batching(false),
+              m_batch_symbols(0)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_trace_id = trace_registry::instance().next_coder_id();
+            m_pivots.resize(the_factory.max_symbols(), false);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_trace = the_factory.trace();
+            m_batching = false;
+            m_batch_symbols = 0;
+        }
+
+        /// Starts a batch of the batch_linear_block_decoder below
+        void begin_batch()
+        {
+            SuperCoder::begin_batch();
+
+            m_batching = true;
+            m_batch_symbols = 0;
+        }
+
+        /// Decodes the batch and records the pivots found by its coded
+        /// symbols, and one non-innovative event for each of the others
+        void end_batch()
+        {
+            m_batching = false;
+
+            if(!m_trace || m_batch_symbols == 0)
+            {
+                SuperCoder::end_batch();
+                return;
+            }
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                m_pivots[i] = SuperCoder::symbol_pivot(i);
+            }
+
+            uint32_t rank = SuperCoder::rank();
+
+            SuperCoder::end_batch();
+
+            trace_buffer &buffer = trace_registry::instance().local();
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(!m_pivots[i] && SuperCoder::symbol_pivot(i))
+                {
+                    buffer.record(trace_event_type::pivot_found,
+                                  m_trace_id, i);
+                }
+            }
+
+            uint32_t found = SuperCoder::rank() - rank;
+            assert(found <= m_batch_symbols);
+
+            for(uint32_t i = found; i < m_batch_symbols; ++i)
+            {
+                buffer.record(trace_event_type::non_innovative,
+                              m_trace_id, SuperCoder::rank());
+            }
+
+            m_batch_symbols = 0;
+
+            record_complete(buffer, rank);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            if(!m_trace)
+            {
+                SuperCoder::decode_symbol(symbol_data, symbol_coefficients);
+                return;
+            }
+
+            trace_buffer &buffer = trace_registry::instance().local();
+            uint32_t rank = SuperCoder::rank();
+
+            buffer.record(trace_event_type::received_coded,
+                          m_trace_id, rank);
+
+            SuperCoder::decode_symbol(symbol_data, symbol_coefficients);
+
+            // The outcome is known once the batch is decoded
+            if(m_batching)
+            {
+                ++m_batch_symbols;
+                return;
+            }
+
+            if(SuperCoder::rank() > rank)
+            {
+                buffer.record(trace_event_type::pivot_found,
+                              m_trace_id, SuperCoder::last_pivot());
+            }
+            else
+            {
+                buffer.record(trace_event_type::non_innovative,
+                              m_trace_id, rank);
+            }
+
+            record_complete(buffer, rank);
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            if(!m_trace)
+            {
+                SuperCoder::decode_symbol(symbol_data, symbol_index);
+                return;
+            }
+
+            assert(symbol_index < SuperCoder::symbols());
+
+            trace_buffer &buffer = trace_registry::instance().local();
+            uint32_t rank = SuperCoder::rank();
+
+            buffer.record(trace_event_type::received_uncoded,
+                          m_trace_id, symbol_index);
+
+            bool swap = SuperCoder::symbol_pivot(symbol_index) &&
+                SuperCoder::symbol_coded(symbol_index);
+
+            SuperCoder::decode_symbol(symbol_data, symbol_index);
+
+            if(swap)
+            {
+                buffer.record(trace_event_type::swap_decode,
+                              m_trace_id, symbol_index);
+
+                // The replaced coded symbol is decoded further and may
+                // find a new pivot
+                if(SuperCoder::rank() > rank)
+                {
+                    buffer.record(trace_event_type::pivot_found,
+                                  m_trace_id, SuperCoder::last_pivot());
+                }
+            }
+            else if(SuperCoder::rank() > rank)
+            {
+                buffer.record(trace_event_type::pivot_found,
+                              m_trace_id, symbol_index);
+            }
+            else
+            {
+                buffer.record(trace_event_type::non_innovative,
+                              m_trace_id, rank);
+            }
+
+            record_complete(buffer, rank);
+        }
+
+        /// @return The id of the coder in the recorded events
+        uint16_t trace_id() const
+        {
+            return m_trace_id;
+        }
+
+        /// @return True if the coder records events
+        bool trace_enabled() const
+        {
+            return m_trace;
+        }
+
+    private:
+
+        /// Records the complete event if the last symbol completed the
+        /// decoder
+        /// @param buffer The buffer of the calling thread
+        /// @param rank The rank before the last symbol
+        void record_complete(trace_buffer &buffer, uint32_t rank)
+        {
+            if(rank < SuperCoder::symbols() && SuperCoder::is_complete())
+            {
+                buffer.record(trace_event_type::complete,
+                              m_trace_id, SuperCoder::rank());
+            }
+        }
+
+    private:
+
+        /// The id of the coder in the events
+        uint16_t m_trace_id;
+
+        /// Whether the coder records events
+        bool m_trace;
+
+        /// True between begin_batch() and end_batch()
+        bool m_batching;
+
+        /// The number of coded symbols queued in the current batch
+        uint32_t m_batch_symbols;
+
+        /// The pivots before the current batch was decoded
+        std::vector<bool> m_pivots;
+
+#else
+
+        // The coder adds neither state nor calls to the stack, only the
+        // queries remain so that code using them still compiles
+
+        /// @return Zero, since no coder ids are assigned
+        uint16_t trace_id() const
+        {
+            return 0;
+        }
+
+        /// @return False, since no events are recorded
+        bool trace_enabled() const
+        {
+            return false;
+        }
+
+#endif
+
+    };
+
+}
@@ -0,0 +1,108 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup symbol_id_layers
+    /// @brief Restores the symbol id written by the
+    ///        truncated_symbol_id_writer before passing it to the Symbol
+    ///        ID layer below.
+    ///
+    /// The bytes kept by the writer are copied into an aligned buffer
+    /// and the omitted trailing bytes are zeroed. A packet keeping more
+    /// bytes than the symbol id holds yields the zero vector. As the buffer is
+    /// aligned the coefficients do not have to be copied again by the
+    /// aligned_coefficients_decoder.
+    template<class SuperCoder>
+    class truncated_symbol_id_reader : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::max_id_size() const
+            uint32_t max_id_size() const
+            {
+                uint32_t max_id_size = SuperCoder::factory::max_id_size();
+                return varint_size(max_id_size) + max_id_size;
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_symbol_id.resize(the_factory.max_id_size());
+        }
+
+        /// @copydoc layer::read_id(uint8_t*,uint8_t**)
+        void read_id(uint8_t *symbol_id, uint8_t **symbol_coefficients)
+        {
+            assert(symbol_id != 0);
+            assert(symbol_coefficients != 0);
+
+            uint32_t id_size = SuperCoder::id_size();
+
+            uint32_t kept = 0;
+            uint32_t read = read_varint(symbol_id, &kept);
+
+            // A corrupt packet may keep more bytes than the symbol id
+            // holds, the id is then zeroed such that the symbol is not
+            // innovative
+            if(kept > id_size)
+            {
+                kept = 0;
+            }
+
+            std::copy_n(symbol_id + read, kept, &m_symbol_id[0]);
+            std::fill(&m_symbol_id[0] + kept, &m_symbol_id[0] + id_size, 0);
+
+            SuperCoder::read_id(&m_symbol_id[0], symbol_coefficients);
+        }
+
+        /// @copydoc layer::id_size()
+        uint32_t id_size() const
+        {
+            uint32_t id_size = SuperCoder::id_size();
+            return varint_size(id_size) + id_size;
+        }
+
+    private:
+
+        /// The storage type, the restored symbol id is typically used
+        /// directly as coding coefficients and is therefore aligned
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// Buffer for the restored symbol id
+        aligned_vector m_symbol_id;
+
+    };
+
+}
@@ -0,0 +1,106 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "varint.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup symbol_id_layers
+    /// @brief Omits the trailing zero bytes of the symbol id written by
+    ///        the Symbol ID layer below.
+    ///
+    /// The symbol id is written as a varint with the number of bytes
+    /// kept followed by those bytes. When the encoder rank is below the
+    /// number of symbols (e.g. when encoding on-the-fly) the
+    /// coefficients of the missing symbols are zero and therefore not
+    /// sent. The truncated_symbol_id_reader restores the full symbol
+    /// id on the decoder side.
+    template<class SuperCoder>
+    class truncated_symbol_id_writer : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::max_id_size() const
+            uint32_t max_id_size() const
+            {
+                uint32_t max_id_size = SuperCoder::factory::max_id_size();
+                return varint_size(max_id_size) + max_id_size;
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_symbol_id.resize(the_factory.max_id_size());
+        }
+
+        /// @copydoc layer::write_id(uint8_t*, uint8_t**)
+        uint32_t write_id(uint8_t *symbol_id, uint8_t **coefficients)
+        {
+            assert(symbol_id != 0);
+            assert(coefficients != 0);
+
+            uint32_t id_size =
+                SuperCoder::write_id(&m_symbol_id[0], coefficients);
+
+            assert(id_size <= m_symbol_id.size());
+
+            uint32_t kept = id_size;
+            while(kept > 0 && m_symbol_id[kept - 1] == 0)
+            {
+                --kept;
+            }
+
+            uint32_t written = write_varint(kept, symbol_id);
+            std::copy_n(&m_symbol_id[0], kept, symbol_id + written);
+
+            return written + kept;
+        }
+
+        /// @copydoc layer::id_size()
+        uint32_t id_size() const
+        {
+            uint32_t id_size = SuperCoder::id_size();
+            return varint_size(id_size) + id_size;
+        }
+
+    private:
+
+        /// The storage type, the symbol id may be used directly as
+        /// coding coefficients and is therefore aligned
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// Buffer for the full symbol id
+        aligned_vector m_symbol_id;
+
+    };
+
+}
@@ -0,0 +1,99 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+/// @file
+/// Helpers for the variable length integers used by the compact header
+/// layers. A value is stored in little endian groups of 7 bits, where
+/// the high bit of a byte is set if more bytes follow.
+
+namespace kodo
+{
+
+    /// The largest number of bytes used to store a 32 bit value
+    const uint32_t max_varint_size = 5;
+
+    /// @param value The value to store
+    /// @return The number of bytes needed to store the value
+    inline uint32_t varint_size(uint32_t value)
+    {
+        uint32_t size = 1;
+
+        while(value >= 0x80)
+        {
+            value >>= 7;
+            ++size;
+        }
+
+        return size;
+    }
+
+    /// Writes a value to a buffer
+    /// @param value The value to write
+    /// @param buffer The buffer, must hold at least varint_size(value)
+    ///        bytes
+    /// @return The number of bytes written
+    inline uint32_t write_varint(uint32_t value, uint8_t *buffer)
+    {
+        assert(buffer != 0);
+
+        uint32_t written = 0;
+
+        while(value >= 0x80)
+        {
+            buffer[written++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+
+        buffer[written++] = static_cast<uint8_t>(value);
+
+        return written;
+    }
+
+    /// Reads a value from a buffer. At most max_varint_size bytes are
+    /// read, even if a corrupt value has the continuation bit set in
+    /// every byte. The bits of the last byte which do not fit in 32 bits
+    /// are ignored.
+    /// @param buffer The buffer
+    /// @param value Will contain the value read
+    /// @return The number of bytes read
+    inline uint32_t read_varint(const uint8_t *buffer, uint32_t *value)
+    {
+        assert(buffer != 0);
+        assert(value != 0);
+
+        uint32_t result = 0;
+        uint32_t read = 0;
+
+        while(read < max_varint_size)
+        {
+            uint8_t byte = buffer[read];
+
+            if(read == max_varint_size - 1)
+            {
+                // Only the low 4 bits of the fifth byte fit in 32 bits
+                result |= uint32_t(byte & 0x0f) << (7 * read);
+                ++read;
+                break;
+            }
+
+            result |= uint32_t(byte & 0x7f) << (7 * read);
+            ++read;
+
+            if((byte & 0x80) == 0)
+            {
+                break;
+            }
+        }
+
+        *value = result;
+        return read;
+    }
+
+}
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <kodo/has_shallow_symbol_storage.hpp>
+
 #include "basic_api_test_helper.hpp"
 
 template<class Encoder, class Decoder>
@@ -18,6 +20,14 @@ inline void test_basic_api(uint32_t symbols, uint32_t symbol_size)
     typename Decoder::factory decoder_factory(symbols, symbol_size);
     auto decoder = decoder_factory.build();
 
+    // A shallow decoder decodes directly into the buffer we provide
+    std::vector<uint8_t> data_decoder(decoder->block_size(), '\0');
+
+    if(kodo::has_shallow_symbol_storage<Decoder>::value)
+    {
+        decoder->set_symbols(sak::storage(data_decoder));
+    }
+
     EXPECT_TRUE(symbols == encoder_factory.max_symbols());
     EXPECT_TRUE(symbol_size == encoder_factory.max_symbol_size());
     EXPECT_TRUE(symbols == encoder->symbols());
@@ -89,7 +99,16 @@ inline void test_basic_api(uint32_t symbols, uint32_t symbol_size)
     }
 
     std::vector<uint8_t> data_out(decoder->block_size(), '\0');
-    decoder->copy_symbols(sak::storage(data_out));
+
+    if(kodo::has_shallow_symbol_storage<Decoder>::value)
+    {
+        // The decoded data is already in our buffer
+        data_out = data_decoder;
+    }
+    else
+    {
+        decoder->copy_symbols(sak::storage(data_out));
+    }
 
     if(fifi::is_prime2325<typename Encoder::field_type>::value)
     {
@@ -109,6 +109,83 @@ inline void invoke_recoding(recoding_parameters param)
                            data_in.begin()));
 }
 
+/// Tests the batch recoding function in the same setup as
+/// invoke_recoding(), except that the first decoder recodes several
+/// payloads at a time which are all passed to the second decoder
+///
+/// @param param The recoding parameters to use
+template<class Encoder, class Decoder>
+inline void invoke_batch_recoding(recoding_parameters param)
+{
+    typename Encoder::factory encoder_factory(
+        param.m_max_symbols, param.m_max_symbol_size);
+
+    encoder_factory.set_symbols(param.m_symbols);
+    encoder_factory.set_symbol_size(param.m_symbol_size);
+
+    auto encoder = encoder_factory.build();
+
+    typename Decoder::factory decoder_factory(
+        param.m_max_symbols, param.m_max_symbol_size);
+
+    decoder_factory.set_symbols(param.m_symbols);
+    decoder_factory.set_symbol_size(param.m_symbol_size);
+
+    auto decoder_one = decoder_factory.build();
+    auto decoder_two = decoder_factory.build();
+
+    std::vector<uint8_t> buffer_decoder_one(decoder_one->block_size(), '\0');
+    std::vector<uint8_t> buffer_decoder_two(decoder_two->block_size(), '\0');
+
+    if(kodo::has_shallow_symbol_storage<Decoder>::value)
+    {
+        decoder_one->set_symbols(sak::storage(buffer_decoder_one));
+        decoder_two->set_symbols(sak::storage(buffer_decoder_two));
+    }
+
+    const uint32_t batch = 3;
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<std::vector<uint8_t> > recoded(
+        batch, std::vector<uint8_t>(decoder_one->payload_size()));
+
+    uint8_t *payloads[batch];
+    for(uint32_t i = 0; i < batch; ++i)
+        payloads[i] = &recoded[i][0];
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    if(kodo::is_systematic_encoder(encoder))
+        kodo::set_systematic_off(encoder);
+
+    while( !decoder_two->is_complete() )
+    {
+        encoder->encode( &payload[0] );
+        decoder_one->decode( &payload[0] );
+
+        uint32_t recode_sizes[batch];
+        decoder_one->recode(payloads, batch, recode_sizes);
+
+        for(uint32_t i = 0; i < batch; ++i)
+        {
+            EXPECT_TRUE(recode_sizes[i] <= decoder_one->payload_size());
+            EXPECT_TRUE(recode_sizes[i] > 0);
+
+            decoder_two->decode( payloads[i] );
+        }
+
+        EXPECT_TRUE(decoder_two->rank() <= decoder_one->rank());
+    }
+
+    std::vector<uint8_t> data_out_two(decoder_two->block_size(), '\0');
+    decoder_two->copy_symbols(sak::storage(data_out_two));
+
+    EXPECT_TRUE(std::equal(data_out_two.begin(),
+                           data_out_two.end(),
+                           data_in.begin()));
+}
+
 /// Invokes the recoding API for the Encoder and Decoder with
 /// typical field sizes
 /// @param param The recoding parameters
@@ -130,6 +207,18 @@ inline void test_recoders(recoding_parameters param)
     invoke_recoding<
         Encoder<fifi::binary16>,
         Decoder<fifi::binary16> >(param);
+
+    invoke_batch_recoding<
+        Encoder<fifi::binary>,
+        Decoder<fifi::binary> >(param);
+
+    invoke_batch_recoding<
+        Encoder<fifi::binary8>,
+        Decoder<fifi::binary8> >(param);
+
+    invoke_batch_recoding<
+        Encoder<fifi::binary16>,
+        Decoder<fifi::binary16> >(param);
 }
 
 
@@ -165,6 +254,15 @@ inline void test_recoders()
 
     test_recoders<Encoder,Decoder>(param);
 
+    // Symbols large enough to be split into several tiles when
+    // recoding a batch
+    param.m_max_symbols = 8;
+    param.m_max_symbol_size = 10000;
+    param.m_symbols = param.m_max_symbols;
+    param.m_symbol_size = param.m_max_symbol_size;
+
+    test_recoders<Encoder,Decoder>(param);
+
     param.m_max_symbols = rand_symbols();
     param.m_max_symbol_size = rand_symbol_size();
     param.m_symbols = rand_symbols(param.m_max_symbols);
@@ -10,7 +10,7 @@
 /// Helper function which sets all values in the counter
 /// @param counter The counter to be initialized
 /// @param value The value to use for initialization
-inline void set_values(kodo::operations_counter &counter, uint32_t value)
+inline void set_values(kodo::operations_counter &counter, uint64_t value)
 {
     counter.m_multiply = value;
     counter.m_multiply_add = value;
@@ -18,12 +18,30 @@ inline void set_values(kodo::operations_counter &counter, uint32_t value)
     counter.m_multiply_subtract = value;
     counter.m_subtract = value;
     counter.m_invert = value;
+
+    kodo::operations_bytes* bytes[] =
+        { &counter.m_coefficient_bytes, &counter.m_payload_bytes };
+
+    for(auto b : bytes)
+    {
+        b->m_multiply = value;
+        b->m_multiply_add = value;
+        b->m_add = value;
+        b->m_multiply_subtract = value;
+        b->m_subtract = value;
+    }
+
+    for(uint32_t i = 0; i < kodo::operations_phases; ++i)
+    {
+        counter.m_phase_coefficient_bytes[i] = value;
+        counter.m_phase_payload_bytes[i] = value;
+    }
 }
 
 /// Helper function which tests all values in the counter
 /// @param counter The counter to be tested
 /// @param value The value to use for testing
-inline void test_values(kodo::operations_counter &counter, uint32_t value)
+inline void test_values(kodo::operations_counter &counter, uint64_t value)
 {
     EXPECT_EQ(counter.m_multiply, value);
     EXPECT_EQ(counter.m_multiply_add, value);
@@ -33,4 +51,29 @@ inline void test_values(kodo::operations_counter &counter, uint32_t value)
     EXPECT_EQ(counter.m_invert, value);
 }
 
+/// Helper function which tests all byte counters in the counter
+/// @param counter The counter to be tested
+/// @param value The value to use for testing
+inline void test_byte_values(kodo::operations_counter &counter,
+                             uint64_t value)
+{
+    const kodo::operations_bytes* bytes[] =
+        { &counter.m_coefficient_bytes, &counter.m_payload_bytes };
+
+    for(auto b : bytes)
+    {
+        EXPECT_EQ(b->m_multiply, value);
+        EXPECT_EQ(b->m_multiply_add, value);
+        EXPECT_EQ(b->m_add, value);
+        EXPECT_EQ(b->m_multiply_subtract, value);
+        EXPECT_EQ(b->m_subtract, value);
+    }
+
+    for(uint32_t i = 0; i < kodo::operations_phases; ++i)
+    {
+        EXPECT_EQ(counter.m_phase_coefficient_bytes[i], value);
+        EXPECT_EQ(counter.m_phase_payload_bytes[i], value);
+    }
+}
+
 
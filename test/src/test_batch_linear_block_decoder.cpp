@@ -0,0 +1,131 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_batch_linear_block_decoder.cpp Unit tests for the
+///       batch_linear_block_decoder
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/has_shallow_symbol_storage.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Decodes batches of payloads, some of which are systematic, lost or
+/// duplicated, and compares the result with symbol by symbol decoding
+template<class Encoder, class Decoder>
+void test_batch_decode(uint32_t symbols, uint32_t symbol_size,
+                       uint32_t max_batch)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto batch_decoder = decoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> buffer_batch(batch_decoder->block_size(), '\0');
+    std::vector<uint8_t> buffer(decoder->block_size(), '\0');
+
+    if(kodo::has_shallow_symbol_storage<Decoder>::value)
+    {
+        batch_decoder->set_symbols(sak::storage(buffer_batch));
+        decoder->set_symbols(sak::storage(buffer));
+    }
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    if(rand() % 2)
+        encoder->set_systematic_off();
+
+    uint32_t payload_size = encoder->payload_size();
+
+    std::vector<std::vector<uint8_t> > batch(
+        max_batch, std::vector<uint8_t>(payload_size));
+    std::vector<std::vector<uint8_t> > copies(
+        max_batch, std::vector<uint8_t>(payload_size));
+
+    std::vector<uint8_t*> payloads(max_batch);
+
+    while(!batch_decoder->is_complete())
+    {
+        uint32_t count = 1 + (rand() % max_batch);
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            if(i > 0 && rand() % 8 == 0)
+            {
+                // Duplicates are not innovative
+                batch[i] = batch[i - 1];
+            }
+            else
+            {
+                encoder->encode(&batch[i][0]);
+            }
+
+            copies[i] = batch[i];
+            payloads[i] = &batch[i][0];
+        }
+
+        batch_decoder->decode(&payloads[0], count);
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            decoder->decode(&copies[i][0]);
+        }
+
+        // Both decoders see the same symbols
+        EXPECT_EQ(decoder->rank(), batch_decoder->rank());
+    }
+
+    EXPECT_TRUE(decoder->is_complete());
+
+    std::vector<uint8_t> data_out(batch_decoder->block_size(), '\0');
+    batch_decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+template<template <class> class Decoder, class Field>
+void test_batch_decode(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef Decoder<Field> decoder_type;
+
+    test_batch_decode<encoder_type, decoder_type>(
+        symbols, symbol_size, 1);
+    test_batch_decode<encoder_type, decoder_type>(
+        symbols, symbol_size, 16);
+    test_batch_decode<encoder_type, decoder_type>(
+        symbols, symbol_size, 64);
+}
+
+TEST(TestBatchLinearBlockDecoder, decode)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary>(
+        symbols, symbol_size);
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary8>(
+        symbols, symbol_size);
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary16>(
+        symbols, symbol_size);
+
+    test_batch_decode<kodo::shallow_full_rlnc_decoder, fifi::binary8>(
+        symbols, symbol_size);
+}
+
+/// Symbols larger than a tile are processed in several tiles
+TEST(TestBatchLinearBlockDecoder, tiles)
+{
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary>(16, 20000);
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary8>(16, 10003);
+    test_batch_decode<kodo::full_rlnc_decoder, fifi::binary16>(8, 10002);
+}
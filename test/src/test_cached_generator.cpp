@@ -0,0 +1,209 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_cached_generator.cpp Unit tests for the cached_generator
+///       and the seed_coefficient_cache
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/seed_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks the bounds and eviction of the cache
+TEST(TestCachedGenerator, cache)
+{
+    kodo::seed_coefficient_cache<fifi::binary8> cache(4, 8);
+
+    std::vector<uint8_t> in(8);
+    std::vector<uint8_t> out(8);
+
+    for(uint32_t seed = 0; seed < 4; ++seed)
+    {
+        std::fill(in.begin(), in.end(), (uint8_t) seed);
+        cache.insert(10, seed, &in[0], 8);
+    }
+
+    EXPECT_EQ(4U, cache.size());
+    EXPECT_FALSE(cache.find(11, 0, &out[0], 8));
+
+    // Reference seed 1, which should then survive the next eviction
+    EXPECT_TRUE(cache.find(10, 1, &out[0], 8));
+    EXPECT_EQ(1U, out[7]);
+
+    cache.insert(10, 4, &in[0], 8);
+    cache.insert(10, 5, &in[0], 8);
+
+    EXPECT_EQ(4U, cache.size());
+    EXPECT_TRUE(cache.contains(10, 1, 8));
+    EXPECT_TRUE(cache.contains(10, 4, 8));
+    EXPECT_TRUE(cache.contains(10, 5, 8));
+
+    EXPECT_EQ(1U, cache.hits());
+    EXPECT_EQ(1U, cache.misses());
+
+    // The size is part of the key
+    EXPECT_FALSE(cache.contains(10, 1, 4));
+    EXPECT_FALSE(cache.find(10, 1, &out[0], 4));
+
+    // Vectors larger than a slot are refused
+    std::vector<uint8_t> large(9);
+    EXPECT_FALSE(cache.insert(10, 6, &large[0], 9));
+    EXPECT_FALSE(cache.contains(10, 6, 9));
+    EXPECT_TRUE(cache.contains(10, 1, 8));
+}
+
+/// Checks that a factory only accepts a cache of its field whose slots
+/// hold its coefficient vectors
+TEST(TestCachedGenerator, set_cache)
+{
+    typedef kodo::seed_rlnc_decoder<fifi::binary8> decoder_type;
+    typedef kodo::seed_rlnc_decoder<fifi::binary16> other_decoder_type;
+
+    static_assert(!std::is_same<decoder_type::cache_type,
+                      other_decoder_type::cache_type>::value,
+                  "Coders of different fields must not share a cache");
+
+    decoder_type::factory small_factory(16, 100);
+    decoder_type::factory large_factory(32, 100);
+
+    small_factory.set_cache_capacity(64);
+    auto cache = small_factory.cache();
+
+    // The slots of the cache only hold 16 coefficients
+    EXPECT_FALSE(large_factory.set_cache(cache));
+    EXPECT_FALSE((bool) large_factory.cache());
+
+    large_factory.set_cache_capacity(64);
+    auto large_cache = large_factory.cache();
+
+    EXPECT_TRUE(small_factory.set_cache(large_cache));
+    EXPECT_EQ(large_cache, small_factory.cache());
+
+    // Both factories share the cache without mixing their vectors
+    auto small = small_factory.build();
+    auto large = large_factory.build();
+
+    small->expand_seeds(0, 8);
+    large->expand_seeds(0, 8);
+
+    EXPECT_EQ(16U, large_cache->size());
+
+    EXPECT_TRUE(small_factory.set_cache(decoder_type::cache_pointer()));
+    EXPECT_FALSE((bool) small_factory.cache());
+}
+
+/// Decodes the same stream with several decoders sharing a cache
+template<class Field>
+void test_cached_generator(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::seed_rlnc_encoder<Field> encoder_type;
+    typedef kodo::seed_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    decoder_factory.set_cache_capacity(4 * symbols);
+
+    auto encoder = encoder_factory.build();
+    encoder->set_systematic_off();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector< std::vector<uint8_t> > payloads;
+    for(uint32_t i = 0; i < 2 * symbols + 10; ++i)
+    {
+        payloads.push_back(std::vector<uint8_t>(encoder->payload_size()));
+        encoder->encode(&payloads.back()[0]);
+    }
+
+    for(uint32_t receiver = 0; receiver < 3; ++receiver)
+    {
+        auto decoder = decoder_factory.build();
+
+        for(uint32_t i = 0; i < payloads.size(); ++i)
+        {
+            if(decoder->is_complete())
+                break;
+
+            std::vector<uint8_t> payload = payloads[i];
+            decoder->decode(&payload[0]);
+        }
+
+        ASSERT_TRUE(decoder->is_complete());
+
+        std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+        decoder->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(data_in == data_out);
+    }
+
+    auto cache = decoder_factory.cache();
+    ASSERT_TRUE((bool) cache);
+
+    // Only the first decoder expanded the seeds
+    EXPECT_GT(cache->hits(), 0U);
+    EXPECT_LE(cache->misses(), payloads.size());
+    EXPECT_LE(cache->size(), cache->capacity());
+}
+
+TEST(TestCachedGenerator, shared_cache)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_cached_generator<fifi::binary>(symbols, symbol_size);
+    test_cached_generator<fifi::binary8>(symbols, symbol_size);
+    test_cached_generator<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Checks that pre-expanded seeds give the same coefficients as the
+/// generator and that no lookups miss afterwards
+TEST(TestCachedGenerator, expand_seeds)
+{
+    typedef kodo::seed_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 32;
+
+    decoder_type::factory decoder_factory(symbols, 16);
+    decoder_factory.set_cache_capacity(64);
+
+    auto decoder = decoder_factory.build();
+    decoder->expand_seeds(0, 64);
+
+    auto cache = decoder_factory.cache();
+    EXPECT_EQ(64U, cache->size());
+
+    std::vector<uint8_t> cached(decoder->coefficients_size());
+    std::vector<uint8_t> generated(decoder->coefficients_size());
+
+    decoder_type::factory plain_factory(symbols, 16);
+    auto plain = plain_factory.build();
+
+    for(uint32_t seed = 0; seed < 64; ++seed)
+    {
+        decoder->seed(seed);
+        decoder->generate(&cached[0]);
+
+        plain->seed(seed);
+        plain->generate(&generated[0]);
+
+        EXPECT_TRUE(cached == generated);
+
+        // The generator continues where the cached vector ends
+        decoder->generate(&cached[0]);
+        plain->generate(&generated[0]);
+
+        EXPECT_TRUE(cached == generated);
+    }
+
+    EXPECT_EQ(64U, cache->hits());
+    EXPECT_EQ(0U, cache->misses());
+}
@@ -0,0 +1,146 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_caching_object_encoder.cpp Unit tests for the
+///       caching_object_encoder
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/caching_object_encoder.hpp>
+#include <kodo/object_decoder.hpp>
+#include <kodo/storage_reader.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_type;
+    typedef kodo::full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    typedef kodo::storage_reader<encoder_type> reader_type;
+    typedef kodo::caching_object_encoder<reader_type, encoder_type>
+        caching_encoder_type;
+
+    const uint32_t symbols = 16;
+    const uint32_t symbol_size = 64;
+    const uint32_t blocks = 6;
+}
+
+/// Checks the hit and miss statistics and the bound on the cache
+TEST(TestCachingObjectEncoder, lru)
+{
+    std::vector<uint8_t> data_in =
+        random_vector(blocks * symbols * symbol_size);
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    reader_type reader(sak::storage(data_in));
+
+    caching_encoder_type encoder(encoder_factory, reader, 2);
+    encoder.set_prefetch_distance(0);
+
+    EXPECT_EQ(blocks, encoder.encoders());
+    EXPECT_EQ(2U, encoder.capacity());
+
+    auto first = encoder.build(0);
+    auto again = encoder.build(0);
+
+    EXPECT_EQ(first.get(), again.get());
+    EXPECT_EQ(1U, encoder.hits());
+    EXPECT_EQ(1U, encoder.misses());
+
+    encoder.build(1);
+    encoder.build(0);
+    encoder.build(2);
+
+    // Block 1 was the least recently used and is evicted
+    EXPECT_EQ(2U, encoder.cached());
+    EXPECT_EQ(2U, encoder.hits());
+    EXPECT_EQ(3U, encoder.misses());
+
+    encoder.build(0);
+    encoder.build(1);
+
+    EXPECT_EQ(3U, encoder.hits());
+    EXPECT_EQ(4U, encoder.misses());
+    EXPECT_EQ(0U, encoder.prefetched());
+    EXPECT_EQ(2U, encoder.cached());
+}
+
+/// Checks that the following blocks are built in the background
+TEST(TestCachingObjectEncoder, prefetch)
+{
+    std::vector<uint8_t> data_in =
+        random_vector(blocks * symbols * symbol_size);
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    reader_type reader(sak::storage(data_in));
+
+    caching_encoder_type encoder(encoder_factory, reader, 3);
+    encoder.set_prefetch_distance(2);
+
+    for(uint32_t i = 0; i < blocks; ++i)
+    {
+        encoder.build(i);
+        encoder.wait();
+    }
+
+    // Only the first block is built in the foreground
+    EXPECT_EQ(1U, encoder.misses());
+    EXPECT_EQ(blocks - 1, encoder.hits());
+    EXPECT_EQ(blocks - 1, encoder.prefetched());
+    EXPECT_LE(encoder.cached(), encoder.capacity());
+}
+
+/// Decodes the object from encoders served by the cache
+TEST(TestCachingObjectEncoder, decode)
+{
+    uint32_t object_size = rand_nonzero(blocks * symbols * symbol_size);
+    std::vector<uint8_t> data_in = random_vector(object_size);
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    reader_type reader(sak::storage(data_in));
+    caching_encoder_type encoder(encoder_factory, reader, 2);
+
+    kodo::object_decoder<decoder_type> object_decoder(
+        decoder_factory, object_size);
+
+    EXPECT_EQ(encoder.encoders(), object_decoder.decoders());
+    EXPECT_EQ(object_size, encoder.object_size());
+
+    uint32_t offset = 0;
+
+    for(uint32_t i = 0; i < encoder.encoders(); ++i)
+    {
+        auto block_encoder = encoder.build(i);
+        auto block_decoder = object_decoder.build(i);
+
+        std::vector<uint8_t> payload(block_encoder->payload_size());
+
+        while(!block_decoder->is_complete())
+        {
+            block_encoder->encode(&payload[0]);
+            block_decoder->decode(&payload[0]);
+        }
+
+        std::vector<uint8_t> data_out(block_decoder->block_size());
+        block_decoder->copy_symbols(sak::storage(data_out));
+
+        uint32_t bytes_used = block_decoder->bytes_used();
+
+        EXPECT_TRUE(std::equal(data_out.begin(),
+                               data_out.begin() + bytes_used,
+                               data_in.begin() + offset));
+
+        offset += bytes_used;
+    }
+
+    EXPECT_EQ(object_size, offset);
+}
@@ -0,0 +1,313 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_checkpoint_decoder.cpp Unit tests for the
+///       kodo::checkpoint_decoder
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/checkpoint_decoder.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+    template<class Field>
+    class test_checkpoint_delayed_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 checkpoint_decoder<
+                 aligned_coefficients_decoder<
+                 linear_block_decoder_delayed<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 test_checkpoint_delayed_decoder<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+}
+
+/// Checkpoints a partially decoded decoder, restores it into a second
+/// decoder and checks that both decoders finish with the same data
+template<class Encoder, class Decoder>
+void test_checkpoint(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    std::vector<uint8_t> data_in_copy(data_in);
+
+    // The prime2325 field cannot hold all 32 bit values, so the data is
+    // mapped into the field with a prefix
+    uint32_t prefix = 0;
+
+    if(fifi::is_prime2325<typename Encoder::field_type>::value)
+    {
+        fifi::prime2325_binary_search search(encoder->block_size() / 4);
+        prefix = search.find_prefix(sak::storage(data_in_copy));
+
+        fifi::apply_prefix(sak::storage(data_in_copy), ~prefix);
+    }
+
+    encoder->set_symbols(sak::storage(data_in_copy));
+
+    // Lose some of the systematic symbols to get both coded and
+    // uncoded symbols in the decoder
+    while(decoder->rank() < symbols / 2)
+    {
+        encoder->encode(&payload[0]);
+
+        if(rand() % 2)
+        {
+            continue;
+        }
+
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> checkpoint(
+        decoder_factory.max_checkpoint_size());
+
+    uint32_t checkpoint_size = decoder->checkpoint_size();
+    EXPECT_TRUE(checkpoint_size <= checkpoint.size());
+    EXPECT_EQ(checkpoint_size, decoder->write_checkpoint(&checkpoint[0]));
+
+    // The restored decoder comes from the same pool
+    auto restored = decoder_factory.build();
+    EXPECT_TRUE(restored->restore_checkpoint(
+                    &checkpoint[0], checkpoint_size));
+
+    EXPECT_EQ(decoder->rank(), restored->rank());
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_EQ(decoder->symbol_pivot(i), restored->symbol_pivot(i));
+
+        if(!decoder->symbol_pivot(i))
+        {
+            continue;
+        }
+
+        EXPECT_EQ(decoder->symbol_coded(i), restored->symbol_coded(i));
+
+        EXPECT_TRUE(std::equal(decoder->symbol(i),
+                               decoder->symbol(i) + symbol_size,
+                               restored->symbol(i)));
+    }
+
+    // Both decoders continue with the same symbols
+    std::vector<uint8_t> copy(payload.size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        copy = payload;
+
+        decoder->decode(&payload[0]);
+        restored->decode(&copy[0]);
+
+        EXPECT_EQ(decoder->rank(), restored->rank());
+    }
+
+    EXPECT_TRUE(restored->is_complete());
+
+    std::vector<uint8_t> data_out(restored->block_size(), '\0');
+    restored->copy_symbols(sak::storage(data_out));
+
+    if(fifi::is_prime2325<typename Encoder::field_type>::value)
+    {
+        fifi::apply_prefix(sak::storage(data_out), ~prefix);
+    }
+
+    EXPECT_TRUE(data_in == data_out);
+
+    // A complete decoder produces a checkpoint of the full block
+    EXPECT_EQ(decoder->checkpoint_size(),
+              decoder->write_checkpoint(&checkpoint[0]));
+}
+
+/// Checks that invalid checkpoints are rejected without changing the
+/// decoder. OtherField must differ from Field in its checkpoint field id
+template<class Field, class OtherField>
+void test_invalid_checkpoint(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    std::vector<uint8_t> checkpoint(decoder->checkpoint_size());
+    decoder->write_checkpoint(&checkpoint[0]);
+
+    auto restored = decoder_factory.build();
+
+    // Truncated
+    EXPECT_FALSE(restored->restore_checkpoint(
+                     &checkpoint[0], checkpoint.size() - 1));
+
+    // Wrong magic
+    std::vector<uint8_t> corrupt = checkpoint;
+    corrupt[0] ^= 0xff;
+    EXPECT_FALSE(restored->restore_checkpoint(
+                     &corrupt[0], corrupt.size()));
+
+    // Wrong version
+    corrupt = checkpoint;
+    corrupt[5] ^= 0xff;
+    EXPECT_FALSE(restored->restore_checkpoint(
+                     &corrupt[0], corrupt.size()));
+
+    // Rank not matching the pivots
+    corrupt = checkpoint;
+    corrupt[19] ^= 0x02;
+    EXPECT_FALSE(restored->restore_checkpoint(
+                     &corrupt[0], corrupt.size()));
+
+    // Padding bits set after the last symbol of the bitmaps
+    if(symbols % 8 != 0)
+    {
+        uint32_t padding = 20 + symbols / 8;
+        uint32_t bitmap_size = (symbols + 7) / 8;
+
+        corrupt = checkpoint;
+        corrupt[padding] |= 1U << (symbols % 8);
+        EXPECT_FALSE(restored->restore_checkpoint(
+                         &corrupt[0], corrupt.size()));
+
+        corrupt = checkpoint;
+        corrupt[padding + bitmap_size] |= 1U << (symbols % 8);
+        EXPECT_FALSE(restored->restore_checkpoint(
+                         &corrupt[0], corrupt.size()));
+    }
+
+    EXPECT_EQ(0U, restored->rank());
+
+    // Different number of symbols
+    typename decoder_type::factory other_factory(symbols + 1, symbol_size);
+    auto other = other_factory.build();
+
+    EXPECT_FALSE(other->restore_checkpoint(
+                     &checkpoint[0], checkpoint.size()));
+
+    EXPECT_EQ(0U, other->rank());
+
+    // Different field
+    typename kodo::full_rlnc_decoder<OtherField>::factory
+        other_field_factory(symbols, symbol_size);
+    auto other_field = other_field_factory.build();
+
+    EXPECT_FALSE(other_field->restore_checkpoint(
+                     &checkpoint[0], checkpoint.size()));
+
+    EXPECT_EQ(0U, other_field->rank());
+
+    EXPECT_TRUE(restored->restore_checkpoint(
+                    &checkpoint[0], checkpoint.size()));
+
+    EXPECT_EQ(1U, restored->rank());
+
+    // The coefficients of a restored decoded symbol read as its unit
+    // vector
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        if(!restored->symbol_pivot(i) || restored->symbol_coded(i))
+        {
+            continue;
+        }
+
+        auto coefficients = restored->coefficients_value(i);
+
+        for(uint32_t j = 0; j < symbols; ++j)
+        {
+            EXPECT_EQ(i == j ? 1U : 0U,
+                      fifi::get_value<Field>(coefficients, j));
+        }
+    }
+}
+
+TEST(TestCheckpointDecoder, checkpoint)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_checkpoint<kodo::full_rlnc_encoder<fifi::binary>,
+                    kodo::full_rlnc_decoder<fifi::binary> >(
+                        symbols, symbol_size);
+
+    test_checkpoint<kodo::full_rlnc_encoder<fifi::binary8>,
+                    kodo::full_rlnc_decoder<fifi::binary8> >(
+                        symbols, symbol_size);
+
+    test_checkpoint<kodo::full_rlnc_encoder<fifi::binary16>,
+                    kodo::full_rlnc_decoder<fifi::binary16> >(
+                        symbols, symbol_size);
+
+    test_checkpoint<kodo::full_rlnc_encoder<fifi::binary32>,
+                    kodo::full_rlnc_decoder<fifi::binary32> >(
+                        symbols, symbol_size);
+
+    test_checkpoint<kodo::full_rlnc_encoder<fifi::prime2325>,
+                    kodo::full_rlnc_decoder<fifi::prime2325> >(
+                        symbols, symbol_size);
+
+    test_checkpoint<
+        kodo::full_rlnc_encoder<fifi::binary8>,
+        kodo::test_checkpoint_delayed_decoder<fifi::binary8> >(
+            symbols, symbol_size);
+}
+
+TEST(TestCheckpointDecoder, invalid_checkpoint)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_invalid_checkpoint<fifi::binary, fifi::binary8>(
+        symbols, symbol_size);
+    test_invalid_checkpoint<fifi::binary8, fifi::binary>(
+        symbols, symbol_size);
+    test_invalid_checkpoint<fifi::binary16, fifi::binary8>(
+        symbols, symbol_size);
+    test_invalid_checkpoint<fifi::binary32, fifi::prime2325>(
+        symbols, symbol_size);
+    test_invalid_checkpoint<fifi::prime2325, fifi::binary32>(
+        symbols, symbol_size);
+}
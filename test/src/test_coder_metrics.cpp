@@ -0,0 +1,513 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_coder_metrics.cpp Unit tests for the metrics_decoder and
+///       metrics_encoder layers
+
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/metrics_decoder.hpp>
+#include <kodo/metrics_encoder.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+    /// A full_rlnc_encoder maintaining metrics
+    template<class Field>
+    class metrics_full_rlnc_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               metrics_encoder<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               metrics_full_rlnc_encoder<Field
+                   > > > > > > > > > > > > > > > > >
+    { };
+
+    /// A full_rlnc_decoder maintaining metrics
+    template<class Field>
+    class metrics_full_rlnc_decoder
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 metrics_decoder<
+                 aligned_coefficients_decoder<
+                 batch_linear_block_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 metrics_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+}
+
+/// Checks the counters of one encoder and decoder pair
+template<class Field>
+void test_coder_metrics(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::metrics_full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::metrics_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    // Lose every other systematic symbol
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint32_t systematic = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        ++sent;
+
+        if(sent <= symbols && sent % 2 == 0)
+            continue;
+
+        decoder->decode(&payload[0]);
+        ++received;
+
+        if(sent <= symbols)
+            ++systematic;
+    }
+
+    // A duplicate is not innovative
+    decoder->decode(&payload[0]);
+    ++received;
+
+    if(sent <= symbols)
+        ++systematic;
+
+    kodo::metrics_snapshot e = encoder->metrics().snapshot();
+    kodo::metrics_snapshot d = decoder->metrics().snapshot();
+
+    EXPECT_EQ(sent, e.m_payloads);
+    EXPECT_EQ(symbols, e.m_systematic);
+    EXPECT_EQ(sent * (uint64_t) symbol_size, e.m_bytes);
+
+    EXPECT_EQ(received, d.m_payloads);
+    EXPECT_EQ(received * (uint64_t) symbol_size, d.m_bytes);
+    EXPECT_EQ(systematic, d.m_systematic);
+    EXPECT_EQ(symbols, d.m_innovative);
+    EXPECT_EQ(received - symbols, d.m_non_innovative);
+    EXPECT_EQ(0U, d.m_swaps);
+    EXPECT_EQ(1U, d.m_completed);
+    EXPECT_GT(d.m_decode_nanoseconds, 0U);
+    EXPECT_GT(d.non_innovative_rate(), 0.0);
+
+    // The factory totals include the counters of the live coders
+    kodo::metrics_snapshot total = decoder_factory.metrics()->snapshot();
+    EXPECT_EQ(d.m_payloads, total.m_payloads);
+    EXPECT_EQ(d.m_innovative, total.m_innovative);
+    EXPECT_EQ(d.m_completed, total.m_completed);
+    EXPECT_EQ(d.m_decode_nanoseconds, total.m_decode_nanoseconds);
+
+    EXPECT_EQ(e.m_bytes, encoder_factory.metrics()->value(
+                  kodo::coder_metrics::bytes));
+
+    // Initializing the encoder again moves its counters to the totals
+    encoder->initialize(encoder_factory);
+
+    EXPECT_EQ(e.m_bytes, encoder_factory.metrics()->value(
+                  kodo::coder_metrics::bytes));
+    EXPECT_EQ(0U, encoder->metrics().value(kodo::coder_metrics::bytes));
+
+    // A new decoding resets the decoder but not the totals
+    decoder->initialize(decoder_factory);
+
+    EXPECT_EQ(0U, decoder->metrics().value(kodo::coder_metrics::payloads));
+    EXPECT_EQ(received, decoder_factory.metrics()->value(
+                  kodo::coder_metrics::payloads));
+}
+
+TEST(TestCoderMetrics, encode_decode)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_coder_metrics<fifi::binary>(symbols, symbol_size);
+    test_coder_metrics<fifi::binary8>(symbols, symbol_size);
+    test_coder_metrics<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Decodes batches of payloads with decode(uint8_t**,uint32_t) and
+/// checks that the coded symbols of a batch are counted when the batch
+/// is decoded
+template<class Field>
+void test_coder_metrics_batch(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::metrics_full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::metrics_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Only coded symbols, which are queued until end_batch()
+    kodo::set_systematic_off(encoder);
+
+    const uint32_t batch = 4;
+
+    std::vector<std::vector<uint8_t>> buffers(
+        batch, std::vector<uint8_t>(encoder->payload_size()));
+
+    std::vector<uint8_t*> payloads;
+
+    for(auto &buffer : buffers)
+    {
+        payloads.push_back(&buffer[0]);
+    }
+
+    uint32_t sent = 0;
+
+    while(!decoder->is_complete())
+    {
+        for(auto &buffer : buffers)
+        {
+            encoder->encode(&buffer[0]);
+            ++sent;
+        }
+
+        decoder->decode(&payloads[0], batch);
+    }
+
+    // A batch received after completion is not innovative
+    decoder->decode(&payloads[0], batch);
+    sent += batch;
+
+    kodo::metrics_snapshot d = decoder->metrics().snapshot();
+
+    EXPECT_EQ(sent, d.m_payloads);
+    EXPECT_EQ(sent * (uint64_t) symbol_size, d.m_bytes);
+    EXPECT_EQ(0U, d.m_systematic);
+    EXPECT_EQ(symbols, d.m_innovative);
+    EXPECT_EQ(sent - symbols, d.m_non_innovative);
+    EXPECT_EQ(1U, d.m_completed);
+    EXPECT_GT(d.m_decode_nanoseconds, 0U);
+
+    kodo::metrics_snapshot total = decoder_factory.metrics()->snapshot();
+    EXPECT_EQ(d.m_payloads, total.m_payloads);
+    EXPECT_EQ(d.m_innovative, total.m_innovative);
+    EXPECT_EQ(d.m_non_innovative, total.m_non_innovative);
+    EXPECT_EQ(1U, total.m_completed);
+    EXPECT_EQ(d.m_decode_nanoseconds, total.m_decode_nanoseconds);
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestCoderMetrics, decode_batch)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_coder_metrics_batch<fifi::binary>(symbols, symbol_size);
+    test_coder_metrics_batch<fifi::binary8>(symbols, symbol_size);
+    test_coder_metrics_batch<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Reads the factory totals of a decoder which has not completed, of
+/// an encoder which is never initialized again and of idle coders
+TEST(TestCoderMetrics, live_totals)
+{
+    typedef kodo::metrics_full_rlnc_encoder<fifi::binary8> encoder_type;
+    typedef kodo::metrics_full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 32;
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(1U, decoder_factory.metrics()->live());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    // Stall the decoder halfway
+    for(uint32_t i = 0; i < symbols / 2; ++i)
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    ASSERT_FALSE(decoder->is_complete());
+
+    kodo::metrics_snapshot total = decoder_factory.metrics()->snapshot();
+    EXPECT_EQ(symbols / 2, total.m_payloads);
+    EXPECT_EQ(symbols / 2, total.m_innovative);
+    EXPECT_EQ(0U, total.m_completed);
+
+    EXPECT_EQ(symbols / 2, encoder_factory.metrics()->value(
+                  kodo::coder_metrics::payloads));
+
+    // Coders returned to the pool keep their counts in the totals
+    decoder.reset();
+    encoder.reset();
+
+    EXPECT_EQ(symbols / 2, decoder_factory.metrics()->value(
+                  kodo::coder_metrics::payloads));
+    EXPECT_EQ(symbols / 2, encoder_factory.metrics()->value(
+                  kodo::coder_metrics::payloads));
+
+    // A coder reused from the pool starts from zero, the totals do not
+    decoder = decoder_factory.build();
+
+    EXPECT_EQ(0U, decoder->metrics().value(kodo::coder_metrics::payloads));
+    EXPECT_EQ(symbols / 2, decoder_factory.metrics()->value(
+                  kodo::coder_metrics::payloads));
+}
+
+/// An uncoded symbol at the pivot of a coded symbol counts as a swap
+TEST(TestCoderMetrics, swap)
+{
+    typedef kodo::metrics_full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 4;
+    uint32_t symbol_size = 16;
+
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> symbol(symbol_size, 1);
+    std::vector<uint8_t> coefficients(decoder->coefficients_size(), 0);
+
+    // The coded symbol 1 * s0 + 1 * s1 takes pivot 0
+    coefficients[0] = 1;
+    coefficients[1] = 1;
+    decoder->decode_symbol(&symbol[0], &coefficients[0]);
+
+    decoder->decode_symbol(&symbol[0], (uint32_t) 0);
+
+    kodo::metrics_snapshot d = decoder->metrics().snapshot();
+
+    EXPECT_EQ(1U, d.m_swaps);
+    EXPECT_EQ(1U, d.m_systematic);
+    EXPECT_EQ(2U, d.m_innovative);
+    EXPECT_EQ(0U, d.m_non_innovative);
+    EXPECT_EQ(2U, decoder->rank());
+}
+
+/// Scrapes the totals while decoders run in several threads
+TEST(TestCoderMetrics, factory_totals)
+{
+    typedef kodo::metrics_full_rlnc_encoder<fifi::binary8> encoder_type;
+    typedef kodo::metrics_full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 64;
+    uint32_t threads = 4;
+    uint32_t decodings = 20;
+
+    auto totals = boost::make_shared<kodo::coder_metrics>();
+
+    // One factory per thread since the factories are not thread-safe,
+    // the threads add their totals to a common coder_metrics
+    std::vector<std::thread> workers;
+
+    for(uint32_t t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&, t]()
+            {
+                encoder_type::factory encoder_factory(symbols, symbol_size);
+                decoder_type::factory decoder_factory(symbols, symbol_size);
+
+                auto encoder = encoder_factory.build();
+                std::vector<uint8_t> data(encoder->block_size(), t);
+                encoder->set_symbols(sak::storage(data));
+
+                std::vector<uint8_t> payload(encoder->payload_size());
+
+                for(uint32_t i = 0; i < decodings; ++i)
+                {
+                    encoder->initialize(encoder_factory);
+                    encoder->set_symbols(sak::storage(data));
+
+                    auto decoder = decoder_factory.build();
+
+                    while(!decoder->is_complete())
+                    {
+                        encoder->encode(&payload[0]);
+                        decoder->decode(&payload[0]);
+                    }
+                }
+
+                kodo::metrics_snapshot s =
+                    decoder_factory.metrics()->snapshot();
+
+                totals->add(kodo::coder_metrics::completed,
+                            s.m_completed);
+                totals->add(kodo::coder_metrics::innovative,
+                            s.m_innovative);
+            }));
+    }
+
+    for(auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(threads * decodings,
+              totals->value(kodo::coder_metrics::completed));
+    EXPECT_EQ(threads * decodings * symbols,
+              totals->value(kodo::coder_metrics::innovative));
+
+    // The decoders of one factory are built by the main thread and
+    // decode in several threads, while a monitoring thread reads the
+    // totals they add to
+    decoder_type::factory shared(symbols, symbol_size);
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+
+    std::vector<uint8_t> data = random_vector(
+        encoder_factory.max_symbols() * encoder_factory.max_symbol_size());
+
+    std::vector<encoder_type::pointer> encoders;
+    std::vector<decoder_type::pointer> decoders;
+
+    for(uint32_t t = 0; t < threads; ++t)
+    {
+        auto encoder = encoder_factory.build();
+        encoder->set_symbols(sak::storage(data));
+        kodo::set_systematic_off(encoder);
+
+        encoders.push_back(encoder);
+
+        for(uint32_t i = 0; i < decodings; ++i)
+        {
+            decoders.push_back(shared.build());
+        }
+    }
+
+    std::atomic<bool> done(false);
+    uint64_t last = 0;
+    bool monotonic = true;
+
+    std::thread monitor([&]()
+        {
+            while(!done)
+            {
+                uint64_t payloads = shared.metrics()->value(
+                    kodo::coder_metrics::payloads);
+
+                monotonic = monotonic && payloads >= last;
+                last = payloads;
+            }
+        });
+
+    std::vector<uint64_t> sent(threads, 0);
+    workers.clear();
+
+    for(uint32_t t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&, t]()
+            {
+                auto encoder = encoders[t];
+                std::vector<uint8_t> payload(encoder->payload_size());
+
+                for(uint32_t i = 0; i < decodings; ++i)
+                {
+                    auto decoder = decoders[t * decodings + i];
+
+                    while(!decoder->is_complete())
+                    {
+                        encoder->encode(&payload[0]);
+                        decoder->decode(&payload[0]);
+                        ++sent[t];
+                    }
+                }
+            }));
+    }
+
+    for(auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    done = true;
+    monitor.join();
+
+    EXPECT_TRUE(monotonic);
+
+    uint64_t payloads = 0;
+
+    for(uint64_t s : sent)
+    {
+        payloads += s;
+    }
+
+    // The totals hold the counts of all decoders
+    uint64_t completed = threads * decodings;
+
+    kodo::metrics_snapshot s = shared.metrics()->snapshot();
+    EXPECT_EQ(payloads, s.m_payloads);
+    EXPECT_EQ(completed, s.m_completed);
+    EXPECT_EQ(completed * symbols, s.m_innovative);
+    EXPECT_EQ(payloads - completed * symbols, s.m_non_innovative);
+    EXPECT_GT(s.average_decode_nanoseconds(), 0.0);
+}
@@ -0,0 +1,94 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_decoding_probability_simulator.cpp Unit tests for the
+///       decoding_probability_simulator
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <kodo/decoding_probability_simulator.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Without erasures the systematic symbols decode the block directly
+TEST(TestDecodingProbabilitySimulator, systematic)
+{
+    typedef kodo::decoding_probability_simulator<
+        kodo::full_rlnc_encoder<fifi::binary8>,
+        kodo::full_rlnc_decoder<fifi::binary8> > simulator_type;
+
+    uint32_t symbols = rand_symbols();
+
+    simulator_type simulator(symbols);
+    simulator.set_threads(3);
+    simulator.set_seed(rand());
+
+    auto result = simulator.run(50);
+
+    EXPECT_EQ(50U, result.m_trials);
+    EXPECT_EQ(50U * symbols, result.m_transmitted);
+    EXPECT_DOUBLE_EQ(symbols, result.average_used());
+    EXPECT_DOUBLE_EQ(1.0, result.decoding_probability(symbols));
+    EXPECT_DOUBLE_EQ(0.0, result.decoding_probability(symbols - 1));
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_EQ(50U, result.m_rank_used[i]);
+    }
+}
+
+/// Compares the binary code with the probability of a random binary
+/// matrix having full rank
+TEST(TestDecodingProbabilitySimulator, binary)
+{
+    typedef kodo::decoding_probability_simulator<
+        kodo::full_rlnc_encoder<fifi::binary>,
+        kodo::full_rlnc_decoder<fifi::binary> > simulator_type;
+
+    uint32_t symbols = 32;
+
+    simulator_type simulator(symbols);
+    simulator.set_systematic(false);
+    simulator.set_erasure(0.25);
+    simulator.set_threads(4);
+    simulator.set_seed(rand());
+
+    auto result = simulator.run(4000);
+
+    EXPECT_EQ(4000U, result.m_trials);
+    EXPECT_GT(result.m_transmitted, 4000U * symbols);
+
+    // The probability is about 0.289 with k received symbols and
+    // 0.578 with one additional symbol
+    EXPECT_NEAR(0.289, result.decoding_probability(symbols), 0.05);
+    EXPECT_NEAR(0.578, result.decoding_probability(symbols + 1), 0.05);
+
+    // On average about 1.6 extra symbols are needed
+    EXPECT_NEAR(symbols + 1.6, result.average_used(), 0.2);
+}
+
+/// The result only depends on the seed and the number of threads
+TEST(TestDecodingProbabilitySimulator, reproducible)
+{
+    typedef kodo::decoding_probability_simulator<
+        kodo::full_rlnc_encoder<fifi::binary>,
+        kodo::full_rlnc_decoder<fifi::binary> > simulator_type;
+
+    simulator_type simulator(rand_symbols());
+    simulator.set_erasure(0.5);
+    simulator.set_threads(2);
+    simulator.set_seed(rand());
+
+    auto first = simulator.run(101);
+    auto second = simulator.run(101);
+
+    EXPECT_EQ(first.m_trials, second.m_trials);
+    EXPECT_EQ(first.m_transmitted, second.m_transmitted);
+    EXPECT_EQ(first.m_used, second.m_used);
+    EXPECT_EQ(first.m_rank_used, second.m_rank_used);
+}
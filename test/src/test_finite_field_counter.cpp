@@ -14,8 +14,10 @@
 
 #include <kodo/operations_counter.hpp>
 #include <kodo/finite_field_counter.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
 
 #include "operations_counter_helper.hpp"
+#include "basic_api_test_helper.hpp"
 
 namespace kodo
 {
@@ -36,7 +38,30 @@ namespace kodo
 
         /// Dummy factory
         struct factory
-        {};
+        {
+            factory()
+                : m_symbols(0),
+                  m_symbol_size(0)
+            { }
+
+            /// @copydoc layer::factory::symbols() const
+            uint32_t symbols() const
+            {
+                return m_symbols;
+            }
+
+            /// @copydoc layer::factory::symbol_size() const
+            uint32_t symbol_size() const
+            {
+                return m_symbol_size;
+            }
+
+            /// The number of symbols returned
+            uint32_t m_symbols;
+
+            /// The symbol size returned
+            uint32_t m_symbol_size;
+        };
 
     public:
 
@@ -116,6 +141,71 @@ namespace kodo
                dummy_finite_field<Field> >
     { };
 
+    /// A full_rlnc_decoder counting its finite field operations
+    template<class Field>
+    class counted_full_rlnc_decoder :
+        public // Payload API
+               payload_recoder<recoding_stack,
+               payload_decoder<
+               // Codec Header API
+               systematic_decoder<
+               symbol_id_decoder<
+               // Symbol ID API
+               plain_symbol_id_reader<
+               // Codec API
+               aligned_coefficients_decoder<
+               forward_linear_block_decoder<
+               // Coefficient Storage API
+               coefficient_storage<
+               coefficient_info<
+               // Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_counter<
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               counted_full_rlnc_decoder<Field>
+                   > > > > > > > > > > > > > > > >
+    { };
+
+    /// A full_rlnc_decoder_delayed counting its finite field operations
+    template<class Field>
+    class counted_full_rlnc_decoder_delayed :
+        public // Payload API
+               payload_recoder<recoding_stack,
+               payload_decoder<
+               // Codec Header API
+               systematic_decoder<
+               symbol_id_decoder<
+               // Symbol ID API
+               plain_symbol_id_reader<
+               // Codec API
+               aligned_coefficients_decoder<
+               linear_block_decoder_delayed<
+               forward_linear_block_decoder<
+               // Coefficient Storage API
+               coefficient_storage<
+               coefficient_info<
+               // Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_counter<
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               counted_full_rlnc_decoder_delayed<Field>
+                   > > > > > > > > > > > > > > > > >
+    { };
+
 }
 
 /// Run the tests for the finite field counter
@@ -184,5 +274,253 @@ TEST(TestFiniteFieldCounter, invoke_counters)
     test_values(counter, 0U);
 }
 
+/// Checks that the bytes are split between coefficient and payload work
+/// and attributed to the outermost phase
+TEST(TestFiniteFieldCounter, count_bytes)
+{
+    typedef kodo::counter_test_stack<fifi::binary16> stack_type;
+    typedef stack_type::value_type value_type;
+
+    stack_type stack;
+
+    // A symbol of 100 bytes is 50 binary16 elements and a coefficient
+    // vector of 4 symbols is 4 elements
+    stack_type::factory f;
+    f.m_symbols = 4;
+    f.m_symbol_size = 100;
+    stack.initialize(f);
+
+    value_type *dummy_ptr = 0;
+    value_type dummy_coefficient = 0;
+
+    // Payload work outside a phase
+    stack.multiply_add(dummy_ptr, dummy_ptr, dummy_coefficient, 50);
+
+    // Work on a tile of a symbol is also payload work
+    stack.multiply_add(dummy_ptr, dummy_ptr, dummy_coefficient, 20);
+
+    // Coefficient and payload work in a phase
+    stack.push_operations_phase(kodo::operations_phase::forward_substitute);
+    stack.push_operations_region(kodo::operations_region::coefficients);
+    stack.subtract(dummy_ptr, dummy_ptr, 4);
+    stack.pop_operations_region();
+    stack.subtract(dummy_ptr, dummy_ptr, 50);
+    stack.pop_operations_phase();
+
+    // Nested phases are attributed to the outermost phase
+    stack.push_operations_phase(kodo::operations_phase::recode);
+    stack.push_operations_phase(kodo::operations_phase::encode);
+    stack.push_operations_region(kodo::operations_region::coefficients);
+    stack.multiply(dummy_ptr, dummy_coefficient, 4);
+    stack.pop_operations_region();
+    stack.add(dummy_ptr, dummy_ptr, 50);
+    stack.pop_operations_phase();
+    stack.multiply_subtract(dummy_ptr, dummy_ptr, dummy_coefficient, 50);
+    stack.pop_operations_phase();
+
+    auto counter = stack.get_operations_counter();
+
+    EXPECT_EQ(2U, counter.m_multiply_add);
+    EXPECT_EQ(2U, counter.m_subtract);
+
+    EXPECT_EQ(140U, counter.m_payload_bytes.m_multiply_add);
+    EXPECT_EQ(100U, counter.m_payload_bytes.m_subtract);
+    EXPECT_EQ(100U, counter.m_payload_bytes.m_add);
+    EXPECT_EQ(100U, counter.m_payload_bytes.m_multiply_subtract);
+    EXPECT_EQ(0U, counter.m_payload_bytes.m_multiply);
+
+    EXPECT_EQ(8U, counter.m_coefficient_bytes.m_subtract);
+    EXPECT_EQ(8U, counter.m_coefficient_bytes.m_multiply);
+    EXPECT_EQ(16U, counter.m_coefficient_bytes.total());
+
+    EXPECT_EQ(456U, counter.total_bytes());
+
+    EXPECT_EQ(140U, counter.payload_bytes(kodo::operations_phase::other));
+    EXPECT_EQ(100U, counter.payload_bytes(
+                  kodo::operations_phase::forward_substitute));
+    EXPECT_EQ(8U, counter.coefficient_bytes(
+                  kodo::operations_phase::forward_substitute));
+    EXPECT_EQ(200U, counter.payload_bytes(kodo::operations_phase::recode));
+    EXPECT_EQ(8U, counter.coefficient_bytes(kodo::operations_phase::recode));
+    EXPECT_EQ(0U, counter.payload_bytes(kodo::operations_phase::encode));
+
+    // Initializing resets the counter
+    stack.initialize(f);
+
+    counter = stack.get_operations_counter();
+    test_values(counter, 0U);
+    test_byte_values(counter, 0U);
+}
+
+/// Checks that the kind of work follows the marked regions and not the
+/// length of the operations
+TEST(TestFiniteFieldCounter, count_regions)
+{
+    typedef kodo::counter_test_stack<fifi::binary8> stack_type;
+    typedef stack_type::value_type value_type;
+
+    stack_type stack;
+
+    // The symbols are shorter than the coefficient vectors
+    stack_type::factory f;
+    f.m_symbols = 64;
+    f.m_symbol_size = 16;
+    stack.initialize(f);
+
+    value_type *dummy_ptr = 0;
+    value_type dummy_coefficient = 0;
+
+    stack.subtract(dummy_ptr, dummy_ptr, 16);
+
+    stack.push_operations_region(kodo::operations_region::coefficients);
+    stack.subtract(dummy_ptr, dummy_ptr, 64);
+
+    // The innermost region applies
+    stack.push_operations_region(kodo::operations_region::payload);
+    stack.multiply(dummy_ptr, dummy_coefficient, 64);
+    stack.pop_operations_region();
+
+    stack.multiply(dummy_ptr, dummy_coefficient, 16);
+    stack.pop_operations_region();
+
+    stack.add(dummy_ptr, dummy_ptr, 64);
+
+    auto counter = stack.get_operations_counter();
+
+    EXPECT_EQ(16U, counter.m_payload_bytes.m_subtract);
+    EXPECT_EQ(64U, counter.m_coefficient_bytes.m_subtract);
+    EXPECT_EQ(64U, counter.m_payload_bytes.m_multiply);
+    EXPECT_EQ(16U, counter.m_coefficient_bytes.m_multiply);
+    EXPECT_EQ(64U, counter.m_payload_bytes.m_add);
+}
+
+/// Decodes with a real decoder and checks the split of the work
+/// @param symbols The number of symbols
+/// @param symbol_size The size of a symbol, at most the size of a
+///        coefficient vector
+template<class Field>
+void test_count_decoder_regions(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::counted_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    ASSERT_LE(decoder->symbol_size(), decoder->coefficients_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(std::equal(data_out.begin(), data_out.end(),
+                           data_in.begin()));
+
+    auto counter = decoder->get_operations_counter();
+
+    uint64_t symbol_bytes = decoder->symbol_size();
+    uint64_t coefficient_bytes = decoder->coefficients_size();
+
+    EXPECT_GT(counter.m_coefficient_bytes.total(), 0U);
+    EXPECT_GT(counter.m_payload_bytes.total(), 0U);
+
+    // Every operation works on a whole symbol or a whole vector
+    EXPECT_EQ(0U, counter.m_payload_bytes.total() % symbol_bytes);
+    EXPECT_EQ(0U, counter.m_coefficient_bytes.total() % coefficient_bytes);
+
+    // The backward substitution and the normalization update a symbol
+    // together with its coefficients
+    kodo::operations_phase phases[] =
+        { kodo::operations_phase::normalize,
+          kodo::operations_phase::backward_substitute };
+
+    for(auto phase : phases)
+    {
+        EXPECT_EQ(counter.payload_bytes(phase) / symbol_bytes,
+                  counter.coefficient_bytes(phase) / coefficient_bytes);
+    }
+}
+
+TEST(TestFiniteFieldCounter, count_decoder_regions)
+{
+    // The symbols are as long as the coefficient vectors
+    test_count_decoder_regions<fifi::binary8>(32, 32);
+    test_count_decoder_regions<fifi::binary16>(16, 32);
+
+    // The symbols are shorter than the coefficient vectors
+    test_count_decoder_regions<fifi::binary8>(64, 16);
+    test_count_decoder_regions<fifi::binary>(256, 8);
+}
+
+/// The delayed decoder solves its tiles on the calling thread when the
+/// operations are counted, so the counts do not depend on the number of
+/// substitute threads
+template<class Field>
+void test_count_delayed_threads(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::counted_full_rlnc_decoder_delayed<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory serial_factory(symbols, symbol_size);
+    typename decoder_type::factory threaded_factory(symbols, symbol_size);
+
+    threaded_factory.set_substitute_threads(4);
+
+    auto encoder = encoder_factory.build();
+    auto serial = serial_factory.build();
+    auto threaded = threaded_factory.build();
+
+    EXPECT_FALSE(threaded->is_concurrent_safe());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> copy(encoder->payload_size());
 
+    while(!threaded->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        // The decoders modify the payload
+        copy = payload;
+
+        serial->decode(&payload[0]);
+        threaded->decode(&copy[0]);
+    }
+
+    ASSERT_TRUE(serial->is_complete());
+
+    std::vector<uint8_t> data_out(threaded->block_size());
+    threaded->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
 
+    auto s = serial->get_operations_counter();
+    auto t = threaded->get_operations_counter();
+
+    EXPECT_EQ(s.m_multiply_subtract, t.m_multiply_subtract);
+    EXPECT_EQ(s.m_subtract, t.m_subtract);
+    EXPECT_EQ(s.m_payload_bytes.total(), t.m_payload_bytes.total());
+    EXPECT_EQ(s.payload_bytes(kodo::operations_phase::backward_substitute),
+              t.payload_bytes(kodo::operations_phase::backward_substitute));
+}
+
+TEST(TestFiniteFieldCounter, count_delayed_threads)
+{
+    test_count_delayed_threads<fifi::binary>(64, 20000);
+    test_count_delayed_threads<fifi::binary8>(64, 20000);
+}
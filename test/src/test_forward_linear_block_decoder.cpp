@@ -7,12 +7,18 @@
 ///       kodo::forward_linear_block_decoder
 
 #include <cstdint>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <kodo/forward_linear_block_decoder.hpp>
 #include <kodo/rlnc/full_vector_codes.hpp>
 
 #include <kodo/debug_linear_block_decoder.hpp>
+#include <kodo/debug_coefficient_storage.hpp>
 
 #include "basic_api_test_helper.hpp"
 
@@ -69,6 +75,74 @@ namespace kodo
                      > > > > > > > > > > >
     { };
 
+    template<class Field>
+    class test_forward_debug_stack
+        : public // Payload API
+                 // Codec Header API
+                 // Symbol ID API
+                 // Codec API
+                 debug_coefficient_storage<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 test_forward_debug_stack<Field>
+                     > > > > > > > > > >
+    { };
+
+    /// Gives the tests access to the column index of the linear block
+    /// decoder
+    template<class SuperCoder>
+    class column_index_access : public SuperCoder
+    {
+    public:
+
+        /// @param column The column
+        /// @return The coded symbols listed for the column
+        const std::vector<uint32_t>& column_rows(uint32_t column) const
+        {
+            return SuperCoder::m_column_rows[column];
+        }
+
+        /// @return True if the column index matches the coded symbols
+        bool column_index_valid() const
+        {
+            return SuperCoder::m_column_index_valid;
+        }
+    };
+
+    template<class Field>
+    class test_column_index_stack
+        : public // Codec API
+                 column_index_access<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 test_column_index_stack<Field>
+                     > > > > > > > > > >
+    { };
+
 }
 
 template<template <class> class Stack>
@@ -225,3 +299,343 @@ TEST(TestLinearBlockDecoder, test_decoder_delayed)
 
 
 
+/// Checks that is_innovative() predicts whether decoding a symbol
+/// increases the rank, and that the data of a non-innovative symbol is
+/// left untouched by the decoder
+template<template <class> class Stack, class Field>
+void test_is_innovative(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Stack<Field>::factory f(symbols, symbol_size);
+    auto d = f.build();
+
+    uint32_t non_innovative = 0;
+
+    while(non_innovative < symbols)
+    {
+        std::vector<uint8_t> coefficients =
+            random_vector(d->coefficients_size());
+
+        // Sparse vectors are often linearly dependent
+        if(rand() % 2)
+        {
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(rand() % 4)
+                    fifi::set_value<Field>(
+                        reinterpret_cast<typename Field::value_type*>(
+                            &coefficients[0]), i, 0U);
+            }
+        }
+
+        std::vector<uint8_t> symbol = random_vector(d->symbol_size());
+
+        std::vector<uint8_t> coefficients_in = coefficients;
+        std::vector<uint8_t> symbol_in = symbol;
+
+        bool innovative = d->is_innovative(&coefficients[0]);
+        EXPECT_TRUE(coefficients == coefficients_in);
+
+        uint32_t rank = d->rank();
+        d->decode_symbol(&symbol[0], &coefficients[0]);
+
+        // An innovative symbol is decoded in the storage of its pivot,
+        // so the received buffer is never modified
+        EXPECT_TRUE(symbol == symbol_in);
+
+        if(innovative)
+        {
+            EXPECT_EQ(rank + 1, d->rank());
+        }
+        else
+        {
+            EXPECT_EQ(rank, d->rank());
+            ++non_innovative;
+        }
+    }
+}
+
+TEST(TestLinearBlockDecoder, is_innovative)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_is_innovative<kodo::test_forward_stack, fifi::binary>(
+        symbols, symbol_size);
+    test_is_innovative<kodo::test_forward_stack, fifi::binary8>(
+        symbols, symbol_size);
+    test_is_innovative<kodo::test_forward_stack, fifi::binary16>(
+        symbols, symbol_size);
+
+    test_is_innovative<kodo::test_forward_delayed_stack, fifi::binary>(
+        symbols, symbol_size);
+    test_is_innovative<kodo::test_forward_delayed_stack, fifi::binary8>(
+        symbols, symbol_size);
+    test_is_innovative<kodo::test_forward_delayed_stack, fifi::binary16>(
+        symbols, symbol_size);
+}
+
+/// Decodes a mix of coded and uncoded symbols and checks that the
+/// coefficients of every pivot read back as a unit vector once the
+/// decoder is complete, also for uncoded symbols whose coefficients are
+/// not stored while decoding. Also checks the pivot reported by
+/// last_pivot().
+template<template <class> class Stack, class Field>
+void test_unit_coefficients(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef typename Field::value_type value_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename Stack<Field>::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+
+    // Every symbol increasing the rank reports a new pivot
+    std::vector<bool> pivots(symbols, false);
+
+    while(!decoder->is_complete())
+    {
+        uint32_t rank = decoder->rank();
+
+        if(rand() % 2)
+        {
+            uint32_t index = rand() % symbols;
+            encoder->encode_symbol(&symbol[0], index);
+            decoder->decode_symbol(&symbol[0], index);
+        }
+        else
+        {
+            encoder->generate(&coefficients[0]);
+            encoder->encode_symbol(&symbol[0], &coefficients[0]);
+            decoder->decode_symbol(&symbol[0], &coefficients[0]);
+        }
+
+        if(decoder->rank() > rank)
+        {
+            uint32_t pivot = decoder->last_pivot();
+
+            ASSERT_LT(pivot, symbols);
+            EXPECT_TRUE(decoder->symbol_pivot(pivot));
+            EXPECT_FALSE(pivots[pivot]);
+
+            pivots[pivot] = true;
+        }
+    }
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        const value_type *c = decoder->coefficients_value(i);
+
+        for(uint32_t j = 0; j < symbols; ++j)
+        {
+            EXPECT_EQ(i == j ? 1U : 0U, fifi::get_value<Field>(c, j));
+        }
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestLinearBlockDecoder, unit_coefficients)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_unit_coefficients<kodo::test_forward_stack, fifi::binary>(
+        symbols, symbol_size);
+    test_unit_coefficients<kodo::test_forward_stack, fifi::binary8>(
+        symbols, symbol_size);
+    test_unit_coefficients<kodo::test_forward_stack, fifi::binary16>(
+        symbols, symbol_size);
+
+    test_unit_coefficients<kodo::test_forward_delayed_stack, fifi::binary>(
+        symbols, symbol_size);
+    test_unit_coefficients<kodo::test_forward_delayed_stack, fifi::binary8>(
+        symbols, symbol_size);
+    test_unit_coefficients<kodo::test_forward_delayed_stack,
+                           fifi::binary16>(symbols, symbol_size);
+}
+
+/// Checks that the coefficients of uncoded symbols read back as unit
+/// vectors through a const reference to the decoder and through the
+/// debug_coefficient_storage printer, also when the coefficient storage
+/// still holds the coded symbols of a previous generation
+template<class Field>
+void test_const_unit_coefficients(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::test_forward_debug_stack<Field> decoder_type;
+    typedef typename Field::value_type value_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+
+    // Leave coded symbols in the coefficient storage
+    while(decoder->rank() < symbols - 1)
+    {
+        encoder->generate(&coefficients[0]);
+        encoder->encode_symbol(&symbol[0], &coefficients[0]);
+        decoder->decode_symbol(&symbol[0], &coefficients[0]);
+    }
+
+    // The pool hands out the same decoder again
+    const decoder_type *previous = decoder.get();
+    decoder.reset();
+    decoder = decoder_factory.build();
+    ASSERT_EQ(previous, decoder.get());
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        encoder->encode_symbol(&symbol[0], i);
+        decoder->decode_symbol(&symbol[0], i);
+    }
+
+    EXPECT_TRUE(decoder->is_complete());
+
+    const decoder_type &const_decoder = *decoder;
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        const value_type *c = const_decoder.coefficients_value(i);
+
+        std::stringstream expected;
+        expected << i << ":\t";
+
+        for(uint32_t j = 0; j < symbols; ++j)
+        {
+            EXPECT_EQ(i == j ? 1U : 0U, fifi::get_value<Field>(c, j));
+            expected << (i == j ? 1U : 0U) << "\t";
+        }
+
+        expected << std::endl;
+
+        std::stringstream out;
+        decoder->print_coefficients_value(out, i);
+
+        EXPECT_EQ(expected.str(), out.str());
+    }
+}
+
+TEST(TestLinearBlockDecoder, const_unit_coefficients)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_const_unit_coefficients<fifi::binary>(symbols, symbol_size);
+    test_const_unit_coefficients<fifi::binary8>(symbols, symbol_size);
+    test_const_unit_coefficients<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Checks that coded symbols leave the column index stale, and that a
+/// burst of uncoded symbols builds an index listing exactly the coded
+/// symbols with a non-zero element in each column
+template<class Field>
+void test_column_index(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::test_column_index_stack<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+
+    // Coded symbols do no index bookkeeping
+    while(decoder->rank() < symbols / 4)
+    {
+        encoder->generate(&coefficients[0]);
+        encoder->encode_symbol(&symbol[0], &coefficients[0]);
+        decoder->decode_symbol(&symbol[0], &coefficients[0]);
+
+        EXPECT_FALSE(decoder->column_index_valid());
+    }
+
+    uint32_t coded = decoder->rank();
+    uint32_t uncoded = 0;
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        if(decoder->symbol_pivot(i))
+            continue;
+
+        encoder->encode_symbol(&symbol[0], i);
+        decoder->decode_symbol(&symbol[0], i);
+        ++uncoded;
+
+        // The pivots are scanned until the scans outnumber the coded
+        // symbols
+        EXPECT_EQ(uncoded > coded, decoder->column_index_valid());
+
+        if(!decoder->column_index_valid())
+            continue;
+
+        for(uint32_t j = 0; j < symbols; ++j)
+        {
+            std::vector<uint32_t> rows = decoder->column_rows(j);
+            std::sort(rows.begin(), rows.end());
+
+            std::vector<uint32_t> expected;
+
+            for(uint32_t k = 0; k < symbols; ++k)
+            {
+                if(k == j || !decoder->symbol_pivot(k) ||
+                   !decoder->symbol_coded(k))
+                {
+                    continue;
+                }
+
+                if(fifi::get_value<Field>(
+                       decoder->coefficients_value(k), j))
+                {
+                    expected.push_back(k);
+                }
+            }
+
+            EXPECT_TRUE(rows == expected);
+        }
+    }
+
+    EXPECT_TRUE(decoder->is_complete());
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+
+    // A reused decoder starts with a stale index
+    decoder->initialize(decoder_factory);
+
+    EXPECT_FALSE(decoder->column_index_valid());
+}
+
+TEST(TestLinearBlockDecoder, column_index)
+{
+    test_column_index<fifi::binary>(64, 16);
+    test_column_index<fifi::binary8>(64, 16);
+    test_column_index<fifi::binary16>(32, 16);
+}
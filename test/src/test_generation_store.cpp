@@ -0,0 +1,145 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_generation_store.cpp Unit tests for the generation_store
+///       and the encoders sharing its generations
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/generation_store.hpp>
+#include <kodo/generation_store_reader.hpp>
+#include <kodo/object_encoder.hpp>
+#include <kodo/object_decoder.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks that generations are loaded once and released with the last
+/// reference
+TEST(TestGenerationStore, load_and_release)
+{
+    kodo::generation_store store;
+
+    uint32_t loads = 0;
+    auto loader = [&loads](uint8_t *data)
+        {
+            data[0] = 42;
+            ++loads;
+        };
+
+    auto a = store.load(1, 0, 100, loader);
+    auto b = store.load(1, 0, 100, loader);
+    auto c = store.load(2, 0, 100, loader);
+
+    EXPECT_EQ(2U, loads);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(42U, (*a)[0]);
+    EXPECT_EQ(0U, (*a)[99]);
+    EXPECT_EQ(2U, store.generations());
+
+    a.reset();
+    EXPECT_TRUE((bool) store.find(1, 0));
+
+    b.reset();
+    EXPECT_FALSE((bool) store.find(1, 0));
+    EXPECT_EQ(1U, store.generations());
+
+    store.load(1, 0, 100, loader);
+    EXPECT_EQ(3U, loads);
+}
+
+/// Serves one object to several sessions and decodes every block
+template<class Field>
+void test_generation_store_reader(uint32_t max_symbols,
+                                  uint32_t max_symbol_size,
+                                  uint32_t sessions)
+{
+    typedef kodo::shared_full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::full_rlnc_decoder<Field> decoder_type;
+
+    typedef kodo::generation_store_reader<encoder_type> reader_type;
+    typedef kodo::object_encoder<reader_type, encoder_type>
+        object_encoder_type;
+    typedef kodo::object_decoder<decoder_type> object_decoder_type;
+
+    uint32_t object_size =
+        rand_nonzero(3 * max_symbols * max_symbol_size);
+
+    std::vector<uint8_t> data_in = random_vector(object_size);
+
+    auto store = boost::make_shared<kodo::generation_store>();
+
+    typename encoder_type::factory encoder_factory(
+        max_symbols, max_symbol_size);
+    typename decoder_type::factory decoder_factory(
+        max_symbols, max_symbol_size);
+
+    reader_type reader(store, 7, sak::storage(data_in));
+    object_encoder_type object_encoder(encoder_factory, reader);
+
+    for(uint32_t i = 0; i < object_encoder.encoders(); ++i)
+    {
+        std::vector<typename encoder_type::pointer> encoders;
+
+        for(uint32_t s = 0; s < sessions; ++s)
+        {
+            encoders.push_back(object_encoder.build(i));
+        }
+
+        // Every session uses the same copy of the block
+        EXPECT_EQ(1U, store->generations());
+
+        for(uint32_t s = 1; s < sessions; ++s)
+        {
+            EXPECT_EQ(encoders[0]->symbol(0), encoders[s]->symbol(0));
+        }
+
+        for(uint32_t s = 0; s < sessions; ++s)
+        {
+            object_decoder_type object_decoder(decoder_factory,
+                                               object_size);
+
+            auto encoder = encoders[s];
+            auto decoder = object_decoder.build(i);
+
+            std::vector<uint8_t> payload(encoder->payload_size());
+
+            while(!decoder->is_complete())
+            {
+                encoder->encode(&payload[0]);
+
+                if(rand() % 2)
+                    continue;
+
+                decoder->decode(&payload[0]);
+            }
+
+            std::vector<uint8_t> data_out(decoder->block_size());
+            decoder->copy_symbols(sak::storage(data_out));
+
+            const uint8_t *block = &(*encoder->generation())[0];
+            EXPECT_TRUE(std::equal(block, block + decoder->bytes_used(),
+                                   data_out.begin()));
+        }
+    }
+
+    // Idle encoders in the pool still reference their generation
+    encoder_factory.pool().free_unused();
+    EXPECT_EQ(0U, store->generations());
+}
+
+TEST(TestGenerationStore, object_encoder)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_generation_store_reader<fifi::binary>(symbols, symbol_size, 3);
+    test_generation_store_reader<fifi::binary8>(symbols, symbol_size, 3);
+    test_generation_store_reader<fifi::binary16>(symbols, symbol_size, 2);
+}
@@ -0,0 +1,170 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_inactivation_decoder.cpp Unit tests for the
+///       inactivation_decoder
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/sparse_uniform_generator.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+    // Encoder producing sparse coding vectors
+    template<class Field>
+    class sparse_test_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               sparse_uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               sparse_test_encoder<Field>
+                   > > > > > > > > > > > > > > > >
+    { };
+}
+
+/// Decodes a block of sparse symbols where some symbols are lost
+template<class Encoder, class Decoder>
+void test_inactivation(uint32_t symbols, uint32_t symbol_size,
+                       double density, bool systematic)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    encoder->set_density(density);
+
+    if(!systematic)
+        encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Guard against a decoder which never completes
+    uint32_t max_payloads = 10 * symbols + 100;
+    uint32_t payloads = 0;
+
+    while(!decoder->is_complete() && payloads < max_payloads)
+    {
+        EXPECT_EQ(0U, decoder->rank());
+
+        encoder->encode(&payload[0]);
+        ++payloads;
+
+        if(rand() % 3 == 0)
+            continue;
+
+        decoder->decode(&payload[0]);
+    }
+
+    ASSERT_TRUE(decoder->is_complete());
+    EXPECT_EQ(symbols, decoder->rank());
+    EXPECT_GE(decoder->buffered_symbols(), symbols);
+    EXPECT_LE(decoder->inactivated_symbols(), symbols);
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+template<class Field>
+void test_inactivation(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::sparse_test_encoder<Field> encoder_type;
+    typedef kodo::inactivation_full_rlnc_decoder<Field> decoder_type;
+
+    test_inactivation<encoder_type, decoder_type>(
+        symbols, symbol_size, 0.5, true);
+
+    test_inactivation<encoder_type, decoder_type>(
+        symbols, symbol_size, 0.5, false);
+
+    if(symbols > 2)
+    {
+        test_inactivation<encoder_type, decoder_type>(
+            symbols, symbol_size, 2.0 / symbols, false);
+    }
+}
+
+TEST(TestInactivationDecoder, decode)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_inactivation<fifi::binary>(symbols, symbol_size);
+    test_inactivation<fifi::binary8>(symbols, symbol_size);
+    test_inactivation<fifi::binary16>(symbols, symbol_size);
+
+    test_inactivation<fifi::binary>(1, 16);
+    test_inactivation<fifi::binary8>(2, 16);
+}
+
+/// Checks that peeling resolves most symbols of a large sparse
+/// generation, such that only a small dense core remains
+TEST(TestInactivationDecoder, large_generation)
+{
+    typedef kodo::sparse_test_encoder<fifi::binary8> encoder_type;
+    typedef kodo::inactivation_full_rlnc_decoder<fifi::binary8>
+        decoder_type;
+
+    uint32_t symbols = 1024;
+    uint32_t symbol_size = 16;
+
+    test_inactivation<encoder_type, decoder_type>(
+        symbols, symbol_size, 8.0 / symbols, false);
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    encoder->set_density(8.0 / symbols);
+    encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    EXPECT_LT(decoder->inactivated_symbols(), symbols / 2);
+}
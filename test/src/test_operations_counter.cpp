@@ -22,6 +22,7 @@ TEST(TestOperationsCounter, test_operations_counter)
     {
         kodo::operations_counter counter;
         test_values(counter, 0U);
+        test_byte_values(counter, 0U);
     }
 
     {
@@ -34,16 +35,34 @@ TEST(TestOperationsCounter, test_operations_counter)
         a = a + b;
 
         test_values(a, 3U);
+        test_byte_values(a, 3U);
 
         EXPECT_TRUE(a >= b);
 
         a = a - b;
 
         test_values(a, 1U);
+        test_byte_values(a, 1U);
 
         EXPECT_FALSE(a >= b);
     }
 
+    {
+        // The counters are 64 bit and must not overflow on long runs
+        kodo::operations_counter a;
+        set_values(a, 0xFFFFFFFFULL);
+
+        kodo::operations_counter b;
+        set_values(b, 1U);
+
+        a = a + b;
+
+        test_values(a, 0x100000000ULL);
+        test_byte_values(a, 0x100000000ULL);
+
+        EXPECT_EQ(2 * 5 * 0x100000000ULL, a.total_bytes());
+    }
+
 }
 
 
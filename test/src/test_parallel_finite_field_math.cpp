@@ -0,0 +1,215 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_parallel_finite_field_math.cpp Unit tests for the
+///       parallel_finite_field_math layer and the thread_pool
+
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/thread_pool.hpp>
+#include <kodo/finite_field_counter.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+    /// A parallel_full_rlnc_decoder counting the operations of the
+    /// stripes below the parallel layer
+    template<class Field>
+    class counted_parallel_full_rlnc_decoder
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 parallel_finite_field_math<
+                 finite_field_counter<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 counted_parallel_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+}
+
+/// Checks that every task is executed exactly once, also when several
+/// threads submit jobs concurrently
+TEST(TestParallelFiniteFieldMath, thread_pool)
+{
+    kodo::thread_pool pool(3);
+    EXPECT_EQ(3U, pool.workers());
+
+    uint32_t tasks = 1000;
+
+    auto submit = [&pool, tasks]()
+    {
+        std::vector<std::atomic<uint32_t> > counts(tasks);
+        for(auto& c : counts)
+            c = 0;
+
+        pool.run(tasks, [&counts](uint32_t index) { ++counts[index]; });
+
+        for(auto& c : counts)
+            EXPECT_EQ(1U, c.load());
+    };
+
+    submit();
+
+    std::vector<std::thread> submitters;
+    for(uint32_t i = 0; i < 4; ++i)
+        submitters.push_back(std::thread(submit));
+
+    for(auto& t : submitters)
+        t.join();
+
+    // A pool without workers runs everything on the calling thread
+    kodo::thread_pool serial(0);
+
+    uint32_t count = 0;
+    serial.run(10, [&count](uint32_t) { ++count; });
+    EXPECT_EQ(10U, count);
+}
+
+/// Decodes a block with the parallel decoder using a low threshold such
+/// that the symbol operations are split into stripes
+template<class Field>
+void test_parallel_decoder(uint32_t threads, uint32_t symbols,
+                           uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::parallel_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    decoder_factory.set_threads(threads);
+    decoder_factory.set_parallel_threshold(64);
+
+    EXPECT_EQ(threads, decoder_factory.threads());
+    EXPECT_EQ(64U, decoder_factory.parallel_threshold());
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(threads, decoder->threads());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        // Lose half of the systematic packets to mix coded and
+        // uncoded symbols
+        if(rand() % 2)
+            continue;
+
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestParallelFiniteFieldMath, decode)
+{
+    uint32_t symbols = rand_symbols(64);
+    uint32_t symbol_size = rand_symbol_size(4000);
+
+    for(uint32_t threads = 1; threads <= 4; ++threads)
+    {
+        test_parallel_decoder<fifi::binary>(threads, symbols, symbol_size);
+        test_parallel_decoder<fifi::binary8>(threads, symbols, symbol_size);
+        test_parallel_decoder<fifi::binary16>(
+            threads, symbols, symbol_size);
+    }
+}
+
+/// A finite_field_counter below the parallel layer is not safe for
+/// concurrent use, so the operations stay on the calling thread and are
+/// counted once, as with a single thread
+template<class Field>
+void test_parallel_counter(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::counted_parallel_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory serial_factory(symbols, symbol_size);
+    typename decoder_type::factory threaded_factory(symbols, symbol_size);
+
+    serial_factory.set_threads(1);
+    threaded_factory.set_threads(4);
+    threaded_factory.set_parallel_threshold(64);
+
+    auto encoder = encoder_factory.build();
+    auto serial = serial_factory.build();
+    auto threaded = threaded_factory.build();
+
+    EXPECT_FALSE(threaded->is_concurrent_safe());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> copy(encoder->payload_size());
+
+    while(!threaded->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        // The decoders modify the payload
+        copy = payload;
+
+        serial->decode(&payload[0]);
+        threaded->decode(&copy[0]);
+    }
+
+    std::vector<uint8_t> data_out(threaded->block_size(), '\0');
+    threaded->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    auto s = serial->get_operations_counter();
+    auto t = threaded->get_operations_counter();
+
+    EXPECT_EQ(s.m_multiply, t.m_multiply);
+    EXPECT_EQ(s.m_multiply_subtract, t.m_multiply_subtract);
+    EXPECT_EQ(s.m_subtract, t.m_subtract);
+    EXPECT_EQ(s.m_payload_bytes.total(), t.m_payload_bytes.total());
+}
+
+TEST(TestParallelFiniteFieldMath, counter)
+{
+    test_parallel_counter<fifi::binary>(32, 4000);
+    test_parallel_counter<fifi::binary8>(32, 4000);
+}
@@ -0,0 +1,188 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_region_kernels.cpp Unit tests for the region kernels
+///       selected by the finite_field_math layer
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fifi/default_field.hpp>
+#include <fifi/field_types.hpp>
+
+#include <kodo/region_kernels.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Compares every region operation of a kernel against the Fifi
+/// implementation for random data and a range of lengths, so that both
+/// the vector loops and the tail loops are exercised. The lengths span
+/// the table threshold of the binary16 kernels.
+template<class Field>
+void test_region_kernel(kodo::region_kernel kernel)
+{
+    typedef typename Field::value_type value_type;
+    typedef typename fifi::default_field<Field>::type field_impl;
+
+    field_impl field;
+    kodo::region_kernels<Field> kernels(field, kernel);
+
+    EXPECT_EQ(kernel, kernels.kernel());
+
+    for(uint32_t length = 1; length < 700; length += 13)
+    {
+        std::vector<value_type> src(length);
+        std::vector<value_type> dest(length);
+        std::vector<value_type> temp(length);
+
+        for(uint32_t i = 0; i < length; ++i)
+        {
+            src[i] = value_type(rand());
+            dest[i] = value_type(rand());
+        }
+
+        value_type coefficient = value_type(rand()) & Field::max_value;
+
+        std::vector<value_type> expected(dest);
+        std::vector<value_type> result(dest);
+
+        fifi::multiply_add(field, coefficient, &expected[0], &src[0],
+                           &temp[0], length);
+
+        if(kernels.is_accelerated())
+        {
+            kernels.multiply_add(field, &result[0], &src[0],
+                                 coefficient, length);
+
+            EXPECT_TRUE(expected == result);
+        }
+
+        expected = dest;
+        result = dest;
+
+        fifi::multiply_constant(field, coefficient, &expected[0], length);
+
+        if(kernels.is_accelerated())
+        {
+            kernels.multiply(field, &result[0], coefficient, length);
+
+            EXPECT_TRUE(expected == result);
+        }
+
+        expected = dest;
+        result = dest;
+
+        fifi::add(field, &expected[0], &src[0], length);
+
+        if(kernels.is_accelerated())
+        {
+            kernels.add(&result[0], &src[0], length);
+
+            EXPECT_TRUE(expected == result);
+        }
+    }
+}
+
+/// Runs the kernel tests for every kernel supported on the current CPU
+template<class Field>
+void test_region_kernels()
+{
+    kodo::region_kernel kernels[] =
+        {
+            kodo::region_kernel::scalar,
+            kodo::region_kernel::ssse3,
+            kodo::region_kernel::avx2,
+            kodo::region_kernel::avx512,
+            kodo::region_kernel::gfni
+        };
+
+    for(auto kernel : kernels)
+    {
+        if(kodo::region_kernels<Field>::is_supported(kernel))
+        {
+            SCOPED_TRACE(kodo::region_kernel_name(kernel));
+            test_region_kernel<Field>(kernel);
+        }
+    }
+}
+
+TEST(TestRegionKernels, compare_with_fifi)
+{
+    test_region_kernels<fifi::binary>();
+    test_region_kernels<fifi::binary8>();
+    test_region_kernels<fifi::binary16>();
+    test_region_kernels<fifi::prime2325>();
+}
+
+/// Checks that the kernel selected in the factory is used by the coders
+/// and that a stack decodes correctly with every supported kernel
+template<class Field>
+void test_select_region_kernel(kodo::region_kernel kernel)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::full_rlnc_decoder<Field> decoder_type;
+
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    EXPECT_EQ(encoder_factory.selected_region_kernel(),
+              kodo::region_kernels<Field>::best_kernel());
+
+    if(!encoder_factory.is_region_kernel_supported(kernel))
+        return;
+
+    encoder_factory.set_region_kernel(kernel);
+    decoder_factory.set_region_kernel(kernel);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(kernel, encoder->selected_region_kernel());
+    EXPECT_EQ(kernel, decoder->selected_region_kernel());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+    kodo::set_systematic_off(encoder);
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRegionKernels, select_region_kernel)
+{
+    kodo::region_kernel kernels[] =
+        {
+            kodo::region_kernel::scalar,
+            kodo::region_kernel::ssse3,
+            kodo::region_kernel::avx2,
+            kodo::region_kernel::avx512,
+            kodo::region_kernel::gfni
+        };
+
+    for(auto kernel : kernels)
+    {
+        SCOPED_TRACE(kodo::region_kernel_name(kernel));
+
+        test_select_region_kernel<fifi::binary>(kernel);
+        test_select_region_kernel<fifi::binary8>(kernel);
+        test_select_region_kernel<fifi::binary16>(kernel);
+    }
+}
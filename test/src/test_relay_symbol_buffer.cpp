@@ -0,0 +1,185 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_relay_symbol_buffer.cpp Unit tests for the
+///       relay_symbol_buffer and innovative_symbol_filter layers
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Passes the symbols of an encoder through a relay to a decoder. The
+/// relay only buffers the received symbols and recodes from them.
+/// @param lossy If true the relay will lose half of the symbols and
+///        receive every other symbol twice
+template<class Relay, class Field>
+void test_relay(uint32_t symbols, uint32_t symbol_size, bool lossy)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename Relay::factory relay_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto relay = relay_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(encoder->payload_size(), relay->payload_size());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> duplicate(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Recoding from an empty relay yields a zero symbol
+    relay->recode(&payload[0]);
+    decoder->decode(&payload[0]);
+    EXPECT_EQ(0U, decoder->rank());
+
+    uint32_t received = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        if(lossy && (rand() % 2))
+        {
+            continue;
+        }
+
+        ++received;
+
+        if(lossy && (received % 2))
+        {
+            duplicate = payload;
+
+            uint32_t rank = relay->rank();
+            relay->decode(&duplicate[0]);
+
+            duplicate = payload;
+            relay->decode(&duplicate[0]);
+
+            // The second copy may never occupy a slot
+            EXPECT_TRUE(relay->rank() <= rank + 1);
+        }
+        else
+        {
+            relay->decode(&payload[0]);
+        }
+
+        EXPECT_TRUE(relay->rank() <= received);
+
+        relay->recode(&payload[0]);
+        decoder->decode(&payload[0]);
+
+        EXPECT_TRUE(decoder->rank() <= relay->rank());
+
+        // Guard against a relay which never reaches full rank
+        ASSERT_TRUE(received < 20 * symbols + 100);
+    }
+
+    EXPECT_TRUE(relay->is_complete());
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+/// Checks that the filter only lets innovative symbols through and that
+/// it works on the coefficient vectors without modifying them
+template<class Field>
+void test_innovative_filter(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::filtered_full_rlnc_relay<Field> relay_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename relay_type::factory relay_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto relay = relay_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+
+    while(!relay->is_complete())
+    {
+        encoder->generate(&coefficients[0]);
+        encoder->encode_symbol(&symbol[0], &coefficients[0]);
+
+        std::vector<uint8_t> original = coefficients;
+        uint32_t rank = relay->rank();
+
+        bool innovative = relay->is_innovative(&coefficients[0]);
+        EXPECT_TRUE(original == coefficients);
+
+        relay->decode_symbol(&symbol[0], &coefficients[0]);
+        EXPECT_TRUE(original == coefficients);
+
+        EXPECT_EQ(rank + (innovative ? 1U : 0U), relay->rank());
+
+        // The buffered slot holds the received symbol unmodified
+        if(innovative)
+        {
+            EXPECT_TRUE(std::equal(
+                symbol.begin(), symbol.end(), relay->symbol(rank)));
+
+            EXPECT_TRUE(std::equal(
+                original.begin(), original.end(),
+                relay->coefficients(rank)));
+        }
+
+        // The same vector is never innovative twice
+        EXPECT_FALSE(relay->is_innovative(&coefficients[0]));
+    }
+
+    // Uncoded symbols are not innovative for a full relay either
+    relay->decode_symbol(&symbol[0], rand_nonzero(symbols) - 1);
+    EXPECT_EQ(symbols, relay->rank());
+}
+
+TEST(TestRelaySymbolBuffer, relay)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    // Without the filter the relay relies on the systematic symbols
+    // being innovative
+    test_relay<kodo::full_rlnc_relay<fifi::binary>, fifi::binary>(
+        symbols, symbol_size, false);
+    test_relay<kodo::full_rlnc_relay<fifi::binary8>, fifi::binary8>(
+        symbols, symbol_size, false);
+    test_relay<kodo::full_rlnc_relay<fifi::binary16>, fifi::binary16>(
+        symbols, symbol_size, false);
+
+    test_relay<kodo::filtered_full_rlnc_relay<fifi::binary>,
+               fifi::binary>(symbols, symbol_size, true);
+    test_relay<kodo::filtered_full_rlnc_relay<fifi::binary8>,
+               fifi::binary8>(symbols, symbol_size, true);
+    test_relay<kodo::filtered_full_rlnc_relay<fifi::binary16>,
+               fifi::binary16>(symbols, symbol_size, true);
+}
+
+TEST(TestRelaySymbolBuffer, innovative_filter)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_innovative_filter<fifi::binary>(symbols, symbol_size);
+    test_innovative_filter<fifi::binary8>(symbols, symbol_size);
+    test_innovative_filter<fifi::binary16>(symbols, symbol_size);
+}
@@ -0,0 +1,178 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_rlnc_band_codes.cpp Unit tests for the band structured
+///       RLNC codes
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/band_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks that the generated coefficients lie within the cyclic window
+/// and that the coefficient at the offset is one
+template<class Field>
+void test_band_generator(uint32_t symbols, uint32_t band_width)
+{
+    typedef kodo::band_rlnc_encoder<Field> encoder_type;
+    typedef typename Field::value_type value_type;
+
+    typename encoder_type::factory encoder_factory(symbols, 10);
+    encoder_factory.set_band_width(band_width);
+
+    auto encoder = encoder_factory.build();
+
+    uint32_t expected_width = std::min(band_width, symbols);
+    EXPECT_EQ(expected_width, encoder->band_width());
+
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+    const value_type *c =
+        reinterpret_cast<const value_type*>(&coefficients[0]);
+
+    for(uint32_t n = 0; n < 100; ++n)
+    {
+        encoder->seed(n);
+        encoder->generate(&coefficients[0]);
+
+        // Some unit coefficient must start a cyclic window which
+        // contains all the nonzero coefficients
+        bool found = false;
+
+        for(uint32_t offset = 0; offset < symbols && !found; ++offset)
+        {
+            if(fifi::get_value<Field>(c, offset) != 1U)
+                continue;
+
+            found = true;
+
+            for(uint32_t i = expected_width; i < symbols; ++i)
+            {
+                if(fifi::get_value<Field>(c, (offset + i) % symbols))
+                    found = false;
+            }
+        }
+
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST(TestRlncBandCodes, generator)
+{
+    test_band_generator<fifi::binary>(100, 8);
+    test_band_generator<fifi::binary8>(100, 8);
+    test_band_generator<fifi::binary16>(100, 8);
+
+    test_band_generator<fifi::binary>(5, 8);
+    test_band_generator<fifi::binary8>(1, 32);
+}
+
+/// @return The number of received payloads within which a decoder should
+///         complete. Every symbol has to be covered by some window, which
+///         for narrow bands is a coupon collector problem: a symbol is
+///         missed by n windows of width w with probability about
+///         exp(-n w / k). In GF(2) only about half of the coefficients in
+///         a window are nonzero. The random offsets leave a small rank
+///         deficit on top of that.
+template<class Field>
+uint32_t max_received(uint32_t symbols, uint32_t band_width)
+{
+    double width = std::min(band_width, symbols);
+
+    if(fifi::is_binary<Field>::value)
+        width = std::ceil(width / 2);
+
+    double coverage = symbols * (std::log(double(symbols)) + 12) / width;
+
+    return uint32_t(std::max(double(symbols), coverage)) +
+        symbols / 4 + 32;
+}
+
+/// Decodes a block where half of the symbols are lost
+template<class Field>
+void test_band_decode(uint32_t symbols, uint32_t symbol_size,
+                      uint32_t band_width, bool systematic)
+{
+    typedef kodo::band_rlnc_encoder<Field> encoder_type;
+    typedef kodo::band_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    encoder_factory.set_band_width(band_width);
+    decoder_factory.set_band_width(band_width);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    if(!systematic)
+        encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Guard against a decoder which never completes, about half of the
+    // payloads are lost
+    uint32_t received_limit = max_received<Field>(symbols, band_width);
+    uint32_t max_payloads = 4 * received_limit;
+    uint32_t payloads = 0;
+    uint32_t received = 0;
+
+    while(!decoder->is_complete() && payloads < max_payloads)
+    {
+        encoder->encode(&payload[0]);
+        ++payloads;
+
+        if(rand() % 2)
+            continue;
+
+        decoder->decode(&payload[0]);
+        ++received;
+    }
+
+    ASSERT_TRUE(decoder->is_complete());
+    EXPECT_LE(received, received_limit);
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+template<class Field>
+void test_band_decode(uint32_t symbols, uint32_t symbol_size)
+{
+    test_band_decode<Field>(symbols, symbol_size, 1, true);
+    test_band_decode<Field>(symbols, symbol_size, 4, true);
+    test_band_decode<Field>(symbols, symbol_size, 4, false);
+    test_band_decode<Field>(symbols, symbol_size, 32, false);
+}
+
+TEST(TestRlncBandCodes, decode)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_band_decode<fifi::binary>(symbols, symbol_size);
+    test_band_decode<fifi::binary8>(symbols, symbol_size);
+    test_band_decode<fifi::binary16>(symbols, symbol_size);
+
+    test_band_decode<fifi::binary>(1, 16);
+    test_band_decode<fifi::binary8>(1, 16);
+}
+
+/// Large generations should decode without a cubic cost
+TEST(TestRlncBandCodes, large_generation)
+{
+    test_band_decode<fifi::binary>(4096, 16, 64, false);
+    test_band_decode<fifi::binary8>(4096, 16, 64, false);
+}
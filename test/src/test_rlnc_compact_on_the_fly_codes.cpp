@@ -0,0 +1,249 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_rlnc_compact_on_the_fly_codes.cpp Unit tests for the
+///       on-the-fly codes using the compact headers
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/varint.hpp>
+#include <kodo/rlnc/compact_on_the_fly_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+#include "helper_test_recoding_api.hpp"
+#include "helper_test_on_the_fly_api.hpp"
+#include "helper_test_basic_api.hpp"
+#include "helper_test_systematic_api.hpp"
+#include "helper_test_mix_uncoded_api.hpp"
+
+/// Checks the varint helpers at the boundaries of the encoded sizes
+TEST(TestCompactOnTheFlyCodes, varint)
+{
+    std::vector<uint32_t> values = {
+        0, 1, 127, 128, 16383, 16384, 2097151, 2097152,
+        268435455, 268435456, 0xffffffff };
+
+    std::vector<uint32_t> sizes = { 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5 };
+
+    for(uint32_t i = 0; i < values.size(); ++i)
+    {
+        uint8_t buffer[kodo::max_varint_size];
+
+        EXPECT_EQ(sizes[i], kodo::varint_size(values[i]));
+        EXPECT_EQ(sizes[i], kodo::write_varint(values[i], buffer));
+
+        uint32_t value = 0;
+        EXPECT_EQ(sizes[i], kodo::read_varint(buffer, &value));
+        EXPECT_EQ(values[i], value);
+    }
+}
+
+/// Checks that an overlong varint stops after max_varint_size bytes
+TEST(TestCompactOnTheFlyCodes, varint_overlong)
+{
+    std::vector<uint8_t> buffer(2 * kodo::max_varint_size, 0xff);
+
+    uint32_t value = 0;
+    EXPECT_EQ(kodo::max_varint_size,
+              kodo::read_varint(&buffer[0], &value));
+    EXPECT_EQ(0xffffffffU, value);
+
+    // The bits of the last byte beyond 32 bits are dropped
+    buffer[kodo::max_varint_size - 1] = 0x81;
+
+    EXPECT_EQ(kodo::max_varint_size,
+              kodo::read_varint(&buffer[0], &value));
+    EXPECT_EQ(0x1fffffffU, value);
+}
+
+/// Checks the sizes of the compact headers produced while the symbols
+/// are specified one at a time
+template<class Field>
+void test_compact_header_size(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::compact_on_the_fly_encoder<Field> encoder_type;
+    typedef kodo::compact_on_the_fly_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(encoder->payload_size(), decoder->payload_size());
+    EXPECT_TRUE(encoder->payload_size() <=
+                encoder_factory.max_payload_size());
+    EXPECT_TRUE(decoder->payload_size() <=
+                decoder_factory.max_payload_size());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        // The rank of the encoder is i + 1 once the symbol is set
+        uint32_t rank_size = kodo::varint_size(i + 1);
+
+        encoder->set_symbol(
+            i, sak::storage(&data_in[i * symbol_size], symbol_size));
+
+        // The systematic symbol only needs the rank and the index
+        uint32_t used = encoder->encode(&payload[0]);
+
+        EXPECT_EQ(symbol_size + rank_size + kodo::varint_size(i + 1),
+                  used);
+
+        decoder->decode(&payload[0]);
+
+        EXPECT_EQ(i + 1, decoder->rank());
+        EXPECT_EQ(i + 1, decoder->encoder_rank());
+
+        // A coded symbol only carries the coefficients of the symbols
+        // specified so far
+        kodo::set_systematic_off(encoder);
+        used = encoder->encode(&payload[0]);
+        kodo::set_systematic_on(encoder);
+
+        uint32_t coefficients_size =
+            fifi::elements_to_size<Field>(i + 1);
+
+        EXPECT_TRUE(used <= symbol_size + rank_size + 1 +
+                    kodo::varint_size(coefficients_size) +
+                    coefficients_size);
+
+        EXPECT_TRUE(used <= encoder->payload_size());
+
+        decoder->decode(&payload[0]);
+        EXPECT_EQ(i + 1, decoder->rank());
+    }
+
+    EXPECT_TRUE(decoder->is_complete());
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+
+    // The recoded symbols of a complete decoder still fit the payload
+    EXPECT_TRUE(decoder->recode(&payload[0]) <= decoder->payload_size());
+}
+
+TEST(TestCompactOnTheFlyCodes, header_size)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_compact_header_size<fifi::binary>(symbols, symbol_size);
+    test_compact_header_size<fifi::binary8>(symbols, symbol_size);
+    test_compact_header_size<fifi::binary16>(symbols, symbol_size);
+
+    test_compact_header_size<fifi::binary8>(200, 20);
+}
+
+/// Checks that packets with a corrupt systematic index or a corrupt
+/// number of kept coefficient bytes are dropped
+template<class Field>
+void test_compact_corrupt_header(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::compact_on_the_fly_encoder<Field> encoder_type;
+    typedef kodo::compact_on_the_fly_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Room for the corrupt varints, which may be longer than the ones
+    // they replace
+    std::vector<uint8_t> payload(
+        encoder->payload_size() + kodo::max_varint_size);
+
+    // The systematic index follows the rank and the symbol data
+    uint32_t header = kodo::varint_size(symbols) + symbol_size;
+
+    encoder->encode(&payload[0]);
+    kodo::write_varint(symbols + 1, &payload[header]);
+
+    decoder->decode(&payload[0]);
+    EXPECT_EQ(0U, decoder->rank());
+
+    // The number of kept bytes follows the systematic index of a coded
+    // symbol
+    uint32_t id_size = decoder->coefficients_size();
+
+    kodo::set_systematic_off(encoder);
+
+    encoder->encode(&payload[0]);
+    kodo::write_varint(id_size + 1, &payload[header + 1]);
+
+    decoder->decode(&payload[0]);
+    EXPECT_EQ(0U, decoder->rank());
+
+    // Intact packets still decode
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestCompactOnTheFlyCodes, corrupt_header)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_compact_corrupt_header<fifi::binary>(symbols, symbol_size);
+    test_compact_corrupt_header<fifi::binary8>(symbols, symbol_size);
+    test_compact_corrupt_header<fifi::binary16>(symbols, symbol_size);
+}
+
+TEST(TestCompactOnTheFlyCodes, test_basic_api)
+{
+    test_basic_api<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
+
+TEST(TestCompactOnTheFlyCodes, test_systematic_api)
+{
+    test_systematic<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
+
+TEST(TestCompactOnTheFlyCodes, mix_uncoded_api)
+{
+    test_mix_uncoded<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
+
+TEST(TestCompactOnTheFlyCodes, test_recoders_api)
+{
+    test_recoders<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
+
+TEST(TestCompactOnTheFlyCodes, test_on_the_fly_api)
+{
+    test_on_the_fly<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
+
+TEST(TestCompactOnTheFlyCodes, test_on_the_fly_systematic_api)
+{
+    test_on_the_fly_systematic<kodo::compact_on_the_fly_encoder,
+        kodo::compact_on_the_fly_decoder>();
+}
@@ -0,0 +1,194 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_rlnc_fulcrum_codes.cpp Unit tests for the fulcrum codes
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/fulcrum_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks that the outer code symbols computed by the encoder are
+/// combinations of the source symbols, by decoding the expanded block
+/// with the inner decoder.
+template<class OuterField, uint32_t Expansion>
+void test_fulcrum_inner(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::fulcrum_encoder<OuterField, Expansion> encoder_type;
+    typedef kodo::fulcrum_inner_decoder<Expansion> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    EXPECT_EQ(symbols + Expansion, encoder_factory.max_symbols());
+    EXPECT_EQ(symbols, encoder_factory.max_source_symbols());
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(symbols + Expansion, encoder->symbols());
+    EXPECT_EQ(symbols, encoder->source_symbols());
+    EXPECT_EQ(symbols, decoder->source_symbols());
+    EXPECT_EQ(encoder->payload_size(), decoder->payload_size());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in =
+        random_vector(encoder->source_block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        // Drop some symbols to mix coded and uncoded symbols
+        if(rand() % 2)
+            continue;
+
+        decoder->decode(&payload[0]);
+    }
+
+    // The first symbols of the expanded block are the source symbols
+    std::vector<uint8_t> data_out(decoder->source_block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+
+    // The outer symbols must match those of the encoder
+    for(uint32_t i = symbols; i < symbols + Expansion; ++i)
+    {
+        EXPECT_TRUE(std::equal(encoder->symbol(i),
+                               encoder->symbol(i) + symbol_size,
+                               decoder->symbol(i)));
+    }
+}
+
+/// Decodes the source symbols directly with the outer decoder
+template<class OuterField, uint32_t Expansion>
+void test_fulcrum_outer(uint32_t symbols, uint32_t symbol_size,
+                        bool systematic)
+{
+    typedef kodo::fulcrum_encoder<OuterField, Expansion> encoder_type;
+    typedef kodo::fulcrum_outer_decoder<OuterField, Expansion> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    EXPECT_EQ(encoder_factory.max_payload_size(),
+              decoder_factory.max_payload_size());
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(symbols, decoder->symbols());
+    EXPECT_EQ(encoder->payload_size(), decoder->payload_size());
+
+    if(!systematic)
+        encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in =
+        random_vector(encoder->source_block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Bound the number of symbols such that a broken mapping to the
+    // outer code fails instead of looping
+    uint32_t max_symbols = 10 * (symbols + Expansion) + 100;
+    uint32_t sent = 0;
+
+    while(!decoder->is_complete() && sent < max_symbols)
+    {
+        encoder->encode(&payload[0]);
+        ++sent;
+
+        // Drop some of the source symbols such that the outer code
+        // symbols are needed
+        if(rand() % 3 == 0)
+            continue;
+
+        decoder->decode(&payload[0]);
+    }
+
+    ASSERT_TRUE(decoder->is_complete());
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+template<class OuterField>
+void test_fulcrum(uint32_t symbols, uint32_t symbol_size)
+{
+    test_fulcrum_inner<OuterField, 1>(symbols, symbol_size);
+    test_fulcrum_inner<OuterField, 4>(symbols, symbol_size);
+    test_fulcrum_inner<OuterField, 10>(symbols, symbol_size);
+
+    test_fulcrum_outer<OuterField, 1>(symbols, symbol_size, true);
+    test_fulcrum_outer<OuterField, 4>(symbols, symbol_size, true);
+    test_fulcrum_outer<OuterField, 4>(symbols, symbol_size, false);
+    test_fulcrum_outer<OuterField, 10>(symbols, symbol_size, false);
+}
+
+TEST(TestRlncFulcrumCodes, decode)
+{
+    test_fulcrum<fifi::binary8>(1, 16);
+    test_fulcrum<fifi::binary8>(32, 1600);
+
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_fulcrum<fifi::binary8>(symbols, symbol_size);
+    test_fulcrum<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Checks that the factories can be reused with a different number of
+/// source symbols
+TEST(TestRlncFulcrumCodes, set_symbols)
+{
+    typedef kodo::fulcrum_encoder<fifi::binary8> encoder_type;
+    typedef kodo::fulcrum_outer_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 20;
+    uint32_t symbol_size = 100;
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    for(uint32_t i = 1; i <= symbols; i += 6)
+    {
+        encoder_factory.set_symbols(i);
+        decoder_factory.set_symbols(i);
+
+        auto encoder = encoder_factory.build();
+        auto decoder = decoder_factory.build();
+
+        EXPECT_EQ(i, encoder->source_symbols());
+        EXPECT_EQ(i, decoder->symbols());
+
+        std::vector<uint8_t> payload(encoder->payload_size());
+        std::vector<uint8_t> data_in =
+            random_vector(encoder->source_block_size());
+
+        encoder->set_symbols(sak::storage(data_in));
+        encoder->set_systematic_off();
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&payload[0]);
+            decoder->decode(&payload[0]);
+        }
+
+        std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+        decoder->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(data_in == data_out);
+    }
+}
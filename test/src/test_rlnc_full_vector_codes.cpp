@@ -146,6 +146,9 @@ TEST(TestRlncFullVectorCodes, test_basic_api)
 
     // The delayed decoders
     test_basic_api<kodo::full_rlnc_encoder, kodo::full_rlnc_decoder_delayed>();
+
+    // Decoding into the application buffer
+    test_basic_api<kodo::full_rlnc_encoder, kodo::shallow_full_rlnc_decoder>();
 }
 
 
@@ -192,6 +195,9 @@ TEST(TestRlncFullVectorCodes, test_recoders_api)
     test_recoders<kodo::full_rlnc_encoder,
         kodo::full_rlnc_decoder_delayed_shallow>();
 
+    test_recoders<kodo::full_rlnc_encoder,
+        kodo::shallow_full_rlnc_decoder>();
+
 }
 
 /// Tests the basic API functionality this mean basic encoding
@@ -230,5 +236,111 @@ TEST(TestRlncFullVectorCodes, test_reuse_incomplete_api)
         kodo::full_rlnc_decoder_delayed>();
 }
 
+/// Receives uncoded symbols directly into the application buffer of a
+/// shallow decoder, such that they are decoded in place
+template<class Field>
+void test_decode_in_place(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::shallow_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+
+    encoder->set_symbols(sak::storage(data_in));
+    decoder->set_symbols(sak::storage(data_out));
+
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        if(rand() % 2)
+        {
+            encoder->encode(&payload[0]);
+            decoder->decode(&payload[0]);
+            continue;
+        }
+
+        uint32_t index = rand() % symbols;
+
+        if(decoder->symbol_pivot(index))
+            continue;
+
+        // Receive the symbol directly into its target buffer
+        uint8_t *target = &data_out[index * decoder->symbol_size()];
+        EXPECT_EQ(target, decoder->symbol(index));
+
+        encoder->copy_symbol(
+            index, sak::storage(target, decoder->symbol_size()));
+
+        decoder->decode_symbol(target, index);
+    }
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, decode_in_place)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_decode_in_place<fifi::binary>(symbols, symbol_size);
+    test_decode_in_place<fifi::binary8>(symbols, symbol_size);
+    test_decode_in_place<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Decodes with the delayed decoder using symbols split into several
+/// tiles by the final backward substitution
+template<class Field>
+void test_delayed_tiles(uint32_t symbols, uint32_t symbol_size,
+                        uint32_t threads)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::full_rlnc_decoder_delayed<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    decoder_factory.set_substitute_threads(threads);
+    EXPECT_EQ(threads, decoder_factory.substitute_threads());
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
 
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
 
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        if(rand() % 2)
+            decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, delayed_tiles)
+{
+    test_delayed_tiles<fifi::binary>(64, 20000, 1);
+    test_delayed_tiles<fifi::binary8>(64, 20000, 1);
+    test_delayed_tiles<fifi::binary16>(64, 20002, 1);
+
+    test_delayed_tiles<fifi::binary>(64, 20000, 4);
+    test_delayed_tiles<fifi::binary8>(64, 20000, 4);
+    test_delayed_tiles<fifi::binary16>(32, 4002, 3);
+}
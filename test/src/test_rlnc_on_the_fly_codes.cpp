@@ -32,6 +32,10 @@
 TEST(TestOnTheFlyCodes, test_basic_api)
 {
     test_basic_api<kodo::on_the_fly_encoder,kodo::on_the_fly_decoder>();
+
+    // Decoding into the application buffer
+    test_basic_api<kodo::on_the_fly_encoder,
+                   kodo::shallow_on_the_fly_decoder>();
 }
 
 /// Test that the encoders and decoders initialize() function can be used
@@ -60,6 +64,8 @@ TEST(TestOnTheFlyCodes, mix_uncoded_api)
 TEST(TestOnTheFlyCodes, test_recoders_api)
 {
     test_recoders<kodo::on_the_fly_encoder, kodo::on_the_fly_decoder>();
+    test_recoders<kodo::on_the_fly_encoder,
+                  kodo::shallow_on_the_fly_decoder>();
 }
 
 /// Tests that we can progressively set on symbol at-a-time on
@@ -24,6 +24,10 @@
 TEST(TestSeedCodes, test_basic_api)
 {
     test_basic_api<kodo::seed_rlnc_encoder,kodo::seed_rlnc_decoder>();
+
+    // Decoding into the application buffer
+    test_basic_api<kodo::seed_rlnc_encoder,
+                   kodo::shallow_seed_rlnc_decoder>();
 }
 
 /// Test that the encoders and decoders initialize() function can be used
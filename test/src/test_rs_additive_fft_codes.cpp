@@ -0,0 +1,225 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_rs_additive_fft_codes.cpp Unit tests for the Reed-Solomon
+///       codes based on the additive FFT
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rs/additive_fft_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks that the inverse transform undoes the forward transform and
+/// that the transform of a constant polynomial is constant
+template<class Field>
+void test_additive_fft_transform(uint32_t levels, uint32_t offset)
+{
+    typedef kodo::fft_rs_encoder<Field> encoder_type;
+    typedef typename Field::value_type value_type;
+
+    uint32_t size = 1U << levels;
+    uint32_t symbol_size = 16;
+
+    typename encoder_type::factory encoder_factory(1, symbol_size);
+    auto encoder = encoder_factory.build();
+
+    std::vector<uint8_t> data = random_vector(size * symbol_size);
+    std::vector<uint8_t> copy = data;
+
+    std::vector<value_type*> symbols(size);
+    for(uint32_t i = 0; i < size; ++i)
+    {
+        symbols[i] = reinterpret_cast<value_type*>(&data[i * symbol_size]);
+    }
+
+    encoder->fft(&symbols[0], levels, offset);
+    encoder->ifft(&symbols[0], levels, offset);
+
+    EXPECT_TRUE(data == copy);
+
+    // X_0 = 1 so only the first coefficient is set
+    std::fill(data.begin() + symbol_size, data.end(), 0);
+    encoder->fft(&symbols[0], levels, offset);
+
+    for(uint32_t i = 1; i < size; ++i)
+    {
+        EXPECT_TRUE(std::equal(data.begin(), data.begin() + symbol_size,
+                               data.begin() + i * symbol_size));
+    }
+}
+
+TEST(TestAdditiveFftCodes, transform)
+{
+    test_additive_fft_transform<fifi::binary8>(0, 0);
+    test_additive_fft_transform<fifi::binary8>(3, 0);
+    test_additive_fft_transform<fifi::binary8>(5, 64);
+    test_additive_fft_transform<fifi::binary8>(8, 0);
+
+    test_additive_fft_transform<fifi::binary16>(4, 0);
+    test_additive_fft_transform<fifi::binary16>(6, 1024);
+}
+
+/// Decodes a block where the given fraction of the symbols is lost
+template<class Field>
+void test_additive_fft_codes(uint32_t symbols, uint32_t symbol_size,
+                             uint32_t loss_percent)
+{
+    typedef kodo::fft_rs_encoder<Field> encoder_type;
+    typedef kodo::fft_rs_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(encoder->payload_size(), decoder->payload_size());
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    uint32_t encoded = 0;
+    uint32_t received = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        ++encoded;
+
+        if((uint32_t) (rand() % 100) < loss_percent)
+            continue;
+
+        decoder->decode(&payload[0]);
+        ++received;
+    }
+
+    // The code is MDS, so any k distinct symbols suffice. Once the
+    // repair symbols repeat the decoder may receive duplicates.
+    if(encoded <= symbols + encoder->repair_symbols())
+    {
+        EXPECT_EQ(symbols, received);
+    }
+
+    EXPECT_EQ(symbols, decoder->rank());
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+template<class Field>
+void test_additive_fft_codes(uint32_t symbols, uint32_t symbol_size)
+{
+    test_additive_fft_codes<Field>(symbols, symbol_size, 0);
+    test_additive_fft_codes<Field>(symbols, symbol_size, 30);
+    test_additive_fft_codes<Field>(symbols, symbol_size, 75);
+}
+
+TEST(TestAdditiveFftCodes, encode_decode)
+{
+    uint32_t symbols = rand_symbols(128);
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_additive_fft_codes<fifi::binary8>(symbols, symbol_size);
+    test_additive_fft_codes<fifi::binary16>(symbols, symbol_size);
+
+    test_additive_fft_codes<fifi::binary8>(1, 16);
+    test_additive_fft_codes<fifi::binary8>(128, 16);
+    test_additive_fft_codes<fifi::binary16>(3, 16);
+}
+
+/// Repair symbols only, with the systematic phase turned off
+TEST(TestAdditiveFftCodes, non_systematic)
+{
+    typedef kodo::fft_rs_encoder<fifi::binary16> encoder_type;
+    typedef kodo::fft_rs_decoder<fifi::binary16> decoder_type;
+
+    uint32_t symbols = 1000;
+    uint32_t symbol_size = 32;
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Skip the first repair blocks so the decoder works on a larger
+    // transform than the encoder
+    for(uint32_t i = 0; i < 3000; ++i)
+    {
+        encoder->encode(&payload[0]);
+    }
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+/// Sets new symbols on an encoder which already produced repair symbols
+/// and checks that the following repair symbols decode to the new data
+TEST(TestAdditiveFftCodes, reset_symbols)
+{
+    typedef kodo::fft_rs_encoder<fifi::binary8> encoder_type;
+    typedef kodo::fft_rs_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 20;
+    uint32_t symbol_size = 32;
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+
+    encoder->set_systematic_off();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    // Compute the first two repair blocks from the old data
+    for(uint32_t i = 0; i < 64; ++i)
+    {
+        encoder->encode(&payload[0]);
+    }
+
+    // Replace all symbols
+    data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    auto decoder = decoder_factory.build();
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
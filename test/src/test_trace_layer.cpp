@@ -0,0 +1,431 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_trace_layer.cpp Unit tests for the trace_layer and the
+///       trace buffers
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/trace_layer.hpp>
+#include <kodo/trace_export.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+    /// A full_rlnc_decoder recording its progress
+    template<class Field>
+    class traced_full_rlnc_decoder
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 trace_layer<
+                 aligned_coefficients_decoder<
+                 batch_linear_block_decoder<
+                 forward_linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 traced_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+}
+
+namespace
+{
+    /// @param coder The id of the coder
+    /// @return The events of the coder recorded by the calling thread
+    std::vector<kodo::trace_event> coder_events(uint16_t coder)
+    {
+        std::vector<kodo::trace_event> events;
+
+        for(const auto &event :
+                kodo::trace_registry::instance().local().snapshot())
+        {
+            if(event.m_coder == coder)
+                events.push_back(event);
+        }
+
+        return events;
+    }
+
+    /// @return The number of events of the given type
+    uint32_t count(const std::vector<kodo::trace_event> &events,
+                   kodo::trace_event_type type)
+    {
+        uint32_t result = 0;
+
+        for(const auto &event : events)
+        {
+            if(event.m_type == (uint8_t) type)
+                ++result;
+        }
+
+        return result;
+    }
+}
+
+/// Checks the overwriting of the oldest events. The oldest slot of a
+/// full buffer is the one written next, so it is left out of snapshots.
+TEST(TestTraceLayer, ring_buffer)
+{
+    kodo::trace_buffer buffer(0, 8);
+
+    for(uint32_t i = 0; i < 20; ++i)
+    {
+        buffer.record(kodo::trace_event_type::received_coded, 1, i);
+    }
+
+    auto events = buffer.snapshot();
+
+    EXPECT_EQ(20U, buffer.recorded());
+    ASSERT_EQ(7U, events.size());
+    EXPECT_EQ(13U, events.front().m_value);
+    EXPECT_EQ(19U, events.back().m_value);
+
+    for(uint32_t i = 1; i < events.size(); ++i)
+    {
+        EXPECT_LE(events[i - 1].m_timestamp, events[i].m_timestamp);
+    }
+}
+
+/// Takes snapshots while another thread records and checks that every
+/// snapshot holds consecutive, untorn events
+TEST(TestTraceLayer, concurrent_snapshot)
+{
+    kodo::trace_buffer buffer(0, 64);
+
+    const uint32_t events = 200000;
+
+    std::thread writer([&buffer, events]()
+    {
+        for(uint32_t i = 0; i < events; ++i)
+        {
+            buffer.record(kodo::trace_event_type::received_coded,
+                          (uint16_t) i, i);
+        }
+    });
+
+    while(buffer.recorded() < events)
+    {
+        auto snapshot = buffer.snapshot();
+
+        for(uint32_t i = 0; i < snapshot.size(); ++i)
+        {
+            EXPECT_EQ((uint16_t) snapshot[i].m_value, snapshot[i].m_coder);
+
+            if(i > 0)
+            {
+                EXPECT_EQ(snapshot[i - 1].m_value + 1, snapshot[i].m_value);
+            }
+        }
+    }
+
+    writer.join();
+}
+
+/// Decodes coded and systematic symbols and checks the recorded events
+template<class Field>
+void test_trace_layer(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::traced_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    // A coded symbol followed by the uncoded symbol at its pivot swaps
+    // the two
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    auto events = coder_events(decoder->trace_id());
+    ASSERT_EQ(2U, events.size());
+    EXPECT_EQ((uint8_t) kodo::trace_event_type::received_coded,
+              events[0].m_type);
+
+    if(events[1].m_type == (uint8_t) kodo::trace_event_type::pivot_found)
+    {
+        uint32_t pivot = events[1].m_value;
+
+        std::vector<uint8_t> symbol(
+            data_in.begin() + pivot * symbol_size,
+            data_in.begin() + (pivot + 1) * symbol_size);
+
+        decoder->decode_symbol(&symbol[0], pivot);
+
+        events = coder_events(decoder->trace_id());
+        EXPECT_EQ(1U, count(events, kodo::trace_event_type::swap_decode));
+    }
+
+    uint32_t received = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+        ++received;
+    }
+
+    // A symbol received after completion is not innovative
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    events = coder_events(decoder->trace_id());
+
+    EXPECT_EQ(received + 2,
+              count(events, kodo::trace_event_type::received_coded));
+    EXPECT_EQ(symbols, count(events, kodo::trace_event_type::pivot_found));
+    EXPECT_EQ(1U, count(events, kodo::trace_event_type::complete));
+    EXPECT_GE(count(events, kodo::trace_event_type::non_innovative), 1U);
+    EXPECT_EQ((uint8_t) kodo::trace_event_type::non_innovative,
+              events.back().m_type);
+
+    // The decoded data is unaffected by the tracing
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(std::equal(data_out.begin(), data_out.end(),
+                           data_in.begin()));
+
+    // Every pivot is reported once
+    std::vector<bool> pivots(symbols, false);
+
+    for(const auto &event : events)
+    {
+        if(event.m_type != (uint8_t) kodo::trace_event_type::pivot_found)
+            continue;
+
+        ASSERT_LT(event.m_value, symbols);
+        EXPECT_FALSE(pivots[event.m_value]);
+        pivots[event.m_value] = true;
+    }
+}
+
+TEST(TestTraceLayer, decode)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_trace_layer<fifi::binary>(symbols, symbol_size);
+    test_trace_layer<fifi::binary8>(symbols, symbol_size);
+    test_trace_layer<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Decodes batches of coded symbols with decode(uint8_t**,uint32_t)
+/// and checks that their outcome is recorded when the batch is decoded
+template<class Field>
+void test_trace_layer_batch(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_type;
+    typedef kodo::traced_full_rlnc_decoder<Field> decoder_type;
+
+    typename encoder_type::factory encoder_factory(symbols, symbol_size);
+    typename decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    kodo::set_systematic_off(encoder);
+
+    const uint32_t batch = 4;
+
+    std::vector<std::vector<uint8_t>> buffers(
+        batch, std::vector<uint8_t>(encoder->payload_size()));
+
+    std::vector<uint8_t*> payloads;
+
+    for(auto &buffer : buffers)
+    {
+        payloads.push_back(&buffer[0]);
+    }
+
+    uint32_t received = 0;
+
+    while(!decoder->is_complete())
+    {
+        for(auto &buffer : buffers)
+        {
+            encoder->encode(&buffer[0]);
+        }
+
+        decoder->decode(&payloads[0], batch);
+        received += batch;
+    }
+
+    // The last batch may hold symbols received after completion, and a
+    // duplicate of a decoded symbol is not innovative
+    decoder->decode(&payloads[0], batch);
+    received += batch;
+
+    auto events = coder_events(decoder->trace_id());
+
+    EXPECT_EQ(received,
+              count(events, kodo::trace_event_type::received_coded));
+    EXPECT_EQ(symbols, count(events, kodo::trace_event_type::pivot_found));
+    EXPECT_EQ(received - symbols,
+              count(events, kodo::trace_event_type::non_innovative));
+    EXPECT_EQ(1U, count(events, kodo::trace_event_type::complete));
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(std::equal(data_out.begin(), data_out.end(),
+                           data_in.begin()));
+
+    // Every pivot is reported once
+    std::vector<bool> pivots(symbols, false);
+
+    for(const auto &event : events)
+    {
+        if(event.m_type != (uint8_t) kodo::trace_event_type::pivot_found)
+            continue;
+
+        ASSERT_LT(event.m_value, symbols);
+        EXPECT_FALSE(pivots[event.m_value]);
+        pivots[event.m_value] = true;
+    }
+}
+
+TEST(TestTraceLayer, decode_batch)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    test_trace_layer_batch<fifi::binary>(symbols, symbol_size);
+    test_trace_layer_batch<fifi::binary8>(symbols, symbol_size);
+    test_trace_layer_batch<fifi::binary16>(symbols, symbol_size);
+}
+
+/// Checks the systematic events and that tracing can be switched off
+TEST(TestTraceLayer, systematic)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_type;
+    typedef kodo::traced_full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    encoder_type::factory encoder_factory(symbols, symbol_size);
+    decoder_type::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    auto events = coder_events(decoder->trace_id());
+
+    ASSERT_EQ(2 * symbols + 1, events.size());
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_EQ((uint8_t) kodo::trace_event_type::received_uncoded,
+                  events[2 * i].m_type);
+        EXPECT_EQ((uint8_t) kodo::trace_event_type::pivot_found,
+                  events[2 * i + 1].m_type);
+        EXPECT_EQ(i, events[2 * i + 1].m_value);
+    }
+
+    EXPECT_EQ((uint8_t) kodo::trace_event_type::complete,
+              events.back().m_type);
+
+    decoder_factory.set_trace(false);
+    auto silent = decoder_factory.build();
+
+    EXPECT_FALSE(silent->trace_enabled());
+    EXPECT_NE(decoder->trace_id(), silent->trace_id());
+
+    encoder->encode(&payload[0]);
+    silent->decode(&payload[0]);
+
+    EXPECT_TRUE(coder_events(silent->trace_id()).empty());
+}
+
+/// Exports the events of several threads
+TEST(TestTraceLayer, chrome_trace)
+{
+    kodo::trace_buffer &local = kodo::trace_registry::instance().local();
+    local.record(kodo::trace_event_type::complete, 7, 42);
+
+    std::thread worker([]()
+        {
+            kodo::trace_registry::instance().local().record(
+                kodo::trace_event_type::pivot_found, 8, 3);
+        });
+
+    worker.join();
+
+    std::stringstream out;
+    kodo::write_chrome_trace(out);
+
+    std::string json = out.str();
+
+    EXPECT_EQ(0U, json.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"complete\""));
+    EXPECT_NE(std::string::npos, json.find("\"coder\":8,\"value\":3"));
+    EXPECT_NE(std::string::npos,
+              json.find("\"tid\":" +
+                        std::to_string(local.thread())));
+    EXPECT_GE(kodo::trace_registry::instance().buffers().size(), 2U);
+
+    // The time stamps are fixed point with nanosecond resolution
+    std::string::size_type ts = json.find("\"ts\":");
+    ASSERT_NE(std::string::npos, ts);
+
+    std::string::size_type end = json.find(',', ts);
+    std::string stamp = json.substr(ts + 5, end - ts - 5);
+
+    EXPECT_EQ(std::string::npos, stamp.find('e'));
+    ASSERT_NE(std::string::npos, stamp.find('.'));
+    EXPECT_EQ(3U, stamp.size() - stamp.find('.') - 1);
+
+    // The formatting of the stream is restored
+    EXPECT_TRUE((out.flags() & std::ios_base::fixed) == 0);
+    EXPECT_EQ(6, out.precision());
+}